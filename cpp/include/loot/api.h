@@ -34,7 +34,9 @@
 #include "loot/api_decorator.h"
 #include "loot/enum/game_type.h"
 #include "loot/enum/log_level.h"
+#include "loot/enum/progress_phase.h"
 #include "loot/exception/cyclic_interaction_error.h"
+#include "loot/exception/operation_cancelled_error.h"
 #include "loot/exception/plugin_not_loaded_error.h"
 #include "loot/exception/undefined_group_error.h"
 #include "loot/game_interface.h"
@@ -0,0 +1,73 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2026 Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+
+#ifndef LOOT_CANCELLATION_TOKEN
+#define LOOT_CANCELLATION_TOKEN
+
+#include <memory>
+
+#include "loot/api_decorator.h"
+
+namespace loot {
+struct CancellationTokenAccess;
+
+/**
+ * @brief A token that can be used to cancel a long-running operation.
+ * @details Copies of a token share the same state, so a token can be
+ *          cancelled from one thread while an operation that was given a copy
+ *          of it runs on another. Cancellation is cooperative: the operation
+ *          checks the token between units of work and throws an
+ *          OperationCancelledError if it has been cancelled.
+ */
+class CancellationToken {
+public:
+  /**
+   * @brief Construct a token that has not been cancelled.
+   */
+  LOOT_API CancellationToken();
+
+  /**
+   * @brief Request cancellation of any operations that have been given this
+   *        token or a copy of it.
+   * @details Cancellation cannot be undone.
+   */
+  LOOT_API void Cancel();
+
+  /**
+   * @brief Check if cancellation has been requested.
+   * @returns True if the token has been cancelled, false otherwise.
+   */
+  LOOT_API bool IsCancelled() const;
+
+private:
+  friend struct CancellationTokenAccess;
+
+  struct State;
+
+  std::shared_ptr<State> state_;
+};
+}
+
+#endif
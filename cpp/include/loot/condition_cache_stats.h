@@ -0,0 +1,55 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2026 Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+
+#ifndef LOOT_CONDITION_CACHE_STATS
+#define LOOT_CONDITION_CACHE_STATS
+
+#include <cstddef>
+
+namespace loot {
+/**
+ * @brief Counts of how a database's condition cache has been used.
+ */
+struct ConditionCacheStats {
+  /**
+   * @brief The number of condition evaluations that used a cached result.
+   */
+  size_t hits{0};
+
+  /**
+   * @brief The number of condition evaluations that had no cached result to
+   *        use.
+   */
+  size_t misses{0};
+
+  /**
+   * @brief The number of cached results that have been discarded because they
+   *        may no longer be correct.
+   */
+  size_t invalidations{0};
+};
+}
+
+#endif
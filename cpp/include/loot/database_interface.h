@@ -30,10 +30,12 @@
 #include <string_view>
 #include <vector>
 
+#include "loot/condition_cache_stats.h"
 #include "loot/exception/cyclic_interaction_error.h"
 #include "loot/metadata/group.h"
 #include "loot/metadata/message.h"
 #include "loot/metadata/plugin_metadata.h"
+#include "loot/metadata_changes.h"
 
 namespace loot {
 struct MetadataWriteOptionsImpl;
@@ -169,6 +171,15 @@ public:
    * @brief Loads the masterlist from the path specified.
    * @details Can be called multiple times, each time replacing the
    *          previously-loaded data.
+   *
+   *          After the masterlist is parsed, a compiled copy of its metadata
+   *          is written alongside it with `.bin` appended to its filename, and
+   *          later loads use the compiled copy while it's up to date with the
+   *          masterlist's content.
+   *
+   *          If another database object has already loaded the same
+   *          masterlist content from the same path, the two objects share one
+   *          copy of its metadata instead of each holding their own.
    * @param masterlistPath
    *        The relative or absolute path to the masterlist file that should be
    *        loaded.
@@ -191,6 +202,41 @@ public:
       const std::filesystem::path& masterlistPath,
       const std::filesystem::path& masterlistPreludePath) = 0;
 
+  /**
+   * @brief Loads the masterlist from the path specified to replace the
+   *        currently-loaded masterlist, and gets the differences between them.
+   * @details Unlike LoadMasterlist(), metadata that is unchanged from the
+   *          currently-loaded masterlist is kept, along with any work that has
+   *          already been done to decode it, parse its conditions or compile
+   *          its regexes. The returned changes can be used to decide which
+   *          plugins' derived data needs to be updated.
+   * @param masterlistPath
+   *        The relative or absolute path to the masterlist file that should be
+   *        loaded.
+   * @returns The differences between the reloaded masterlist and the masterlist
+   *          that it replaced.
+   */
+  virtual MetadataChanges ReloadMasterlist(
+      const std::filesystem::path& masterlistPath) = 0;
+
+  /**
+   * @brief Loads the masterlist and masterlist prelude from the paths
+   *        specified to replace the currently-loaded masterlist, and gets the
+   *        differences between them.
+   * @details See ReloadMasterlist() for details.
+   * @param masterlistPath
+   *        The relative or absolute path to the masterlist file that should be
+   *        loaded.
+   * @param masterlistPreludePath
+   *        The relative or absolute path to the masterlist prelude file that
+   *        should be loaded.
+   * @returns The differences between the reloaded masterlist and the masterlist
+   *          that it replaced.
+   */
+  virtual MetadataChanges ReloadMasterlistWithPrelude(
+      const std::filesystem::path& masterlistPath,
+      const std::filesystem::path& masterlistPreludePath) = 0;
+
   /**
    * @brief Loads the userlist from the path specified.
    * @details Can be called multiple times, each time replacing the
@@ -211,6 +257,26 @@ public:
   virtual void WriteUserMetadata(const std::filesystem::path& outputFile,
                                  const MetadataWriteOptions& options) const = 0;
 
+  /**
+   * @brief Writes the changes made to the loaded user metadata since the
+   *        userlist was loaded or its changes were last written.
+   * @details The changes are appended to a journal alongside the userlist,
+   *          which is applied when the userlist is next loaded, so the time
+   *          taken depends on the size of the changes rather than the size of
+   *          the userlist. Once the journal is as large as the userlist, all
+   *          the user metadata is written to the userlist (overwriting it) and
+   *          the journal is removed. If the userlist's content is changed
+   *          some other way before it's next loaded, the journal is ignored
+   *          and removed when it is loaded.
+   * @param userlistPath
+   *        The path to the userlist that the changes should be written for.
+   * @param options
+   *        The configuration options to use when writing the userlist.
+   */
+  virtual void WriteUserMetadataChanges(
+      const std::filesystem::path& userlistPath,
+      const MetadataWriteOptions& options) = 0;
+
   /**
    * @brief Writes a minimal metadata file that only contains plugins with
    *        Bash Tag suggestions and/or dirty info, plus the suggestions and
@@ -229,6 +295,19 @@ public:
    */
   virtual bool Evaluate(const std::string& condition) const = 0;
 
+  /**
+   * @brief Evaluate each of the given condition strings.
+   * @details This gives the same results as calling Evaluate() for each
+   *          condition, but the conditions are parsed and evaluated in
+   *          parallel, sharing the condition cache.
+   * @param conditions The condition strings to evaluate.
+   * @returns The result of each condition, in the same order as the given
+   *          conditions. If any condition is invalid, an exception is thrown
+   *          instead.
+   */
+  virtual std::vector<bool> EvaluateMany(
+      const std::vector<std::string>& conditions) const = 0;
+
   /**
    * @brief Clears the cache of metadata condition evaluation results.
    * @details As many conditions involve reading files and/or directories,
@@ -241,6 +320,15 @@ public:
    */
   virtual void ClearConditionCache() = 0;
 
+  /**
+   * @brief Get counts of how the condition cache has been used since the
+   *        database was created.
+   * @details Cached results are invalidated when the cache is cleared, and
+   *          when the state of a plugin that they may depend on changes.
+   * @returns The condition cache's usage counts.
+   */
+  virtual ConditionCacheStats GetConditionCacheStats() const = 0;
+
   /**
    * @}
    * @name Non-plugin Data Access
@@ -293,6 +381,34 @@ public:
       bool includeUserMetadata = true,
       bool evaluateConditions = false) const = 0;
 
+  /**
+   * @brief Get all general messages listed in the loaded metadata lists, with
+   *        each message's content reduced to the content for the given
+   *        language.
+   * @details This gives the same messages as GetGeneralMessages(), except
+   *          that each message with content in more than one language only
+   *          keeps the content that SelectMessageContent() would choose for
+   *          the given language, so that translations that would be discarded
+   *          aren't copied.
+   * @param language
+   *        The language code to select content for, e.g. "en" or "pt_BR".
+   * @param includeUserMetadata
+   *        If true, any general messages present in the userlist are included
+   *        in the returned metadata, otherwise the metadata returned only
+   *        includes metadata from the masterlist.
+   * @param evaluateConditions
+   *        If true, any metadata conditions are evaluated before the metadata
+   *        is returned, otherwise unevaluated metadata is returned. Evaluating
+   *        general message conditions also clears the condition cache before
+   *        evaluating conditions.
+   * @returns The messages supplied in the metadata lists that are not attached
+   *          to any particular plugin.
+   */
+  virtual std::vector<Message> GetLocalisedGeneralMessages(
+      std::string_view language,
+      bool includeUserMetadata = true,
+      bool evaluateConditions = false) const = 0;
+
   /**
    * @brief Get all general messages listed in the loaded userlist.
    * @param evaluateConditions
@@ -386,6 +502,98 @@ public:
       bool includeUserMetadata = true,
       bool evaluateConditions = false) const = 0;
 
+  /**
+   * @brief Get all a plugin's loaded metadata, with its message content and
+   *        its files' and cleaning data's detail reduced to the content for
+   *        the given language.
+   * @details Like GetLocalisedGeneralMessages(), this gives the same metadata
+   *          as GetPluginMetadata() without the content in other languages.
+   * @param plugin
+   *        The filename of the plugin to look up metadata for.
+   * @param language
+   *        The language code to select content for, e.g. "en" or "pt_BR".
+   * @param includeUserMetadata
+   *        If true, any user metadata the plugin has is included in the
+   *        returned metadata, otherwise the metadata returned only includes
+   *        metadata from the masterlist.
+   * @param evaluateConditions
+   *        If true, any metadata conditions are evaluated before the metadata
+   *        is returned, otherwise unevaluated metadata is returned. Evaluating
+   *        plugin metadata conditions does not clear the condition cache.
+   * @returns If the plugin has metadata, an optional containing that metadata,
+   *          otherwise an optional containing no value.
+   */
+  virtual std::optional<PluginMetadata> GetLocalisedPluginMetadata(
+      std::string_view plugin,
+      std::string_view language,
+      bool includeUserMetadata = true,
+      bool evaluateConditions = false) const = 0;
+
+  /**
+   * @brief Get all the loaded metadata for each of the given plugins.
+   * @details This gives the same results as calling GetPluginMetadata() for
+   *          each plugin, but the plugins' metadata is retrieved and evaluated
+   *          in parallel, and each distinct condition is only evaluated once.
+   * @param plugins
+   *        The filenames of the plugins to look up metadata for.
+   * @param includeUserMetadata
+   *        If true, any user metadata the plugins have is included in the
+   *        returned metadata, otherwise the metadata returned only includes
+   *        metadata from the masterlist.
+   * @param evaluateConditions
+   *        If true, any metadata conditions are evaluated before the metadata
+   *        is returned, otherwise unevaluated metadata is returned. Evaluating
+   *        plugin metadata conditions does not clear the condition cache.
+   * @returns A vector containing an optional for each of the given plugins,
+   *          in the same order. Each optional contains the plugin's metadata
+   *          if it has any, and no value otherwise.
+   */
+  virtual std::vector<std::optional<PluginMetadata>> GetPluginsMetadata(
+      const std::vector<std::string>& plugins,
+      bool includeUserMetadata = true,
+      bool evaluateConditions = false) const = 0;
+
+  /**
+   * @brief Get the names of the plugin metadata entries that reference the
+   *        given file in their load after, requirement or incompatibility
+   *        metadata.
+   * @details Conditions are not evaluated, and entries with regex names are
+   *          listed by their regex. The loaded metadata is indexed by the
+   *          files that it references, so this doesn't need to look at every
+   *          plugin's metadata.
+   * @param filename
+   *        The filename to look up references to.
+   * @param includeUserMetadata
+   *        If true, entries in the userlist are included, otherwise only
+   *        entries in the masterlist are included.
+   * @returns The names of the referencing entries, with masterlist entries
+   *          listed before userlist entries.
+   */
+  virtual std::vector<std::string> GetPluginsReferencing(
+      std::string_view filename,
+      bool includeUserMetadata = true) const = 0;
+
+  /**
+   * @brief Get the names of the plugin metadata entries that are in the given
+   *        group.
+   * @details Entries with regex names are listed by their regex. Entries
+   *          that don't have a group are in the default group, but plugins
+   *          that have no metadata entries aren't listed. When user metadata
+   *          is included, an entry is not listed if merging it with the entry
+   *          with the same name in the other metadata list puts the plugin in
+   *          a different group.
+   * @param groupName
+   *        The name of the group to get the entries in.
+   * @param includeUserMetadata
+   *        If true, entries in the userlist are included, otherwise only
+   *        entries in the masterlist are included.
+   * @returns The names of the entries in the group, with masterlist entries
+   *          listed before userlist entries.
+   */
+  virtual std::vector<std::string> GetPluginsInGroup(
+      std::string_view groupName,
+      bool includeUserMetadata = true) const = 0;
+
   /**
    * @brief Get a plugin's metadata loaded from the given userlist.
    * @param plugin
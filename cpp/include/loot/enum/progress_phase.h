@@ -0,0 +1,66 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2012-2026 Oliver Hamlet
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_PROGRESS_PHASE
+#define LOOT_PROGRESS_PHASE
+
+#include <cstdint>
+
+/**
+ * The namespace used by libloot.
+ */
+namespace loot {
+/**
+ * @brief The phases of loading and sorting plugins that progress is reported
+ *        for.
+ */
+enum struct ProgressPhase : uint8_t {
+  /** Checking that the plugin paths given to load are valid. Progress is
+      counted in plugins. */
+  validatingPaths,
+  /** Scanning the game's data paths for archive files. Progress is counted in
+      data paths. */
+  readingArchives,
+  /** Parsing plugins and any archives they load. Progress is counted in
+      plugins. */
+  parsingPlugins,
+  /** Gathering the plugin data and metadata needed to sort. Progress is
+      counted in plugins. */
+  preparingSortingData,
+  /** Adding edges from masters, requirements and load after metadata.
+      Progress is counted in plugins. */
+  addingSpecificEdges,
+  /** Adding edges from group metadata. Progress is counted in groups. */
+  addingGroupEdges,
+  /** Adding edges between plugins that override the same records or load the
+      same assets. Progress is counted in plugins. */
+  addingOverlapEdges,
+  /** Adding edges between plugins that are otherwise unordered. Progress is
+      counted in pairs of plugins that are adjacent in the current load order.
+   */
+  addingTieBreakEdges,
+};
+}
+
+#endif
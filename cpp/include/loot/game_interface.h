@@ -24,8 +24,19 @@
 #ifndef LOOT_GAME_INTERFACE
 #define LOOT_GAME_INTERFACE
 
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "loot/cancellation_token.h"
 #include "loot/database_interface.h"
 #include "loot/enum/game_type.h"
+#include "loot/enum/progress_phase.h"
+#include "loot/game_snapshot_interface.h"
 #include "loot/plugin_interface.h"
 
 namespace loot {
@@ -69,6 +80,17 @@ public:
   virtual void SetAdditionalDataPaths(
       const std::vector<std::filesystem::path>& additionalDataPaths) = 0;
 
+  /**
+   * @brief   Set additional data paths, given as UTF-8 strings.
+   * @details This behaves the same as the overload that takes
+   *          `std::filesystem::path` values, but the given strings are passed
+   *          to libloot without first being copied into owned path strings.
+   * @param additionalDataPaths
+   *        The UTF-8 encoded additional data paths to set.
+   */
+  virtual void SetAdditionalDataPathsUtf8(
+      const std::vector<std::string_view>& additionalDataPaths) = 0;
+
   /**
    *  @name Metadata Access
    *  @{
@@ -90,6 +112,16 @@ public:
    */
   virtual const DatabaseInterface& GetDatabase() const = 0;
 
+  /**
+   * @brief Take an immutable snapshot of the game's loaded plugins, load order
+   *        and metadata.
+   * @details The snapshot can be shared between and read from any number of
+   *          threads while this object continues to be used and modified, and
+   *          it remains valid after this object is destroyed.
+   * @returns A pointer to a const GameSnapshotInterface implementation.
+   */
+  virtual std::shared_ptr<const GameSnapshotInterface> Snapshot() const = 0;
+
   /**
    * @}
    * @name Plugin Data Access
@@ -131,6 +163,53 @@ public:
       const std::vector<std::filesystem::path>& pluginPaths,
       bool loadHeadersOnly) = 0;
 
+  /**
+   * @brief Parses plugins and loads their data, given their paths as UTF-8
+   *        strings.
+   * @details This behaves the same as `LoadPlugins()`, but the given strings
+   *          are passed to libloot without first being copied into owned path
+   *          strings.
+   * @param pluginPaths
+   *        The UTF-8 encoded plugin paths to load. Relative paths are resolved
+   *        relative to the game's plugins directory, while absolute paths are
+   *        used as given. Each plugin filename must be unique within the
+   *        vector.
+   * @param loadHeadersOnly
+   *        If true, only the plugins' headers are loaded. If false, all records
+   *        in the plugins are parsed.
+   */
+  virtual void LoadPluginsUtf8(const std::vector<std::string_view>& pluginPaths,
+                               bool loadHeadersOnly) = 0;
+
+  /**
+   * @brief Asynchronously parses plugins and loads their data.
+   * @details This behaves the same as `LoadPlugins()`, but runs on a background
+   *          thread and returns immediately. The cancellation token is checked
+   *          before each plugin is loaded, and if it has been cancelled then
+   *          loading stops and the previously-loaded plugin data is left
+   *          unchanged.
+   *
+   *          This object must outlive the returned future, and its other member
+   *          functions (aside from `GetDatabase()`) must not be called until
+   *          the future is ready.
+   * @param pluginPaths
+   *        The plugin paths to load. Relative paths are resolved relative to
+   *        the game's plugins directory, while absolute paths are used as
+   *        given. Each plugin filename must be unique within the vector.
+   * @param loadHeadersOnly
+   *        If true, only the plugins' headers are loaded. If false, all records
+   *        in the plugins are parsed.
+   * @param cancellationToken
+   *        A token that can be used to cancel loading.
+   * @returns A future that becomes ready once loading has finished. Getting
+   *          its value rethrows any exception that loading threw, including an
+   *          OperationCancelledError if loading was cancelled.
+   */
+  virtual std::future<void> LoadPluginsAsync(
+      const std::vector<std::filesystem::path>& pluginPaths,
+      bool loadHeadersOnly,
+      const CancellationToken& cancellationToken) = 0;
+
   /**
    * @brief Clears the plugins loaded by previous calls to `LoadPlugins()`.
    * @details This does not affect any existing PluginInterface objects.
@@ -177,6 +256,67 @@ public:
   virtual std::vector<std::string> SortPlugins(
       const std::vector<std::string>& pluginFilenames) = 0;
 
+  /**
+   *  @brief Calculates a new load order for the given plugins without copying
+   *         their filenames.
+   *  @details This behaves the same as `SortPlugins()`, but the given strings
+   *           are passed to libloot without first being copied.
+   *  @param pluginFilenames
+   *         The UTF-8 encoded filenames of the plugins to sort, in their
+   *         current load order. All given plugins must have been loaded using
+   *         `LoadPlugins()`.
+   *  @returns A vector of the given plugin filenames in their sorted load
+   *           order.
+   */
+  virtual std::vector<std::string> SortPluginsUtf8(
+      const std::vector<std::string_view>& pluginFilenames) = 0;
+
+  /**
+   *  @brief Asynchronously calculates a new load order for the given plugins.
+   *  @details This behaves the same as `SortPlugins()`, but runs on a
+   *           background thread and returns immediately. The cancellation token
+   *           is checked between each phase of sorting.
+   *
+   *           This object must outlive the returned future, and its other
+   *           member functions (aside from `GetDatabase()`) must not be called
+   *           until the future is ready.
+   *  @param pluginFilenames
+   *         The plugins to sort, in their current load order. All given plugins
+   *         must have been loaded using `LoadPlugins()`.
+   *  @param cancellationToken
+   *         A token that can be used to cancel sorting.
+   *  @returns A future that holds the given plugin filenames in their sorted
+   *           load order. Getting its value rethrows any exception that sorting
+   *           threw, including an OperationCancelledError if sorting was
+   *           cancelled.
+   */
+  virtual std::future<std::vector<std::string>> SortPluginsAsync(
+      const std::vector<std::string>& pluginFilenames,
+      const CancellationToken& cancellationToken) = 0;
+
+  /**
+   *  @brief Set the callback function that is called to report progress
+   *         while loading and sorting plugins.
+   *  @details The callback is passed the current phase, the number of steps
+   *           done in that phase so far, and the total number of steps in that
+   *           phase. It is called with zero steps done when a phase starts,
+   *           and then at most once for each percent of the phase's steps that
+   *           are done, so it's not called once per step for large load orders.
+   *
+   *           Sorting may add edges for several independent sets of plugins,
+   *           so each edge-adding phase may be reported more than once per
+   *           call to `SortPlugins()`.
+   *
+   *           The callback may be called from threads other than the one
+   *           that started loading or sorting, though calls are not made
+   *           concurrently. It must not call any member functions of this
+   *           object. Any exceptions it throws are ignored.
+   *  @param callback
+   *         The function that progress is reported to.
+   */
+  virtual void SetProgressCallback(
+      std::function<void(ProgressPhase, size_t, size_t)> callback) = 0;
+
   /**
    *  @}
    *  @name Load Order Interaction
@@ -237,6 +377,18 @@ public:
    *        A vector of plugin filenames sorted in the load order to set.
    */
   virtual void SetLoadOrder(const std::vector<std::string>& loadOrder) = 0;
+
+  /**
+   * @brief Set the game's load order without copying the given plugin
+   *        filenames.
+   * @details This behaves the same as `SetLoadOrder()`, but the given strings
+   *          are passed to libloot without first being copied.
+   * @param loadOrder
+   *        A vector of UTF-8 encoded plugin filenames sorted in the load order
+   *        to set.
+   */
+  virtual void SetLoadOrderUtf8(
+      const std::vector<std::string_view>& loadOrder) = 0;
 };
 }
 
@@ -0,0 +1,147 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2026 Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#ifndef LOOT_GAME_SNAPSHOT_INTERFACE
+#define LOOT_GAME_SNAPSHOT_INTERFACE
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "loot/enum/game_type.h"
+#include "loot/metadata/message.h"
+#include "loot/metadata/plugin_metadata.h"
+#include "loot/plugin_interface.h"
+
+namespace loot {
+/**
+ * @brief The interface provided for reading an immutable snapshot of a game's
+ *        loaded plugins, load order and metadata.
+ * @details A snapshot captures the state of the game handle that it was taken
+ *          from, and is not affected by later changes to that game handle or
+ *          its database. All member functions are const and may be called
+ *          concurrently from any number of threads, without blocking or being
+ *          blocked by the game handle.
+ *
+ *          Snapshots share their plugin data and metadata with the game handle
+ *          instead of copying it. Each snapshot has its own condition cache,
+ *          which starts empty.
+ */
+class GameSnapshotInterface {
+public:
+  GameSnapshotInterface() = default;
+  GameSnapshotInterface(const GameSnapshotInterface&) = delete;
+  GameSnapshotInterface(GameSnapshotInterface&&) = delete;
+
+  virtual ~GameSnapshotInterface() = default;
+
+  GameSnapshotInterface& operator=(const GameSnapshotInterface&) = delete;
+  GameSnapshotInterface& operator=(GameSnapshotInterface&&) = delete;
+
+  /**
+   * @brief Get the type of the game that the snapshot was taken of.
+   * @returns The game's type.
+   */
+  virtual GameType GetType() const = 0;
+
+  /**
+   * @brief Get data for a plugin that was loaded when the snapshot was taken.
+   * @param  pluginName
+   *         The filename of the plugin to get data for.
+   * @returns A pointer to a const PluginInterface implementation. The
+   *          pointer is null if the given plugin was not loaded.
+   */
+  virtual std::unique_ptr<const PluginInterface> GetPlugin(
+      std::string_view pluginName) const = 0;
+
+  /**
+   * @brief Get data for all plugins that were loaded when the snapshot was
+   *        taken.
+   * @returns A vector of pointers to const PluginInterface implementations.
+   *          The vector elements are in no particular order.
+   */
+  virtual std::vector<std::unique_ptr<const PluginInterface>>
+  GetLoadedPlugins() const = 0;
+
+  /**
+   * @brief Check if a plugin was active when the snapshot was taken.
+   * @param  plugin
+   *         The filename of the plugin for which to check the active state.
+   * @returns True if the plugin was active, false otherwise.
+   */
+  virtual bool IsPluginActive(const std::string& plugin) const = 0;
+
+  /**
+   * @brief Get the load order as it was when the snapshot was taken.
+   * @returns A vector of plugin filenames in their load order.
+   */
+  virtual std::vector<std::string> GetLoadOrder() const = 0;
+
+  /**
+   * @brief Evaluate the given condition string against the snapshot's state.
+   * @param condition A condition string.
+   */
+  virtual bool Evaluate(const std::string& condition) const = 0;
+
+  /**
+   * @brief Get all general messages listed in the metadata that was loaded
+   *        when the snapshot was taken.
+   * @param includeUserMetadata
+   *        If true, any general messages present in the userlist are included
+   *        in the returned metadata, otherwise the metadata returned only
+   *        includes metadata from the masterlist.
+   * @param evaluateConditions
+   *        If true, any metadata conditions are evaluated before the metadata
+   *        is returned, otherwise unevaluated metadata is returned.
+   * @returns The messages supplied in the metadata lists that are not attached
+   *          to any particular plugin.
+   */
+  virtual std::vector<Message> GetGeneralMessages(
+      bool includeUserMetadata = true,
+      bool evaluateConditions = false) const = 0;
+
+  /**
+   * @brief Get all of a plugin's metadata that was loaded when the snapshot
+   *        was taken.
+   * @param plugin
+   *        The filename of the plugin to look up metadata for.
+   * @param includeUserMetadata
+   *        If true, any user metadata the plugin has is included in the
+   *        returned metadata, otherwise the metadata returned only includes
+   *        metadata from the masterlist.
+   * @param evaluateConditions
+   *        If true, any metadata conditions are evaluated before the metadata
+   *        is returned, otherwise unevaluated metadata is returned.
+   * @returns If the plugin has metadata, an optional containing that metadata,
+   *          otherwise an optional containing no value.
+   */
+  virtual std::optional<PluginMetadata> GetPluginMetadata(
+      std::string_view plugin,
+      bool includeUserMetadata = true,
+      bool evaluateConditions = false) const = 0;
+};
+}
+
+#endif
@@ -26,6 +26,7 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "loot/api_decorator.h"
 #include "loot/metadata/filename.h"
@@ -62,20 +63,20 @@ public:
   LOOT_API explicit File(std::string_view name,
                          std::string_view display = "",
                          std::string_view condition = "",
-                         const std::vector<MessageContent>& detail = {},
+                         std::vector<MessageContent> detail = {},
                          std::string_view constraint = "");
 
   /**
    * Get the filename of the file.
    * @return The file's filename.
    */
-  LOOT_API Filename GetName() const;
+  LOOT_API const Filename& GetName() const;
 
   /**
    * Get the display name of the file.
    * @return The file's display name.
    */
-  LOOT_API std::string GetDisplayName() const;
+  LOOT_API const std::string& GetDisplayName() const;
 
   /**
    * Get the detail message content of the file.
@@ -84,19 +85,19 @@ public:
    * content should be appended to that message, as it provides more detail
    * about the error (e.g. suggestions for how to resolve it).
    */
-  LOOT_API std::vector<MessageContent> GetDetail() const;
+  LOOT_API const std::vector<MessageContent>& GetDetail() const;
 
   /**
    * Get the condition string.
    * @return The file's condition string.
    */
-  LOOT_API std::string GetCondition() const;
+  LOOT_API const std::string& GetCondition() const;
 
   /**
    * Get the constraint that applies to the file.
    * @return The file's constraint.
    */
-  LOOT_API std::string GetConstraint() const;
+  LOOT_API const std::string& GetConstraint() const;
 
 private:
   Filename name_;
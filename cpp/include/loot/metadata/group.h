@@ -58,26 +58,26 @@ public:
    *         A description of the group.
    */
   LOOT_API explicit Group(std::string_view name,
-                          const std::vector<std::string>& afterGroups = {},
+                          std::vector<std::string> afterGroups = {},
                           std::string_view description = "");
 
   /**
    * Get the name of the group.
    * @return The group's name.
    */
-  LOOT_API std::string GetName() const;
+  LOOT_API const std::string& GetName() const;
 
   /**
    * Get the description of the group.
    * @return The group's description.
    */
-  LOOT_API std::string GetDescription() const;
+  LOOT_API const std::string& GetDescription() const;
 
   /**
    * Get the set of groups this group loads after.
    * @return A set of group names.
    */
-  LOOT_API std::vector<std::string> GetAfterGroups() const;
+  LOOT_API const std::vector<std::string>& GetAfterGroups() const;
 
 private:
   std::string name_{DEFAULT_NAME};
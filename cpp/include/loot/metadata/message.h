@@ -69,7 +69,7 @@ public:
    *         A condition string.
    */
   LOOT_API explicit Message(const MessageType type,
-                            const std::vector<MessageContent>& content,
+                            std::vector<MessageContent> content,
                             std::string_view condition = "");
 
   /**
@@ -82,13 +82,13 @@ public:
    * Get the message content.
    * @return The message's MessageContent objects.
    */
-  LOOT_API std::vector<MessageContent> GetContent() const;
+  LOOT_API const std::vector<MessageContent>& GetContent() const;
 
   /**
    * Get the condition string.
    * @return The message's condition string.
    */
-  LOOT_API std::string GetCondition() const;
+  LOOT_API const std::string& GetCondition() const;
 
 private:
   MessageType type_{MessageType::say};
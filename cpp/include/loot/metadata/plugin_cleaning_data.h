@@ -28,6 +28,7 @@
 #include <cstdint>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "loot/api_decorator.h"
 #include "loot/metadata/message.h"
@@ -79,7 +80,7 @@ public:
   LOOT_API explicit PluginCleaningData(
       uint32_t crc,
       std::string_view utility,
-      const std::vector<MessageContent>& detail,
+      std::vector<MessageContent> detail,
       unsigned int itm,
       unsigned int ref,
       unsigned int nav,
@@ -115,7 +116,7 @@ public:
    *         a version number and/or a CommonMark-formatted URL to the utility's
    *         download location.
    */
-  LOOT_API std::string GetCleaningUtility() const;
+  LOOT_API const std::string& GetCleaningUtility() const;
 
   /**
    * Get any additional informative message content supplied with the cleaning
@@ -123,13 +124,13 @@ public:
    * cleaning steps.
    * @return A vector of localised MessageContent objects.
    */
-  LOOT_API std::vector<MessageContent> GetDetail() const;
+  LOOT_API const std::vector<MessageContent>& GetDetail() const;
 
   /**
    * Get the condition string.
    * @return The cleaning data's condition string.
    */
-  LOOT_API std::string GetCondition() const;
+  LOOT_API const std::string& GetCondition() const;
 
 private:
   uint32_t crc_{0};
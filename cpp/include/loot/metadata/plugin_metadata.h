@@ -74,7 +74,7 @@ public:
    * Get the plugin name.
    * @return The plugin name.
    */
-  LOOT_API std::string GetName() const;
+  LOOT_API const std::string& GetName() const;
 
   /**
    * Get the plugin's group.
@@ -82,55 +82,55 @@ public:
    *         if it was explicitly set, otherwise an optional containing no
    *         value.
    */
-  LOOT_API std::optional<std::string> GetGroup() const;
+  LOOT_API const std::optional<std::string>& GetGroup() const;
 
   /**
    * Get the plugins that the plugin must load after.
    * @return The plugins that the plugin must load after.
    */
-  LOOT_API std::vector<File> GetLoadAfterFiles() const;
+  LOOT_API const std::vector<File>& GetLoadAfterFiles() const;
 
   /**
    * Get the files that the plugin requires to be installed.
    * @return The files that the plugin requires to be installed.
    */
-  LOOT_API std::vector<File> GetRequirements() const;
+  LOOT_API const std::vector<File>& GetRequirements() const;
 
   /**
    * Get the files that the plugin is incompatible with.
    * @return The files that the plugin is incompatible with.
    */
-  LOOT_API std::vector<File> GetIncompatibilities() const;
+  LOOT_API const std::vector<File>& GetIncompatibilities() const;
 
   /**
    * Get the plugin's messages.
    * @return The plugin's messages.
    */
-  LOOT_API std::vector<Message> GetMessages() const;
+  LOOT_API const std::vector<Message>& GetMessages() const;
 
   /**
    * Get the plugin's Bash Tag suggestions.
    * @return The plugin's Bash Tag suggestions.
    */
-  LOOT_API std::vector<Tag> GetTags() const;
+  LOOT_API const std::vector<Tag>& GetTags() const;
 
   /**
    * Get the plugin's dirty plugin information.
    * @return The PluginCleaningData objects that identify the plugin as dirty.
    */
-  LOOT_API std::vector<PluginCleaningData> GetDirtyInfo() const;
+  LOOT_API const std::vector<PluginCleaningData>& GetDirtyInfo() const;
 
   /**
    * Get the plugin's clean plugin information.
    * @return The PluginCleaningData objects that identify the plugin as clean.
    */
-  LOOT_API std::vector<PluginCleaningData> GetCleanInfo() const;
+  LOOT_API const std::vector<PluginCleaningData>& GetCleanInfo() const;
 
   /**
    * Get the locations at which this plugin can be found.
    * @return The locations at which this plugin can be found.
    */
-  LOOT_API std::vector<Location> GetLocations() const;
+  LOOT_API const std::vector<Location>& GetLocations() const;
 
   /**
    * Set the plugin's group.
@@ -151,6 +151,14 @@ public:
    */
   LOOT_API void SetLoadAfterFiles(const std::vector<File>& after);
 
+  /**
+   * Set the files that the plugin must load after.
+   * @param after
+   *        The files to set.
+   *        The given vector is moved from.
+   */
+  LOOT_API void SetLoadAfterFiles(std::vector<File>&& after);
+
   /**
    * Set the files that the plugin requires to be installed.
    * @param requirements
@@ -159,13 +167,29 @@ public:
   LOOT_API void SetRequirements(const std::vector<File>& requirements);
 
   /**
-   * Set the files that the plugin must load after.
+   * Set the files that the plugin requires to be installed.
+   * @param requirements
+   *        The files to set.
+   *        The given vector is moved from.
+   */
+  LOOT_API void SetRequirements(std::vector<File>&& requirements);
+
+  /**
+   * Set the files that the plugin is incompatible with.
    * @param incompatibilities
    *        The files to set.
    */
   LOOT_API void SetIncompatibilities(
       const std::vector<File>& incompatibilities);
 
+  /**
+   * Set the files that the plugin is incompatible with.
+   * @param incompatibilities
+   *        The files to set.
+   *        The given vector is moved from.
+   */
+  LOOT_API void SetIncompatibilities(std::vector<File>&& incompatibilities);
+
   /**
    * Set the plugin's messages.
    * @param messages
@@ -173,6 +197,14 @@ public:
    */
   LOOT_API void SetMessages(const std::vector<Message>& messages);
 
+  /**
+   * Set the plugin's messages.
+   * @param messages
+   *        The messages to set.
+   *        The given vector is moved from.
+   */
+  LOOT_API void SetMessages(std::vector<Message>&& messages);
+
   /**
    * Set the plugin's Bash Tag suggestions.
    * @param tags
@@ -180,6 +212,14 @@ public:
    */
   LOOT_API void SetTags(const std::vector<Tag>& tags);
 
+  /**
+   * Set the plugin's Bash Tag suggestions.
+   * @param tags
+   *        The Bash Tag suggestions to set.
+   *        The given vector is moved from.
+   */
+  LOOT_API void SetTags(std::vector<Tag>&& tags);
+
   /**
    * Set the plugin's dirty information.
    * @param info
@@ -187,6 +227,14 @@ public:
    */
   LOOT_API void SetDirtyInfo(const std::vector<PluginCleaningData>& info);
 
+  /**
+   * Set the plugin's dirty information.
+   * @param info
+   *        The dirty information to set.
+   *        The given vector is moved from.
+   */
+  LOOT_API void SetDirtyInfo(std::vector<PluginCleaningData>&& info);
+
   /**
    * Set the plugin's clean information.
    * @param info
@@ -194,6 +242,14 @@ public:
    */
   LOOT_API void SetCleanInfo(const std::vector<PluginCleaningData>& info);
 
+  /**
+   * Set the plugin's clean information.
+   * @param info
+   *        The clean information to set.
+   *        The given vector is moved from.
+   */
+  LOOT_API void SetCleanInfo(std::vector<PluginCleaningData>&& info);
+
   /**
    * Set the plugin's locations.
    * @param locations
@@ -201,6 +257,14 @@ public:
    */
   LOOT_API void SetLocations(const std::vector<Location>& locations);
 
+  /**
+   * Set the plugin's locations.
+   * @param locations
+   *        The locations to set.
+   *        The given vector is moved from.
+   */
+  LOOT_API void SetLocations(std::vector<Location>&& locations);
+
   /**
    * Check if no plugin metadata is set.
    * @return True if the group is implicit and the metadata containers are all
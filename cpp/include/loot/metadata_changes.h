@@ -0,0 +1,63 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2026 Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+
+#ifndef LOOT_METADATA_CHANGES
+#define LOOT_METADATA_CHANGES
+
+#include <string>
+#include <vector>
+
+namespace loot {
+/**
+ * @brief The differences between a reloaded masterlist and the masterlist
+ *        that it replaced.
+ */
+struct MetadataChanges {
+  /**
+   * @brief Whether the known Bash Tags are different.
+   */
+  bool bashTagsChanged{false};
+
+  /**
+   * @brief Whether the groups are different.
+   */
+  bool groupsChanged{false};
+
+  /**
+   * @brief Whether the general messages are different.
+   */
+  bool messagesChanged{false};
+
+  /**
+   * @brief The names of the plugin metadata entries that were added, removed
+   *        or changed.
+   * @details Entries with regex names are listed by their regex, so their
+   *          changes may affect any plugins that the regex matches.
+   */
+  std::vector<std::string> changedPlugins;
+};
+}
+
+#endif
@@ -0,0 +1,12 @@
+#include "api/cancellation_token.h"
+
+namespace loot {
+CancellationToken::CancellationToken() :
+    state_(std::make_shared<State>(State{loot::rust::new_cancellation_token()})) {}
+
+void CancellationToken::Cancel() { state_->token->cancel(); }
+
+bool CancellationToken::IsCancelled() const {
+  return state_->token->is_cancelled();
+}
+}
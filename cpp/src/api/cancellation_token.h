@@ -0,0 +1,21 @@
+#ifndef LOOT_API_CANCELLATION_TOKEN
+#define LOOT_API_CANCELLATION_TOKEN
+
+#include "libloot-cpp/src/lib.rs.h"
+#include "loot/cancellation_token.h"
+#include "rust/cxx.h"
+
+namespace loot {
+struct CancellationToken::State {
+  ::rust::Box<loot::rust::CancellationToken> token;
+};
+
+struct CancellationTokenAccess {
+  static const loot::rust::CancellationToken& getToken(
+      const CancellationToken& token) {
+    return *token.state_->token;
+  }
+};
+}
+
+#endif
@@ -71,6 +71,37 @@ loot::File convert(const loot::rust::File& file) {
                     convert(file.constraint()));
 }
 
+loot::GameType convert(loot::rust::GameType gameType) {
+  switch (gameType) {
+    case loot::rust::GameType::Morrowind:
+      return loot::GameType::tes3;
+    case loot::rust::GameType::Oblivion:
+      return loot::GameType::tes4;
+    case loot::rust::GameType::Skyrim:
+      return loot::GameType::tes5;
+    case loot::rust::GameType::SkyrimSE:
+      return loot::GameType::tes5se;
+    case loot::rust::GameType::SkyrimVR:
+      return loot::GameType::tes5vr;
+    case loot::rust::GameType::Fallout3:
+      return loot::GameType::fo3;
+    case loot::rust::GameType::FalloutNV:
+      return loot::GameType::fonv;
+    case loot::rust::GameType::Fallout4:
+      return loot::GameType::fo4;
+    case loot::rust::GameType::Fallout4VR:
+      return loot::GameType::fo4vr;
+    case loot::rust::GameType::Starfield:
+      return loot::GameType::starfield;
+    case loot::rust::GameType::OpenMW:
+      return loot::GameType::openmw;
+    case loot::rust::GameType::OblivionRemastered:
+      return loot::GameType::oblivionRemastered;
+    default:
+      throw std::logic_error("Unsupported GameType value");
+  }
+}
+
 loot::MessageType convert(loot::rust::MessageType messageType) {
   switch (messageType) {
     case loot::rust::MessageType::Say:
@@ -268,6 +299,7 @@ loot::rust::MessageType convert(loot::MessageType messageType) {
 
 ::rust::Vec<::rust::String> convert(const std::vector<std::string>& vector) {
   ::rust::Vec<::rust::String> strings;
+  strings.reserve(vector.size());
   for (const auto& str : vector) {
     strings.push_back(str);
   }
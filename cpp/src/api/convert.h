@@ -2,6 +2,7 @@
 #define LOOT_API_CONVERT
 
 #include "libloot-cpp/src/lib.rs.h"
+#include "loot/enum/game_type.h"
 #include "loot/metadata/group.h"
 #include "loot/metadata/plugin_metadata.h"
 #include "loot/vertex.h"
@@ -18,6 +19,8 @@ loot::Group convert(const loot::rust::Group& group);
 
 loot::File convert(const loot::rust::File& file);
 
+loot::GameType convert(loot::rust::GameType gameType);
+
 loot::MessageType convert(loot::rust::MessageType messageType);
 
 loot::MessageContent convert(const loot::rust::MessageContent& content);
@@ -70,6 +73,7 @@ loot::rust::MessageType convert(loot::MessageType messageType);
 template<typename T, typename U>
 std::vector<T> convert(const ::rust::Slice<const U>& slice) {
   std::vector<T> output;
+  output.reserve(slice.size());
   for (const auto& element : slice) {
     output.push_back(convert(element));
   }
@@ -85,6 +89,7 @@ std::vector<T> convert(const ::rust::Vec<U>& vec) {
 template<typename T, typename U>
 const ::rust::Vec<::rust::Box<T>> convert(const std::vector<U>& vec) {
   ::rust::Vec<::rust::Box<T>> output;
+  output.reserve(vec.size());
   for (const auto& element : vec) {
     output.push_back(convert(element));
   }
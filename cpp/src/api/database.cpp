@@ -16,6 +16,17 @@ loot::MetadataWriteOptionsImpl convert(
 
   return output;
 }
+
+loot::MetadataChanges convert(const loot::rust::MetadataChangesImpl& changes) {
+  loot::MetadataChanges output;
+
+  output.bashTagsChanged = changes.bash_tags_changed;
+  output.groupsChanged = changes.groups_changed;
+  output.messagesChanged = changes.messages_changed;
+  output.changedPlugins = loot::convert<std::string>(changes.changed_plugins);
+
+  return output;
+}
 }
 
 namespace loot {
@@ -95,6 +106,26 @@ void Database::LoadMasterlistWithPrelude(
   }
 }
 
+MetadataChanges Database::ReloadMasterlist(
+    const std::filesystem::path& masterlistPath) {
+  try {
+    return ::convert(database_->reload_masterlist(masterlistPath.u8string()));
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
+MetadataChanges Database::ReloadMasterlistWithPrelude(
+    const std::filesystem::path& masterlistPath,
+    const std::filesystem::path& masterlistPreludePath) {
+  try {
+    return ::convert(database_->reload_masterlist_with_prelude(
+        masterlistPath.u8string(), masterlistPreludePath.u8string()));
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
 void Database::LoadUserlist(const std::filesystem::path& userlistPath) {
   try {
     database_->load_userlist(userlistPath.u8string());
@@ -112,6 +143,17 @@ void Database::WriteUserMetadata(const std::filesystem::path& outputFile,
   }
 }
 
+void Database::WriteUserMetadataChanges(
+    const std::filesystem::path& userlistPath,
+    const MetadataWriteOptions& options) {
+  try {
+    database_->write_user_metadata_changes(userlistPath.u8string(),
+                                           ::convert(options));
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
 bool Database::Evaluate(const std::string& condition) const {
   try {
     return database_->evaluate(condition);
@@ -120,6 +162,23 @@ bool Database::Evaluate(const std::string& condition) const {
   }
 }
 
+std::vector<bool> Database::EvaluateMany(
+    const std::vector<std::string>& conditions) const {
+  std::vector<::rust::Str> conditionStrs;
+  conditionStrs.reserve(conditions.size());
+  for (const auto& condition : conditions) {
+    conditionStrs.push_back(convert(std::string_view(condition)));
+  }
+
+  try {
+    const auto results = database_->evaluate_many(::rust::Slice(conditionStrs));
+
+    return std::vector<bool>(results.begin(), results.end());
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
 void Database::ClearConditionCache() {
   try {
     return database_->clear_condition_cache();
@@ -128,6 +187,15 @@ void Database::ClearConditionCache() {
   }
 }
 
+ConditionCacheStats Database::GetConditionCacheStats() const {
+  try {
+    const auto stats = database_->condition_cache_stats();
+    return ConditionCacheStats{stats.hits, stats.misses, stats.invalidations};
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
 std::vector<std::string> Database::GetKnownBashTags(
     bool includeUserMetadata) const {
   try {
@@ -165,6 +233,18 @@ std::vector<Message> Database::GetGeneralMessages(
   }
 }
 
+std::vector<Message> Database::GetLocalisedGeneralMessages(
+    std::string_view language,
+    bool includeUserMetadata,
+    bool evaluateConditions) const {
+  try {
+    return convert<Message>(database_->localised_general_messages(
+        convert(language), includeUserMetadata, evaluateConditions));
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
 std::vector<Message> Database::GetUserGeneralMessages(
     bool evaluateConditions) const {
   try {
@@ -236,6 +316,59 @@ std::optional<PluginMetadata> Database::GetPluginMetadata(
   }
 }
 
+std::optional<PluginMetadata> Database::GetLocalisedPluginMetadata(
+    std::string_view plugin,
+    std::string_view language,
+    bool includeUserMetadata,
+    bool evaluateConditions) const {
+  try {
+    const auto metadata =
+        database_->localised_plugin_metadata(convert(plugin),
+                                             convert(language),
+                                             includeUserMetadata,
+                                             evaluateConditions);
+    if (metadata->is_some()) {
+      return convert(metadata->as_ref());
+    } else {
+      return std::nullopt;
+    }
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
+std::vector<std::optional<PluginMetadata>> Database::GetPluginsMetadata(
+    const std::vector<std::string>& plugins,
+    bool includeUserMetadata,
+    bool evaluateConditions) const {
+  std::vector<::rust::Str> pluginStrs;
+  pluginStrs.reserve(plugins.size());
+  for (const auto& plugin : plugins) {
+    pluginStrs.push_back(convert(std::string_view(plugin)));
+  }
+
+  try {
+    const auto metadata =
+        database_->plugins_metadata(::rust::Slice(pluginStrs),
+                                    includeUserMetadata,
+                                    evaluateConditions);
+
+    std::vector<std::optional<PluginMetadata>> output;
+    output.reserve(metadata.size());
+    for (const auto& pluginMetadata : metadata) {
+      if (pluginMetadata.is_some()) {
+        output.push_back(convert(pluginMetadata.as_ref()));
+      } else {
+        output.push_back(std::nullopt);
+      }
+    }
+
+    return output;
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
 std::optional<PluginMetadata> Database::GetPluginUserMetadata(
     std::string_view plugin,
     bool evaluateConditions) const {
@@ -252,6 +385,28 @@ std::optional<PluginMetadata> Database::GetPluginUserMetadata(
   }
 }
 
+std::vector<std::string> Database::GetPluginsReferencing(
+    std::string_view filename,
+    bool includeUserMetadata) const {
+  try {
+    return convert<std::string>(
+        database_->plugins_referencing(convert(filename), includeUserMetadata));
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
+std::vector<std::string> Database::GetPluginsInGroup(
+    std::string_view groupName,
+    bool includeUserMetadata) const {
+  try {
+    return convert<std::string>(
+        database_->plugins_in_group(convert(groupName), includeUserMetadata));
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
 void Database::SetPluginUserMetadata(const PluginMetadata& pluginMetadata) {
   try {
     database_->set_plugin_user_metadata(convert(pluginMetadata));
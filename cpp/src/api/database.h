@@ -16,18 +16,33 @@ public:
       const std::filesystem::path& masterlistPath,
       const std::filesystem::path& masterlistPreludePath) override;
 
+  MetadataChanges ReloadMasterlist(
+      const std::filesystem::path& masterlistPath) override;
+
+  MetadataChanges ReloadMasterlistWithPrelude(
+      const std::filesystem::path& masterlistPath,
+      const std::filesystem::path& masterlistPreludePath) override;
+
   void LoadUserlist(const std::filesystem::path& userlist_path) override;
 
   void WriteUserMetadata(const std::filesystem::path& outputFile,
                          const MetadataWriteOptions& options) const override;
 
+  void WriteUserMetadataChanges(const std::filesystem::path& userlistPath,
+                                const MetadataWriteOptions& options) override;
+
   void WriteMinimalList(const std::filesystem::path& outputFile,
                         const MetadataWriteOptions& options) const override;
 
   bool Evaluate(const std::string& condition) const override;
 
+  std::vector<bool> EvaluateMany(
+      const std::vector<std::string>& conditions) const override;
+
   void ClearConditionCache() override;
 
+  ConditionCacheStats GetConditionCacheStats() const override;
+
   std::vector<std::string> GetKnownBashTags(
       bool includeUserMetadata = true) const override;
 
@@ -39,6 +54,11 @@ public:
       bool includeUserMetadata = true,
       bool evaluateConditions = false) const override;
 
+  std::vector<Message> GetLocalisedGeneralMessages(
+      std::string_view language,
+      bool includeUserMetadata = true,
+      bool evaluateConditions = false) const override;
+
   std::vector<Message> GetUserGeneralMessages(
       bool evaluateConditions = false) const override;
 
@@ -56,6 +76,25 @@ public:
       bool includeUserMetadata = true,
       bool evaluateConditions = false) const override;
 
+  std::optional<PluginMetadata> GetLocalisedPluginMetadata(
+      std::string_view plugin,
+      std::string_view language,
+      bool includeUserMetadata = true,
+      bool evaluateConditions = false) const override;
+
+  std::vector<std::optional<PluginMetadata>> GetPluginsMetadata(
+      const std::vector<std::string>& plugins,
+      bool includeUserMetadata = true,
+      bool evaluateConditions = false) const override;
+
+  std::vector<std::string> GetPluginsReferencing(
+      std::string_view filename,
+      bool includeUserMetadata = true) const override;
+
+  std::vector<std::string> GetPluginsInGroup(
+      std::string_view groupName,
+      bool includeUserMetadata = true) const override;
+
   std::optional<PluginMetadata> GetPluginUserMetadata(
       std::string_view plugin,
       bool evaluateConditions = false) const override;
@@ -3,6 +3,7 @@
 #include <charconv>
 
 #include "loot/exception/cyclic_interaction_error.h"
+#include "loot/exception/operation_cancelled_error.h"
 #include "loot/exception/plugin_not_loaded_error.h"
 #include "loot/exception/undefined_group_error.h"
 #include "loot/vertex.h"
@@ -17,6 +18,8 @@ constexpr std::string_view UNDEFINED_GROUP_ERROR_PREFIX =
     "UndefinedGroupError: "sv;
 constexpr std::string_view PLUGIN_NOT_LOADED_ERROR_PREFIX =
     "PluginNotLoadedError: "sv;
+constexpr std::string_view OPERATION_CANCELLED_ERROR_PREFIX =
+    "OperationCancelledError: "sv;
 constexpr std::string_view INVALID_ARGUMENT_PREFIX = "InvalidArgument: "sv;
 
 bool startsWith(std::string_view str, std::string_view prefix) {
@@ -130,6 +133,9 @@ std::exception_ptr mapError(const ::rust::Error& error) {
     return std::make_exception_ptr(
         PluginNotLoadedError("The plugin \"" + getErrorSuffix(error.what()) +
                              "\" has not been loaded"));
+  } else if (startsWith(error.what(), OPERATION_CANCELLED_ERROR_PREFIX)) {
+    return std::make_exception_ptr(
+        OperationCancelledError(getErrorSuffix(error.what())));
   } else if (startsWith(error.what(), INVALID_ARGUMENT_PREFIX)) {
     return std::make_exception_ptr(
         std::invalid_argument(getErrorSuffix(error.what())));
@@ -1,38 +1,71 @@
 
 #include "api/game.h"
 
+#include "api/cancellation_token.h"
 #include "api/convert.h"
 #include "api/exception/exception.h"
+#include "api/game_snapshot.h"
+
+extern "C" {
+extern const uint8_t LIBLOOT_PROGRESS_PHASE_VALIDATING_PATHS;
+
+extern const uint8_t LIBLOOT_PROGRESS_PHASE_READING_ARCHIVES;
+
+extern const uint8_t LIBLOOT_PROGRESS_PHASE_PARSING_PLUGINS;
+
+extern const uint8_t LIBLOOT_PROGRESS_PHASE_PREPARING_SORTING_DATA;
+
+extern const uint8_t LIBLOOT_PROGRESS_PHASE_ADDING_SPECIFIC_EDGES;
+
+extern const uint8_t LIBLOOT_PROGRESS_PHASE_ADDING_GROUP_EDGES;
+
+extern const uint8_t LIBLOOT_PROGRESS_PHASE_ADDING_OVERLAP_EDGES;
+
+extern const uint8_t LIBLOOT_PROGRESS_PHASE_ADDING_TIE_BREAK_EDGES;
+
+void libloot_game_set_progress_callback(
+    loot::rust::Game* game,
+    void (*callback)(uint8_t, size_t, size_t, void*),
+    void* context);
+}
 
 namespace {
-loot::GameType convert(loot::rust::GameType gameType) {
-  switch (gameType) {
-    case loot::rust::GameType::Morrowind:
-      return loot::GameType::tes3;
-    case loot::rust::GameType::Oblivion:
-      return loot::GameType::tes4;
-    case loot::rust::GameType::Skyrim:
-      return loot::GameType::tes5;
-    case loot::rust::GameType::SkyrimSE:
-      return loot::GameType::tes5se;
-    case loot::rust::GameType::SkyrimVR:
-      return loot::GameType::tes5vr;
-    case loot::rust::GameType::Fallout3:
-      return loot::GameType::fo3;
-    case loot::rust::GameType::FalloutNV:
-      return loot::GameType::fonv;
-    case loot::rust::GameType::Fallout4:
-      return loot::GameType::fo4;
-    case loot::rust::GameType::Fallout4VR:
-      return loot::GameType::fo4vr;
-    case loot::rust::GameType::Starfield:
-      return loot::GameType::starfield;
-    case loot::rust::GameType::OpenMW:
-      return loot::GameType::openmw;
-    case loot::rust::GameType::OblivionRemastered:
-      return loot::GameType::oblivionRemastered;
-    default:
-      throw std::logic_error("Unsupported GameType value");
+typedef std::function<void(loot::ProgressPhase, size_t, size_t)>
+    ProgressCallback;
+
+loot::ProgressPhase convertProgressPhase(uint8_t phase) {
+  if (phase == LIBLOOT_PROGRESS_PHASE_VALIDATING_PATHS) {
+    return loot::ProgressPhase::validatingPaths;
+  } else if (phase == LIBLOOT_PROGRESS_PHASE_READING_ARCHIVES) {
+    return loot::ProgressPhase::readingArchives;
+  } else if (phase == LIBLOOT_PROGRESS_PHASE_PARSING_PLUGINS) {
+    return loot::ProgressPhase::parsingPlugins;
+  } else if (phase == LIBLOOT_PROGRESS_PHASE_PREPARING_SORTING_DATA) {
+    return loot::ProgressPhase::preparingSortingData;
+  } else if (phase == LIBLOOT_PROGRESS_PHASE_ADDING_SPECIFIC_EDGES) {
+    return loot::ProgressPhase::addingSpecificEdges;
+  } else if (phase == LIBLOOT_PROGRESS_PHASE_ADDING_GROUP_EDGES) {
+    return loot::ProgressPhase::addingGroupEdges;
+  } else if (phase == LIBLOOT_PROGRESS_PHASE_ADDING_OVERLAP_EDGES) {
+    return loot::ProgressPhase::addingOverlapEdges;
+  } else if (phase == LIBLOOT_PROGRESS_PHASE_ADDING_TIE_BREAK_EDGES) {
+    return loot::ProgressPhase::addingTieBreakEdges;
+  } else {
+    throw std::logic_error("Unsupported ProgressPhase value");
+  }
+}
+
+void progressCallback(uint8_t phase,
+                      size_t done,
+                      size_t total,
+                      void* context) noexcept {
+  try {
+    auto& callback = *static_cast<ProgressCallback*>(context);
+    if (callback) {
+      callback(convertProgressPhase(phase), done, total);
+    }
+  } catch (...) {
+    // Can't do anything with the exception.
   }
 }
 
@@ -87,14 +120,96 @@ rust::Box<loot::rust::Game> constructGame(
   }
 }
 
-std::vector<::rust::Str> asStrRefs(const std::vector<std::string>& vector) {
+template<typename T>
+std::vector<::rust::Str> asStrRefs(const std::vector<T>& vector) {
   std::vector<::rust::Str> strings;
+  strings.reserve(vector.size());
   for (const auto& str : vector) {
-    strings.push_back(str);
+    strings.push_back(loot::convert(std::string_view(str)));
+  }
+
+  return strings;
+}
+
+// References to the returned strings must not be taken until the vector has
+// been fully built, as short strings are stored inline and so move if the
+// vector reallocates.
+std::vector<std::string> asUtf8Strings(
+    const std::vector<std::filesystem::path>& paths) {
+  std::vector<std::string> strings;
+  strings.reserve(paths.size());
+  for (const auto& path : paths) {
+    strings.push_back(path.u8string());
   }
 
   return strings;
 }
+
+void loadPlugins(loot::rust::Game& game,
+                 const std::vector<::rust::Str>& pluginPaths,
+                 bool loadHeadersOnly) {
+  try {
+    if (loadHeadersOnly) {
+      game.load_plugin_headers(::rust::Slice(pluginPaths));
+    } else {
+      game.load_plugins(::rust::Slice(pluginPaths));
+    }
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(loot::mapError(e));
+  }
+}
+
+void loadPlugins(loot::rust::Game& game,
+                 const std::vector<::rust::Str>& pluginPaths,
+                 bool loadHeadersOnly,
+                 const loot::rust::CancellationToken& cancellationToken) {
+  try {
+    if (loadHeadersOnly) {
+      game.load_plugin_headers_with_cancellation(::rust::Slice(pluginPaths),
+                                                 cancellationToken);
+    } else {
+      game.load_plugins_with_cancellation(::rust::Slice(pluginPaths),
+                                          cancellationToken);
+    }
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(loot::mapError(e));
+  }
+}
+
+std::vector<std::string> sortPlugins(
+    const loot::rust::Game& game,
+    const std::vector<::rust::Str>& pluginFilenames) {
+  try {
+    const auto results = game.sort_plugins(::rust::Slice(pluginFilenames));
+
+    return loot::convert<std::string>(results);
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(loot::mapError(e));
+  }
+}
+
+std::vector<std::string> sortPlugins(
+    const loot::rust::Game& game,
+    const std::vector<::rust::Str>& pluginFilenames,
+    const loot::rust::CancellationToken& cancellationToken) {
+  try {
+    const auto results = game.sort_plugins_with_cancellation(
+        ::rust::Slice(pluginFilenames), cancellationToken);
+
+    return loot::convert<std::string>(results);
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(loot::mapError(e));
+  }
+}
+
+void setLoadOrder(loot::rust::Game& game,
+                  const std::vector<::rust::Str>& loadOrder) {
+  try {
+    game.set_load_order(::rust::Slice(loadOrder));
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(loot::mapError(e));
+  }
+}
 }
 
 namespace loot {
@@ -106,7 +221,7 @@ Game::Game(const GameType gameType,
 
 GameType Game::GetType() const {
   try {
-    return ::convert(game_->game_type());
+    return convert(game_->game_type());
   } catch (const ::rust::Error& e) {
     std::rethrow_exception(mapError(e));
   }
@@ -116,10 +231,21 @@ const DatabaseInterface& Game::GetDatabase() const { return database_; }
 
 DatabaseInterface& Game::GetDatabase() { return database_; }
 
+std::shared_ptr<const GameSnapshotInterface> Game::Snapshot() const {
+  try {
+    return std::make_shared<GameSnapshot>(game_->snapshot());
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
 std::vector<std::filesystem::path> Game::GetAdditionalDataPaths() const {
   try {
+    const auto pathStrings = game_->additional_data_paths();
+
     std::vector<std::filesystem::path> paths;
-    for (const auto& path_string : game_->additional_data_paths()) {
+    paths.reserve(pathStrings.size());
+    for (const auto& path_string : pathStrings) {
       paths.push_back(toPath(path_string));
     }
 
@@ -131,15 +257,22 @@ std::vector<std::filesystem::path> Game::GetAdditionalDataPaths() const {
 
 void Game::SetAdditionalDataPaths(
     const std::vector<std::filesystem::path>& additionalDataPaths) {
-  std::vector<::rust::String> path_strings;
-  std::vector<::rust::Str> path_strs;
-  for (const auto& path : additionalDataPaths) {
-    path_strings.push_back(path.u8string());
-    path_strs.push_back(path_strings.back());
+  const auto pathStrings = asUtf8Strings(additionalDataPaths);
+  const auto pathStrs = asStrRefs(pathStrings);
+
+  try {
+    game_->set_additional_data_paths(::rust::Slice(pathStrs));
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
   }
+}
+
+void Game::SetAdditionalDataPathsUtf8(
+    const std::vector<std::string_view>& additionalDataPaths) {
+  const auto pathStrs = asStrRefs(additionalDataPaths);
+
   try {
-    game_->set_additional_data_paths(
-        ::rust::Slice<const ::rust::Str>(path_strs));
+    game_->set_additional_data_paths(::rust::Slice(pathStrs));
   } catch (const ::rust::Error& e) {
     std::rethrow_exception(mapError(e));
   }
@@ -151,22 +284,35 @@ bool Game::IsValidPlugin(const std::filesystem::path& pluginPath) const {
 
 void Game::LoadPlugins(const std::vector<std::filesystem::path>& pluginPaths,
                        bool loadHeadersOnly) {
-  std::vector<::rust::String> path_strings;
-  std::vector<::rust::Str> path_strs;
-  for (const auto& path : pluginPaths) {
-    path_strings.push_back(path.u8string());
-    path_strs.push_back(path_strings.back());
-  }
+  const auto pathStrings = asUtf8Strings(pluginPaths);
 
-  try {
-    if (loadHeadersOnly) {
-      game_->load_plugin_headers(::rust::Slice<const ::rust::Str>(path_strs));
-    } else {
-      game_->load_plugins(::rust::Slice<const ::rust::Str>(path_strs));
-    }
-  } catch (const ::rust::Error& e) {
-    std::rethrow_exception(mapError(e));
-  }
+  loadPlugins(*game_, asStrRefs(pathStrings), loadHeadersOnly);
+}
+
+void Game::LoadPluginsUtf8(const std::vector<std::string_view>& pluginPaths,
+                           bool loadHeadersOnly) {
+  loadPlugins(*game_, asStrRefs(pluginPaths), loadHeadersOnly);
+}
+
+std::future<void> Game::LoadPluginsAsync(
+    const std::vector<std::filesystem::path>& pluginPaths,
+    bool loadHeadersOnly,
+    const CancellationToken& cancellationToken) {
+  // The token is copied so that its shared state outlives the caller's copy.
+  // The call runs on its own thread rather than on a thread in the Rust
+  // thread pool, as it blocks while it waits for the work that it spreads
+  // across that pool.
+  return std::async(std::launch::async,
+                    [this,
+                     pathStrings = asUtf8Strings(pluginPaths),
+                     loadHeadersOnly,
+                     cancellationToken]() {
+                      loadPlugins(*game_,
+                                  asStrRefs(pathStrings),
+                                  loadHeadersOnly,
+                                  CancellationTokenAccess::getToken(
+                                      cancellationToken));
+                    });
 }
 
 void Game::ClearLoadedPlugins() { game_->clear_loaded_plugins(); }
@@ -199,15 +345,31 @@ std::vector<std::unique_ptr<const PluginInterface>> Game::GetLoadedPlugins()
 
 std::vector<std::string> Game::SortPlugins(
     const std::vector<std::string>& pluginFilenames) {
-  const auto strs = asStrRefs(pluginFilenames);
+  return sortPlugins(*game_, asStrRefs(pluginFilenames));
+}
 
-  try {
-    const auto results = game_->sort_plugins(::rust::Slice(strs));
+std::vector<std::string> Game::SortPluginsUtf8(
+    const std::vector<std::string_view>& pluginFilenames) {
+  return sortPlugins(*game_, asStrRefs(pluginFilenames));
+}
 
-    return convert<std::string>(results);
-  } catch (const ::rust::Error& e) {
-    std::rethrow_exception(mapError(e));
-  }
+std::future<std::vector<std::string>> Game::SortPluginsAsync(
+    const std::vector<std::string>& pluginFilenames,
+    const CancellationToken& cancellationToken) {
+  return std::async(
+      std::launch::async, [this, pluginFilenames, cancellationToken]() {
+        return sortPlugins(*game_,
+                           asStrRefs(pluginFilenames),
+                           CancellationTokenAccess::getToken(
+                               cancellationToken));
+      });
+}
+
+void Game::SetProgressCallback(
+    std::function<void(ProgressPhase, size_t, size_t)> callback) {
+  progressCallback_ = std::move(callback);
+  libloot_game_set_progress_callback(
+      &*game_, progressCallback, &progressCallback_);
 }
 
 void Game::LoadCurrentLoadOrderState() {
@@ -243,12 +405,10 @@ std::vector<std::string> Game::GetLoadOrder() const {
 }
 
 void Game::SetLoadOrder(const std::vector<std::string>& loadOrder) {
-  const auto strs = asStrRefs(loadOrder);
+  setLoadOrder(*game_, asStrRefs(loadOrder));
+}
 
-  try {
-    game_->set_load_order(::rust::Slice(strs));
-  } catch (const ::rust::Error& e) {
-    std::rethrow_exception(mapError(e));
-  }
+void Game::SetLoadOrderUtf8(const std::vector<std::string_view>& loadOrder) {
+  setLoadOrder(*game_, asStrRefs(loadOrder));
 }
 }
@@ -1,6 +1,8 @@
 #ifndef LOOT_API_GAME
 #define LOOT_API_GAME
 
+#include <functional>
+#include <future>
 #include <map>
 #include <mutex>
 
@@ -25,14 +27,27 @@ public:
   void SetAdditionalDataPaths(
       const std::vector<std::filesystem::path>& additionalDataPaths) override;
 
+  void SetAdditionalDataPathsUtf8(
+      const std::vector<std::string_view>& additionalDataPaths) override;
+
   DatabaseInterface& GetDatabase() override;
   const DatabaseInterface& GetDatabase() const override;
 
+  std::shared_ptr<const GameSnapshotInterface> Snapshot() const override;
+
   bool IsValidPlugin(const std::filesystem::path& pluginPath) const override;
 
   void LoadPlugins(const std::vector<std::filesystem::path>& pluginPaths,
                    bool loadHeadersOnly) override;
 
+  void LoadPluginsUtf8(const std::vector<std::string_view>& pluginPaths,
+                       bool loadHeadersOnly) override;
+
+  std::future<void> LoadPluginsAsync(
+      const std::vector<std::filesystem::path>& pluginPaths,
+      bool loadHeadersOnly,
+      const CancellationToken& cancellationToken) override;
+
   void ClearLoadedPlugins() override;
 
   std::unique_ptr<const PluginInterface> GetPlugin(
@@ -44,6 +59,16 @@ public:
   std::vector<std::string> SortPlugins(
       const std::vector<std::string>& pluginFilenames) override;
 
+  std::vector<std::string> SortPluginsUtf8(
+      const std::vector<std::string_view>& pluginFilenames) override;
+
+  std::future<std::vector<std::string>> SortPluginsAsync(
+      const std::vector<std::string>& pluginFilenames,
+      const CancellationToken& cancellationToken) override;
+
+  void SetProgressCallback(
+      std::function<void(ProgressPhase, size_t, size_t)> callback) override;
+
   void LoadCurrentLoadOrderState() override;
 
   bool IsLoadOrderAmbiguous() const override;
@@ -56,9 +81,13 @@ public:
 
   void SetLoadOrder(const std::vector<std::string>& loadOrder) override;
 
+  void SetLoadOrderUtf8(
+      const std::vector<std::string_view>& loadOrder) override;
+
 private:
   ::rust::Box<loot::rust::Game> game_;
   Database database_;
+  std::function<void(ProgressPhase, size_t, size_t)> progressCallback_;
 };
 }
 
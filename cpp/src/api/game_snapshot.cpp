@@ -0,0 +1,88 @@
+#include "api/game_snapshot.h"
+
+#include "api/convert.h"
+#include "api/exception/exception.h"
+#include "api/plugin.h"
+
+namespace loot {
+GameSnapshot::GameSnapshot(::rust::Box<loot::rust::GameSnapshot> snapshot) :
+    snapshot_(std::move(snapshot)) {}
+
+GameType GameSnapshot::GetType() const {
+  try {
+    return convert(snapshot_->game_type());
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
+std::unique_ptr<const PluginInterface> GameSnapshot::GetPlugin(
+    std::string_view pluginName) const {
+  const auto pluginOpt = snapshot_->plugin(convert(pluginName));
+  if (!pluginOpt->is_some()) {
+    return nullptr;
+  }
+
+  try {
+    return std::make_unique<Plugin>(
+        std::move(pluginOpt->as_ref().boxed_clone()));
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
+std::vector<std::unique_ptr<const PluginInterface>>
+GameSnapshot::GetLoadedPlugins() const {
+  std::vector<std::unique_ptr<const PluginInterface>> plugins;
+  for (const auto& pluginRef : snapshot_->loaded_plugins()) {
+    plugins.push_back(
+        std::make_unique<Plugin>(std::move(pluginRef.boxed_clone())));
+  }
+
+  return plugins;
+}
+
+bool GameSnapshot::IsPluginActive(const std::string& pluginName) const {
+  return snapshot_->is_plugin_active(pluginName);
+}
+
+std::vector<std::string> GameSnapshot::GetLoadOrder() const {
+  return convert<std::string>(snapshot_->load_order());
+}
+
+bool GameSnapshot::Evaluate(const std::string& condition) const {
+  try {
+    return snapshot_->evaluate(condition);
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
+std::vector<Message> GameSnapshot::GetGeneralMessages(
+    bool includeUserMetadata,
+    bool evaluateConditions) const {
+  try {
+    return convert<Message>(
+        snapshot_->general_messages(includeUserMetadata, evaluateConditions));
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+
+std::optional<PluginMetadata> GameSnapshot::GetPluginMetadata(
+    std::string_view plugin,
+    bool includeUserMetadata,
+    bool evaluateConditions) const {
+  try {
+    const auto metadata = snapshot_->plugin_metadata(
+        convert(plugin), includeUserMetadata, evaluateConditions);
+    if (metadata->is_some()) {
+      return convert(metadata->as_ref());
+    } else {
+      return std::nullopt;
+    }
+  } catch (const ::rust::Error& e) {
+    std::rethrow_exception(mapError(e));
+  }
+}
+}
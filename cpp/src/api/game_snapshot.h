@@ -0,0 +1,41 @@
+#ifndef LOOT_API_GAME_SNAPSHOT
+#define LOOT_API_GAME_SNAPSHOT
+
+#include "libloot-cpp/src/lib.rs.h"
+#include "loot/game_snapshot_interface.h"
+#include "rust/cxx.h"
+
+namespace loot {
+class GameSnapshot final : public GameSnapshotInterface {
+public:
+  explicit GameSnapshot(::rust::Box<loot::rust::GameSnapshot> snapshot);
+
+  GameType GetType() const override;
+
+  std::unique_ptr<const PluginInterface> GetPlugin(
+      std::string_view pluginName) const override;
+
+  std::vector<std::unique_ptr<const PluginInterface>> GetLoadedPlugins()
+      const override;
+
+  bool IsPluginActive(const std::string& pluginName) const override;
+
+  std::vector<std::string> GetLoadOrder() const override;
+
+  bool Evaluate(const std::string& condition) const override;
+
+  std::vector<Message> GetGeneralMessages(
+      bool includeUserMetadata,
+      bool evaluateConditions) const override;
+
+  std::optional<PluginMetadata> GetPluginMetadata(
+      std::string_view plugin,
+      bool includeUserMetadata,
+      bool evaluateConditions) const override;
+
+private:
+  ::rust::Box<loot::rust::GameSnapshot> snapshot_;
+};
+}
+
+#endif
@@ -24,27 +24,29 @@
 
 #include "loot/metadata/file.h"
 
+#include <utility>
+
 namespace loot {
 File::File(std::string_view name,
            std::string_view display,
            std::string_view condition,
-           const std::vector<MessageContent>& detail,
+           std::vector<MessageContent> detail,
            std::string_view constraint) :
     name_(Filename(name)),
     display_(display),
-    detail_(detail),
+    detail_(std::move(detail)),
     condition_(condition),
     constraint_(constraint) {}
 
-Filename File::GetName() const { return name_; }
+const Filename& File::GetName() const { return name_; }
 
-std::string File::GetDisplayName() const { return display_; }
+const std::string& File::GetDisplayName() const { return display_; }
 
-std::vector<MessageContent> File::GetDetail() const { return detail_; }
+const std::vector<MessageContent>& File::GetDetail() const { return detail_; }
 
-std::string File::GetCondition() const { return condition_; }
+const std::string& File::GetCondition() const { return condition_; }
 
-std::string File::GetConstraint() const { return constraint_; }
+const std::string& File::GetConstraint() const { return constraint_; }
 
 bool operator==(const File& lhs, const File& rhs) {
   return lhs.GetDisplayName() == rhs.GetDisplayName() &&
@@ -24,17 +24,23 @@
 
 #include "loot/metadata/group.h"
 
+#include <utility>
+
 namespace loot {
 Group::Group(std::string_view name,
-             const std::vector<std::string>& afterGroups,
+             std::vector<std::string> afterGroups,
              std::string_view description) :
-    name_(name), description_(description), afterGroups_(afterGroups) {}
+    name_(name),
+    description_(description),
+    afterGroups_(std::move(afterGroups)) {}
 
-std::string Group::GetName() const { return name_; }
+const std::string& Group::GetName() const { return name_; }
 
-std::string Group::GetDescription() const { return description_; }
+const std::string& Group::GetDescription() const { return description_; }
 
-std::vector<std::string> Group::GetAfterGroups() const { return afterGroups_; }
+const std::vector<std::string>& Group::GetAfterGroups() const {
+  return afterGroups_;
+}
 
 bool operator==(const Group& lhs, const Group& rhs) {
   return lhs.GetName() == rhs.GetName() &&
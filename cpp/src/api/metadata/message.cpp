@@ -25,6 +25,7 @@
 #include "loot/metadata/message.h"
 
 #include <stdexcept>
+#include <utility>
 
 namespace loot {
 Message::Message(const MessageType type,
@@ -33,12 +34,12 @@ Message::Message(const MessageType type,
     type_(type), content_({MessageContent(content)}), condition_(condition) {}
 
 Message::Message(const MessageType type,
-                 const std::vector<MessageContent>& content,
+                 std::vector<MessageContent> content,
                  std::string_view condition) :
-    type_(type), content_(content), condition_(condition) {
-  if (content.size() > 1) {
+    type_(type), content_(std::move(content)), condition_(condition) {
+  if (content_.size() > 1) {
     bool englishStringExists = false;
-    for (const auto& mc : content) {
+    for (const auto& mc : content_) {
       if (mc.GetLanguage() == MessageContent::DEFAULT_LANGUAGE)
         englishStringExists = true;
     }
@@ -51,9 +52,11 @@ Message::Message(const MessageType type,
 
 MessageType Message::GetType() const { return type_; }
 
-std::vector<MessageContent> Message::GetContent() const { return content_; }
+const std::vector<MessageContent>& Message::GetContent() const {
+  return content_;
+}
 
-std::string Message::GetCondition() const { return condition_; }
+const std::string& Message::GetCondition() const { return condition_; }
 
 bool operator==(const Message& lhs, const Message& rhs) {
   return lhs.GetType() == rhs.GetType() &&
@@ -24,6 +24,8 @@
 
 #include "loot/metadata/plugin_cleaning_data.h"
 
+#include <utility>
+
 namespace loot {
 PluginCleaningData::PluginCleaningData(uint32_t crc, std::string_view utility) :
     crc_(crc), utility_(utility) {}
@@ -31,7 +33,7 @@ PluginCleaningData::PluginCleaningData(uint32_t crc, std::string_view utility) :
 PluginCleaningData::PluginCleaningData(
     uint32_t crc,
     std::string_view utility,
-    const std::vector<MessageContent>& detail,
+    std::vector<MessageContent> detail,
     unsigned int itm,
     unsigned int ref,
     unsigned int nav,
@@ -41,7 +43,7 @@ PluginCleaningData::PluginCleaningData(
     ref_(ref),
     nav_(nav),
     utility_(utility),
-    detail_(detail),
+    detail_(std::move(detail)),
     condition_(condition) {}
 
 uint32_t PluginCleaningData::GetCRC() const { return crc_; }
@@ -54,13 +56,17 @@ unsigned int PluginCleaningData::GetDeletedReferenceCount() const {
 
 unsigned int PluginCleaningData::GetDeletedNavmeshCount() const { return nav_; }
 
-std::string PluginCleaningData::GetCleaningUtility() const { return utility_; }
+const std::string& PluginCleaningData::GetCleaningUtility() const {
+  return utility_;
+}
 
-std::vector<MessageContent> PluginCleaningData::GetDetail() const {
+const std::vector<MessageContent>& PluginCleaningData::GetDetail() const {
   return detail_;
 }
 
-std::string PluginCleaningData::GetCondition() const { return condition_; }
+const std::string& PluginCleaningData::GetCondition() const {
+  return condition_;
+}
 
 bool operator==(const PluginCleaningData& lhs, const PluginCleaningData& rhs) {
   return lhs.GetCRC() == rhs.GetCRC() &&
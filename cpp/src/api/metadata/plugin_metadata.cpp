@@ -24,6 +24,7 @@
 
 #include "loot/metadata/plugin_metadata.h"
 
+#include <algorithm>
 #include <cstring>
 #include <regex>
 #include <stdexcept>
@@ -36,19 +37,26 @@ namespace {
 // Append second to first, skipping any elements that are already present in
 // first. Although this is O(U * M), both input vectors are expected to be
 // small (with tens of elements being an unusually large number).
+//
+// Unlike the metadata merged by the Rust library, these objects own copies of
+// their strings, so elements can only be compared by value.
 template<typename T>
-std::vector<T> mergeVectors(std::vector<T> first,
-                            const std::vector<T>& second) {
-  const auto initialSizeOfFirst = first.end() - first.begin();
+void mergeVectors(std::vector<T>& first, const std::vector<T>& second) {
+  if (second.empty()) {
+    return;
+  }
+
+  const auto initialSizeOfFirst = first.size();
+  first.reserve(initialSizeOfFirst + second.size());
+
   for (const auto& element : second) {
-    const auto end = first.cbegin() + initialSizeOfFirst;
+    const auto begin = first.cbegin();
+    const auto end = begin + static_cast<std::ptrdiff_t>(initialSizeOfFirst);
 
-    if (std::find(first.cbegin(), end, element) == end) {
+    if (std::find(begin, end, element) == end) {
       first.push_back(element);
     }
   }
-
-  return first;
 }
 
 std::string trimDotGhostExtension(std::string&& filename) {
@@ -87,57 +95,60 @@ void PluginMetadata::MergeMetadata(const PluginMetadata& plugin) {
   if (plugin.HasNameOnly())
     return;
 
-  if (!group_.has_value() && plugin.GetGroup()) {
-    group_ = plugin.GetGroup();
+  if (!group_.has_value() && plugin.group_.has_value()) {
+    group_ = plugin.group_;
   }
 
-  loadAfter_ = mergeVectors(loadAfter_, plugin.loadAfter_);
-  requirements_ = mergeVectors(requirements_, plugin.requirements_);
-  incompatibilities_ =
-      mergeVectors(incompatibilities_, plugin.incompatibilities_);
+  mergeVectors(loadAfter_, plugin.loadAfter_);
+  mergeVectors(requirements_, plugin.requirements_);
+  mergeVectors(incompatibilities_, plugin.incompatibilities_);
 
-  tags_ = mergeVectors(tags_, plugin.tags_);
+  mergeVectors(tags_, plugin.tags_);
 
   // Messages are in an ordered list, and should be fully merged.
   messages_.insert(
       end(messages_), begin(plugin.messages_), end(plugin.messages_));
 
-  dirtyInfo_ = mergeVectors(dirtyInfo_, plugin.dirtyInfo_);
-  cleanInfo_ = mergeVectors(cleanInfo_, plugin.cleanInfo_);
-  locations_ = mergeVectors(locations_, plugin.locations_);
+  mergeVectors(dirtyInfo_, plugin.dirtyInfo_);
+  mergeVectors(cleanInfo_, plugin.cleanInfo_);
+  mergeVectors(locations_, plugin.locations_);
 
   return;
 }
 
-std::string PluginMetadata::GetName() const { return name_; }
+const std::string& PluginMetadata::GetName() const { return name_; }
 
-std::optional<std::string> PluginMetadata::GetGroup() const { return group_; }
+const std::optional<std::string>& PluginMetadata::GetGroup() const {
+  return group_;
+}
 
-std::vector<File> PluginMetadata::GetLoadAfterFiles() const {
+const std::vector<File>& PluginMetadata::GetLoadAfterFiles() const {
   return loadAfter_;
 }
 
-std::vector<File> PluginMetadata::GetRequirements() const {
+const std::vector<File>& PluginMetadata::GetRequirements() const {
   return requirements_;
 }
 
-std::vector<File> PluginMetadata::GetIncompatibilities() const {
+const std::vector<File>& PluginMetadata::GetIncompatibilities() const {
   return incompatibilities_;
 }
 
-std::vector<Message> PluginMetadata::GetMessages() const { return messages_; }
+const std::vector<Message>& PluginMetadata::GetMessages() const {
+  return messages_;
+}
 
-std::vector<Tag> PluginMetadata::GetTags() const { return tags_; }
+const std::vector<Tag>& PluginMetadata::GetTags() const { return tags_; }
 
-std::vector<PluginCleaningData> PluginMetadata::GetDirtyInfo() const {
+const std::vector<PluginCleaningData>& PluginMetadata::GetDirtyInfo() const {
   return dirtyInfo_;
 }
 
-std::vector<PluginCleaningData> PluginMetadata::GetCleanInfo() const {
+const std::vector<PluginCleaningData>& PluginMetadata::GetCleanInfo() const {
   return cleanInfo_;
 }
 
-std::vector<Location> PluginMetadata::GetLocations() const {
+const std::vector<Location>& PluginMetadata::GetLocations() const {
   return locations_;
 }
 
@@ -149,33 +160,63 @@ void PluginMetadata::SetLoadAfterFiles(const std::vector<File>& l) {
   loadAfter_ = l;
 }
 
+void PluginMetadata::SetLoadAfterFiles(std::vector<File>&& l) {
+  loadAfter_ = std::move(l);
+}
+
 void PluginMetadata::SetRequirements(const std::vector<File>& r) {
   requirements_ = r;
 }
 
+void PluginMetadata::SetRequirements(std::vector<File>&& r) {
+  requirements_ = std::move(r);
+}
+
 void PluginMetadata::SetIncompatibilities(const std::vector<File>& i) {
   incompatibilities_ = i;
 }
 
+void PluginMetadata::SetIncompatibilities(std::vector<File>&& i) {
+  incompatibilities_ = std::move(i);
+}
+
 void PluginMetadata::SetMessages(const std::vector<Message>& m) {
   messages_ = m;
 }
 
+void PluginMetadata::SetMessages(std::vector<Message>&& m) {
+  messages_ = std::move(m);
+}
+
 void PluginMetadata::SetTags(const std::vector<Tag>& t) { tags_ = t; }
 
+void PluginMetadata::SetTags(std::vector<Tag>&& t) { tags_ = std::move(t); }
+
 void PluginMetadata::SetDirtyInfo(
     const std::vector<PluginCleaningData>& dirtyInfo) {
   dirtyInfo_ = dirtyInfo;
 }
 
+void PluginMetadata::SetDirtyInfo(std::vector<PluginCleaningData>&& dirtyInfo) {
+  dirtyInfo_ = std::move(dirtyInfo);
+}
+
 void PluginMetadata::SetCleanInfo(const std::vector<PluginCleaningData>& info) {
   cleanInfo_ = info;
 }
 
+void PluginMetadata::SetCleanInfo(std::vector<PluginCleaningData>&& info) {
+  cleanInfo_ = std::move(info);
+}
+
 void PluginMetadata::SetLocations(const std::vector<Location>& locations) {
   locations_ = locations;
 }
 
+void PluginMetadata::SetLocations(std::vector<Location>&& locations) {
+  locations_ = std::move(locations);
+}
+
 bool PluginMetadata::HasNameOnly() const {
   return !group_.has_value() && loadAfter_.empty() && requirements_.empty() &&
          incompatibilities_.empty() && messages_.empty() && tags_.empty() &&
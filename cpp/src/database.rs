@@ -4,12 +4,15 @@ use std::{
 };
 
 use delegate::delegate;
-use libloot::{EvalMode, MergeMode, error::DatabaseLockPoisonError};
+use libloot::{
+    EvalMode, LoadedMetadata, MergeMode, MetadataChanges, error::DatabaseLockPoisonError,
+    metadata::error::LoadMetadataError,
+};
 use libloot_ffi_errors::UnsupportedEnumValueError;
 
 use crate::{
     OptionalPluginMetadata, VerboseError,
-    ffi::{EdgeType, MetadataWriteOptionsImpl},
+    ffi::{ConditionCacheStatsImpl, EdgeType, MetadataChangesImpl, MetadataWriteOptionsImpl},
     metadata::{Group, Message, PluginMetadata, to_vec_of_unwrapped},
 };
 
@@ -23,11 +26,15 @@ impl Database {
     }
 
     pub fn load_masterlist(&self, path: &str) -> Result<(), VerboseError> {
+        // Load the masterlist before taking the lock to avoid blocking readers
+        // while it's parsed.
+        let masterlist = LoadedMetadata::load_masterlist(Path::new(path))?;
+
         self.0
             .write()
             .map_err(DatabaseLockPoisonError::from)?
-            .load_masterlist(Path::new(path))
-            .map_err(Into::into)
+            .set_masterlist(masterlist);
+        Ok(())
     }
 
     pub fn load_masterlist_with_prelude(
@@ -35,19 +42,85 @@ impl Database {
         masterlist_path: &str,
         prelude_path: &str,
     ) -> Result<(), VerboseError> {
+        let masterlist = LoadedMetadata::load_masterlist_with_prelude(
+            Path::new(masterlist_path),
+            Path::new(prelude_path),
+        )?;
+
         self.0
             .write()
             .map_err(DatabaseLockPoisonError::from)?
-            .load_masterlist_with_prelude(Path::new(masterlist_path), Path::new(prelude_path))
-            .map_err(Into::into)
+            .set_masterlist(masterlist);
+        Ok(())
+    }
+
+    pub fn reload_masterlist(&self, path: &str) -> Result<MetadataChangesImpl, VerboseError> {
+        let path = Path::new(path);
+
+        self.reload_masterlist_using(
+            |previous| LoadedMetadata::reload_masterlist(path, previous),
+            |database| database.reload_masterlist(path),
+        )
+    }
+
+    pub fn reload_masterlist_with_prelude(
+        &self,
+        masterlist_path: &str,
+        prelude_path: &str,
+    ) -> Result<MetadataChangesImpl, VerboseError> {
+        let masterlist_path = Path::new(masterlist_path);
+        let prelude_path = Path::new(prelude_path);
+
+        self.reload_masterlist_using(
+            |previous| {
+                LoadedMetadata::reload_masterlist_with_prelude(
+                    masterlist_path,
+                    prelude_path,
+                    previous,
+                )
+            },
+            |database| database.reload_masterlist_with_prelude(masterlist_path, prelude_path),
+        )
+    }
+
+    fn reload_masterlist_using<R, L>(
+        &self,
+        reload: R,
+        reload_locked: L,
+    ) -> Result<MetadataChangesImpl, VerboseError>
+    where
+        R: FnOnce(&LoadedMetadata) -> Result<(LoadedMetadata, MetadataChanges), LoadMetadataError>,
+        L: FnOnce(&mut libloot::Database) -> Result<MetadataChanges, LoadMetadataError>,
+    {
+        // Reload the masterlist without holding the lock to avoid blocking
+        // readers while it's parsed and compared with the loaded masterlist.
+        let previous = self
+            .0
+            .read()
+            .map_err(DatabaseLockPoisonError::from)?
+            .loaded_masterlist();
+
+        let (masterlist, changes) = reload(&previous)?;
+
+        let mut database = self.0.write().map_err(DatabaseLockPoisonError::from)?;
+        if database.replace_masterlist(&previous, masterlist) {
+            Ok(changes.into())
+        } else {
+            // The masterlist was replaced while it was being reloaded, so the
+            // changes are relative to the wrong masterlist. Reload it again
+            // while holding the lock so that this can't happen again.
+            Ok(reload_locked(&mut database)?.into())
+        }
     }
 
     pub fn load_userlist(&self, path: &str) -> Result<(), VerboseError> {
+        let userlist = LoadedMetadata::load(Path::new(path))?;
+
         self.0
             .write()
             .map_err(DatabaseLockPoisonError::from)?
-            .load_userlist(Path::new(path))
-            .map_err(Into::into)
+            .set_userlist(userlist);
+        Ok(())
     }
 
     pub fn write_user_metadata(
@@ -62,6 +135,18 @@ impl Database {
             .map_err(Into::into)
     }
 
+    pub fn write_user_metadata_changes(
+        &self,
+        userlist_path: &str,
+        options: MetadataWriteOptionsImpl,
+    ) -> Result<(), VerboseError> {
+        self.0
+            .write()
+            .map_err(DatabaseLockPoisonError::from)?
+            .write_user_metadata_changes(Path::new(userlist_path), &options.into())
+            .map_err(Into::into)
+    }
+
     pub fn write_minimal_list(
         &self,
         output_path: &str,
@@ -82,6 +167,14 @@ impl Database {
             .map_err(Into::into)
     }
 
+    pub fn evaluate_many(&self, conditions: &[&str]) -> Result<Vec<bool>, VerboseError> {
+        self.0
+            .read()
+            .map_err(DatabaseLockPoisonError::from)?
+            .evaluate_many(conditions)
+            .map_err(Into::into)
+    }
+
     pub fn clear_condition_cache(&self) -> Result<(), VerboseError> {
         self.0
             .write()
@@ -91,6 +184,20 @@ impl Database {
         Ok(())
     }
 
+    pub fn condition_cache_stats(&self) -> Result<ConditionCacheStatsImpl, VerboseError> {
+        let stats = self
+            .0
+            .read()
+            .map_err(DatabaseLockPoisonError::from)?
+            .condition_cache_stats();
+
+        Ok(ConditionCacheStatsImpl {
+            hits: stats.hits(),
+            misses: stats.misses(),
+            invalidations: stats.invalidations(),
+        })
+    }
+
     pub fn known_bash_tags(
         &self,
         include_user_metadata: bool,
@@ -136,6 +243,24 @@ impl Database {
             .map_err(Into::into)
     }
 
+    pub fn localised_general_messages(
+        &self,
+        language: &str,
+        include_user_metadata: bool,
+        evaluate_conditions: bool,
+    ) -> Result<Vec<Message>, VerboseError> {
+        self.0
+            .read()
+            .map_err(DatabaseLockPoisonError::from)?
+            .localised_general_messages(
+                language,
+                to_merge_mode(include_user_metadata),
+                to_eval_mode(evaluate_conditions),
+            )
+            .map(|v| v.into_iter().map(Into::into).collect())
+            .map_err(Into::into)
+    }
+
     pub fn user_general_messages(
         &self,
         evaluate_conditions: bool,
@@ -234,6 +359,68 @@ impl Database {
             .map_err(Into::into)
     }
 
+    pub fn localised_plugin_metadata(
+        &self,
+        plugin_name: &str,
+        language: &str,
+        include_user_metadata: bool,
+        evaluate_conditions: bool,
+    ) -> Result<Box<OptionalPluginMetadata>, VerboseError> {
+        self.0
+            .read()
+            .map_err(DatabaseLockPoisonError::from)?
+            .localised_plugin_metadata(
+                plugin_name,
+                language,
+                to_merge_mode(include_user_metadata),
+                to_eval_mode(evaluate_conditions),
+            )
+            .map(|p| Box::new(p.map(Into::into).into()))
+            .map_err(Into::into)
+    }
+
+    pub fn plugins_metadata(
+        &self,
+        plugin_names: &[&str],
+        include_user_metadata: bool,
+        evaluate_conditions: bool,
+    ) -> Result<Vec<OptionalPluginMetadata>, VerboseError> {
+        self.0
+            .read()
+            .map_err(DatabaseLockPoisonError::from)?
+            .plugins_metadata(
+                plugin_names,
+                to_merge_mode(include_user_metadata),
+                to_eval_mode(evaluate_conditions),
+            )
+            .map(|m| m.into_iter().map(|p| p.map(Into::into).into()).collect())
+            .map_err(Into::into)
+    }
+
+    pub fn plugins_referencing(
+        &self,
+        filename: &str,
+        include_user_metadata: bool,
+    ) -> Result<Vec<String>, VerboseError> {
+        Ok(self
+            .0
+            .read()
+            .map_err(DatabaseLockPoisonError::from)?
+            .plugins_referencing(filename, to_merge_mode(include_user_metadata)))
+    }
+
+    pub fn plugins_in_group(
+        &self,
+        group_name: &str,
+        include_user_metadata: bool,
+    ) -> Result<Vec<String>, VerboseError> {
+        Ok(self
+            .0
+            .read()
+            .map_err(DatabaseLockPoisonError::from)?
+            .plugins_in_group(group_name, to_merge_mode(include_user_metadata)))
+    }
+
     pub fn plugin_user_metadata(
         &self,
         plugin_name: &str,
@@ -275,7 +462,7 @@ impl Database {
     }
 }
 
-fn to_eval_mode(value: bool) -> EvalMode {
+pub fn to_eval_mode(value: bool) -> EvalMode {
     if value {
         EvalMode::Evaluate
     } else {
@@ -283,7 +470,7 @@ fn to_eval_mode(value: bool) -> EvalMode {
     }
 }
 
-fn to_merge_mode(value: bool) -> MergeMode {
+pub fn to_merge_mode(value: bool) -> MergeMode {
     if value {
         MergeMode::WithUserMetadata
     } else {
@@ -376,3 +563,14 @@ impl TryFrom<EdgeType> for libloot::EdgeType {
         }
     }
 }
+
+impl From<MetadataChanges> for MetadataChangesImpl {
+    fn from(value: MetadataChanges) -> Self {
+        Self {
+            bash_tags_changed: value.bash_tags_changed(),
+            groups_changed: value.groups_changed(),
+            messages_changed: value.messages_changed(),
+            changed_plugins: value.changed_plugins().to_vec(),
+        }
+    }
+}
@@ -17,6 +17,7 @@ pub enum VerboseError {
     CyclicInteractionError(Vec<libloot::Vertex>),
     UndefinedGroupError(String),
     PluginNotLoadedError(String),
+    OperationCancelled(Box<dyn std::error::Error>),
     InvalidArgument(Box<dyn std::error::Error>),
     Other(Box<dyn std::error::Error>),
 }
@@ -39,6 +40,10 @@ impl std::fmt::Display for VerboseError {
                 write!(f, "UndefinedGroupError: {group}")
             }
             Self::PluginNotLoadedError(plugin) => write!(f, "PluginNotLoadedError: {plugin}"),
+            Self::OperationCancelled(e) => {
+                write!(f, "OperationCancelledError: ")?;
+                fmt_error_chain(e.as_ref(), f)
+            }
             Self::InvalidArgument(e) => {
                 write!(f, "InvalidArgument: ")?;
                 fmt_error_chain(e.as_ref(), f)
@@ -75,6 +80,7 @@ impl From<LoadPluginsError> for VerboseError {
         match value {
             LoadPluginsError::PluginNotLoaded(p) => Self::PluginNotLoadedError(p),
             LoadPluginsError::PluginValidationError(_) => Self::InvalidArgument(Box::new(value)),
+            LoadPluginsError::Cancelled => Self::OperationCancelled(Box::new(value)),
             LoadPluginsError::DatabaseLockPoisoned
             | LoadPluginsError::IoError(_)
             | LoadPluginsError::PluginDataError(_)
@@ -89,6 +95,7 @@ impl From<SortPluginsError> for VerboseError {
             SortPluginsError::UndefinedGroup(g) => Self::UndefinedGroupError(g),
             SortPluginsError::CycleFound(cycle) => Self::CyclicInteractionError(cycle),
             SortPluginsError::PluginNotLoaded(p) => Self::PluginNotLoadedError(p),
+            SortPluginsError::Cancelled => Self::OperationCancelled(Box::new(value)),
             SortPluginsError::DatabaseLockPoisoned
             | SortPluginsError::CycleFoundInvolving(_)
             | SortPluginsError::PathfindingError(_)
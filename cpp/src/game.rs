@@ -3,7 +3,12 @@ use std::path::Path;
 use delegate::delegate;
 use libloot_ffi_errors::UnsupportedEnumValueError;
 
-use crate::{OptionalPlugin, Plugin, VerboseError, database::Database, ffi::GameType};
+use crate::{
+    OptionalPlugin, OptionalPluginMetadata, Plugin, VerboseError,
+    database::{Database, to_eval_mode, to_merge_mode},
+    ffi::GameType,
+    metadata::Message,
+};
 
 impl TryFrom<libloot::GameType> for GameType {
     type Error = UnsupportedEnumValueError;
@@ -76,6 +81,96 @@ impl std::error::Error for NotValidUtf8 {}
 #[repr(transparent)]
 pub struct Game(libloot::Game);
 
+#[derive(Debug)]
+#[repr(transparent)]
+pub struct CancellationToken(libloot::CancellationToken);
+
+pub fn new_cancellation_token() -> Box<CancellationToken> {
+    Box::new(CancellationToken(libloot::CancellationToken::new()))
+}
+
+impl CancellationToken {
+    delegate! {
+        to self.0 {
+            pub fn cancel(&self);
+
+            pub fn is_cancelled(&self) -> bool;
+        }
+    }
+}
+
+#[derive(Debug)]
+#[repr(transparent)]
+pub struct GameSnapshot(libloot::GameSnapshot);
+
+impl GameSnapshot {
+    pub fn game_type(&self) -> Result<GameType, VerboseError> {
+        self.0.game_type().try_into().map_err(Into::into)
+    }
+
+    pub fn plugin(&self, plugin_name: &str) -> Box<OptionalPlugin> {
+        Box::new(self.0.plugin(plugin_name).map(Into::into).into())
+    }
+
+    pub fn loaded_plugins(&self) -> Vec<Plugin> {
+        self.0
+            .loaded_plugins()
+            .into_iter()
+            .map(Into::into)
+            .collect()
+    }
+
+    pub fn load_order(&self) -> Vec<String> {
+        self.0
+            .load_order()
+            .iter()
+            .map(ToString::to_string)
+            .collect()
+    }
+
+    pub fn evaluate(&self, condition: &str) -> Result<bool, VerboseError> {
+        self.0.database().evaluate(condition).map_err(Into::into)
+    }
+
+    pub fn general_messages(
+        &self,
+        include_user_metadata: bool,
+        evaluate_conditions: bool,
+    ) -> Result<Vec<Message>, VerboseError> {
+        self.0
+            .database()
+            .general_messages(
+                to_merge_mode(include_user_metadata),
+                to_eval_mode(evaluate_conditions),
+            )
+            .map(|v| v.into_iter().map(Into::into).collect())
+            .map_err(Into::into)
+    }
+
+    pub fn plugin_metadata(
+        &self,
+        plugin_name: &str,
+        include_user_metadata: bool,
+        evaluate_conditions: bool,
+    ) -> Result<Box<OptionalPluginMetadata>, VerboseError> {
+        self.0
+            .database()
+            .plugin_metadata(
+                plugin_name,
+                to_merge_mode(include_user_metadata),
+                to_eval_mode(evaluate_conditions),
+            )
+            .map(|p| Box::new(p.map(Into::into).into()))
+            .map_err(Into::into)
+    }
+
+    delegate! {
+        to self.0 {
+            pub fn is_plugin_active(&self, plugin_name: &str) -> bool;
+        }
+    }
+}
+
 // CXX doesn't support &Path so use &str instead.
 pub fn new_game(game_type: GameType, game_path: &str) -> Result<Box<Game>, VerboseError> {
     libloot::Game::new(game_type.try_into()?, Path::new(game_path))
@@ -133,6 +228,10 @@ impl Game {
         Box::new(Database::new(self.0.database()))
     }
 
+    pub fn snapshot(&self) -> Result<Box<GameSnapshot>, VerboseError> {
+        Ok(Box::new(GameSnapshot(self.0.snapshot()?)))
+    }
+
     pub fn is_valid_plugin(&self, plugin_path: &str) -> bool {
         self.0.is_valid_plugin(Path::new(plugin_path))
     }
@@ -149,6 +248,26 @@ impl Game {
             .map_err(Into::into)
     }
 
+    pub fn load_plugins_with_cancellation(
+        &mut self,
+        plugin_paths: &[&str],
+        cancellation: &CancellationToken,
+    ) -> Result<(), VerboseError> {
+        self.0
+            .load_plugins_with_cancellation(&strings_to_paths(plugin_paths), &cancellation.0)
+            .map_err(Into::into)
+    }
+
+    pub fn load_plugin_headers_with_cancellation(
+        &mut self,
+        plugin_paths: &[&str],
+        cancellation: &CancellationToken,
+    ) -> Result<(), VerboseError> {
+        self.0
+            .load_plugin_headers_with_cancellation(&strings_to_paths(plugin_paths), &cancellation.0)
+            .map_err(Into::into)
+    }
+
     pub fn plugin(&self, plugin_name: &str) -> Box<OptionalPlugin> {
         Box::new(self.0.plugin(plugin_name).map(Into::into).into())
     }
@@ -165,6 +284,16 @@ impl Game {
         self.0.sort_plugins(plugin_names).map_err(Into::into)
     }
 
+    pub fn sort_plugins_with_cancellation(
+        &self,
+        plugin_names: &[&str],
+        cancellation: &CancellationToken,
+    ) -> Result<Vec<String>, VerboseError> {
+        self.0
+            .sort_plugins_with_cancellation(plugin_names, &cancellation.0)
+            .map_err(Into::into)
+    }
+
     pub fn load_current_load_order_state(&mut self) -> Result<(), VerboseError> {
         self.0.load_current_load_order_state().map_err(Into::into)
     }
@@ -189,6 +318,13 @@ impl Game {
         self.0.set_load_order(load_order).map_err(Into::into)
     }
 
+    pub fn set_progress_callback<T>(&mut self, callback: T)
+    where
+        T: Fn(libloot::ProgressPhase, usize, usize) + Send + Sync + 'static,
+    {
+        self.0.set_progress_callback(callback);
+    }
+
     delegate! {
         to self.0 {
             pub fn clear_loaded_plugins(&mut self);
@@ -18,7 +18,10 @@ mod plugin;
 use database::{Database, Vertex, new_vertex};
 use error::{EmptyOptionalError, VerboseError};
 use ffi::{MetadataWriteOptionsImpl, OptionalMessageContentRef};
-use game::{Game, new_game, new_game_with_local_path};
+use game::{
+    CancellationToken, Game, GameSnapshot, new_cancellation_token, new_game,
+    new_game_with_local_path,
+};
 use libloot_ffi_errors::UnsupportedEnumValueError;
 use metadata::{
     File, Filename, Group, Location, Message, MessageContent, PluginCleaningData, PluginMetadata,
@@ -201,6 +204,21 @@ mod ffi {
         anchor_file_strings: bool,
     }
 
+    #[derive(Debug, Copy, Clone)]
+    struct ConditionCacheStatsImpl {
+        hits: usize,
+        misses: usize,
+        invalidations: usize,
+    }
+
+    #[derive(Debug, Clone)]
+    struct MetadataChangesImpl {
+        bash_tags_changed: bool,
+        groups_changed: bool,
+        messages_changed: bool,
+        changed_plugins: Vec<String>,
+    }
+
     extern "Rust" {
         pub fn is_some(self: &OptionalMessageContentRef) -> bool;
 
@@ -221,6 +239,16 @@ mod ffi {
         ) -> OptionalMessageContentRef;
     }
 
+    extern "Rust" {
+        type CancellationToken;
+
+        fn new_cancellation_token() -> Box<CancellationToken>;
+
+        pub fn cancel(&self);
+
+        pub fn is_cancelled(&self) -> bool;
+    }
+
     extern "Rust" {
         type Game;
 
@@ -240,12 +268,26 @@ mod ffi {
 
         pub fn database(&self) -> Box<Database>;
 
+        pub fn snapshot(&self) -> Result<Box<GameSnapshot>>;
+
         pub fn is_valid_plugin(&self, plugin_path: &str) -> bool;
 
         pub fn load_plugins(&mut self, plugin_paths: &[&str]) -> Result<()>;
 
         pub fn load_plugin_headers(&mut self, plugin_paths: &[&str]) -> Result<()>;
 
+        pub fn load_plugins_with_cancellation(
+            &mut self,
+            plugin_paths: &[&str],
+            cancellation: &CancellationToken,
+        ) -> Result<()>;
+
+        pub fn load_plugin_headers_with_cancellation(
+            &mut self,
+            plugin_paths: &[&str],
+            cancellation: &CancellationToken,
+        ) -> Result<()>;
+
         pub fn clear_loaded_plugins(&mut self);
 
         pub fn plugin(&self, plugin_name: &str) -> Box<OptionalPlugin>;
@@ -254,6 +296,12 @@ mod ffi {
 
         pub fn sort_plugins(&self, plugin_names: &[&str]) -> Result<Vec<String>>;
 
+        pub fn sort_plugins_with_cancellation(
+            &self,
+            plugin_names: &[&str],
+            cancellation: &CancellationToken,
+        ) -> Result<Vec<String>>;
+
         pub fn load_current_load_order_state(&mut self) -> Result<()>;
 
         pub fn is_load_order_ambiguous(&self) -> Result<bool>;
@@ -267,6 +315,35 @@ mod ffi {
         pub fn set_load_order(&mut self, load_order: &[&str]) -> Result<()>;
     }
 
+    extern "Rust" {
+        type GameSnapshot;
+
+        pub fn game_type(&self) -> Result<GameType>;
+
+        pub fn plugin(&self, plugin_name: &str) -> Box<OptionalPlugin>;
+
+        pub fn loaded_plugins(&self) -> Vec<Plugin>;
+
+        pub fn load_order(&self) -> Vec<String>;
+
+        pub fn is_plugin_active(&self, plugin_name: &str) -> bool;
+
+        pub fn evaluate(&self, condition: &str) -> Result<bool>;
+
+        pub fn general_messages(
+            &self,
+            include_user_metadata: bool,
+            evaluate_conditions: bool,
+        ) -> Result<Vec<Message>>;
+
+        pub fn plugin_metadata(
+            &self,
+            plugin_name: &str,
+            include_user_metadata: bool,
+            evaluate_conditions: bool,
+        ) -> Result<Box<OptionalPluginMetadata>>;
+    }
+
     extern "Rust" {
         type Database;
 
@@ -278,6 +355,14 @@ mod ffi {
             prelude_path: &str,
         ) -> Result<()>;
 
+        pub fn reload_masterlist(&self, path: &str) -> Result<MetadataChangesImpl>;
+
+        pub fn reload_masterlist_with_prelude(
+            &self,
+            masterlist_path: &str,
+            prelude_path: &str,
+        ) -> Result<MetadataChangesImpl>;
+
         pub fn load_userlist(&self, path: &str) -> Result<()>;
 
         pub fn write_user_metadata(
@@ -286,6 +371,12 @@ mod ffi {
             options: MetadataWriteOptionsImpl,
         ) -> Result<()>;
 
+        pub fn write_user_metadata_changes(
+            &self,
+            userlist_path: &str,
+            options: MetadataWriteOptionsImpl,
+        ) -> Result<()>;
+
         pub fn write_minimal_list(
             &self,
             output_path: &str,
@@ -294,8 +385,12 @@ mod ffi {
 
         pub fn evaluate(&self, condition: &str) -> Result<bool>;
 
+        pub fn evaluate_many(&self, conditions: &[&str]) -> Result<Vec<bool>>;
+
         pub fn clear_condition_cache(&self) -> Result<()>;
 
+        pub fn condition_cache_stats(&self) -> Result<ConditionCacheStatsImpl>;
+
         pub fn known_bash_tags(&self, include_user_metadata: bool) -> Result<Vec<String>>;
 
         pub fn user_known_bash_tags(&self) -> Result<Vec<String>>;
@@ -308,6 +403,13 @@ mod ffi {
             evaluate_conditions: bool,
         ) -> Result<Vec<Message>>;
 
+        pub fn localised_general_messages(
+            &self,
+            language: &str,
+            include_user_metadata: bool,
+            evaluate_conditions: bool,
+        ) -> Result<Vec<Message>>;
+
         pub fn user_general_messages(&self, evaluate_conditions: bool) -> Result<Vec<Message>>;
 
         pub fn set_user_general_messages(&self, messages: Vec<Box<Message>>) -> Result<()>;
@@ -331,6 +433,33 @@ mod ffi {
             evaluate_conditions: bool,
         ) -> Result<Box<OptionalPluginMetadata>>;
 
+        pub fn localised_plugin_metadata(
+            &self,
+            plugin_name: &str,
+            language: &str,
+            include_user_metadata: bool,
+            evaluate_conditions: bool,
+        ) -> Result<Box<OptionalPluginMetadata>>;
+
+        pub fn plugins_metadata(
+            &self,
+            plugin_names: &[&str],
+            include_user_metadata: bool,
+            evaluate_conditions: bool,
+        ) -> Result<Vec<OptionalPluginMetadata>>;
+
+        pub fn plugins_referencing(
+            &self,
+            filename: &str,
+            include_user_metadata: bool,
+        ) -> Result<Vec<String>>;
+
+        pub fn plugins_in_group(
+            &self,
+            group_name: &str,
+            include_user_metadata: bool,
+        ) -> Result<Vec<String>>;
+
         pub fn plugin_user_metadata(
             &self,
             plugin_name: &str,
@@ -716,3 +845,85 @@ unsafe extern "C" fn libloot_set_logging_callback(
         }
     });
 }
+
+#[unsafe(no_mangle)]
+pub static LIBLOOT_PROGRESS_PHASE_VALIDATING_PATHS: c_uchar = 0;
+
+#[unsafe(no_mangle)]
+pub static LIBLOOT_PROGRESS_PHASE_READING_ARCHIVES: c_uchar = 1;
+
+#[unsafe(no_mangle)]
+pub static LIBLOOT_PROGRESS_PHASE_PARSING_PLUGINS: c_uchar = 2;
+
+#[unsafe(no_mangle)]
+pub static LIBLOOT_PROGRESS_PHASE_PREPARING_SORTING_DATA: c_uchar = 3;
+
+#[unsafe(no_mangle)]
+pub static LIBLOOT_PROGRESS_PHASE_ADDING_SPECIFIC_EDGES: c_uchar = 4;
+
+#[unsafe(no_mangle)]
+pub static LIBLOOT_PROGRESS_PHASE_ADDING_GROUP_EDGES: c_uchar = 5;
+
+#[unsafe(no_mangle)]
+pub static LIBLOOT_PROGRESS_PHASE_ADDING_OVERLAP_EDGES: c_uchar = 6;
+
+#[unsafe(no_mangle)]
+pub static LIBLOOT_PROGRESS_PHASE_ADDING_TIE_BREAK_EDGES: c_uchar = 7;
+
+fn progress_phase_to_u8(value: libloot::ProgressPhase) -> Option<u8> {
+    match value {
+        libloot::ProgressPhase::ValidatingPaths => Some(LIBLOOT_PROGRESS_PHASE_VALIDATING_PATHS),
+        libloot::ProgressPhase::ReadingArchives => Some(LIBLOOT_PROGRESS_PHASE_READING_ARCHIVES),
+        libloot::ProgressPhase::ParsingPlugins => Some(LIBLOOT_PROGRESS_PHASE_PARSING_PLUGINS),
+        libloot::ProgressPhase::PreparingSortingData => {
+            Some(LIBLOOT_PROGRESS_PHASE_PREPARING_SORTING_DATA)
+        }
+        libloot::ProgressPhase::AddingSpecificEdges => {
+            Some(LIBLOOT_PROGRESS_PHASE_ADDING_SPECIFIC_EDGES)
+        }
+        libloot::ProgressPhase::AddingGroupEdges => Some(LIBLOOT_PROGRESS_PHASE_ADDING_GROUP_EDGES),
+        libloot::ProgressPhase::AddingOverlapEdges => {
+            Some(LIBLOOT_PROGRESS_PHASE_ADDING_OVERLAP_EDGES)
+        }
+        libloot::ProgressPhase::AddingTieBreakEdges => {
+            Some(LIBLOOT_PROGRESS_PHASE_ADDING_TIE_BREAK_EDGES)
+        }
+        _ => None,
+    }
+}
+
+#[unsafe(no_mangle)]
+unsafe extern "C" fn libloot_game_set_progress_callback(
+    game: *mut Game,
+    callback: unsafe extern "C" fn(u8, usize, usize, *mut c_void),
+    context: *mut c_void,
+) {
+    // SAFETY: This is safe so long as game is a valid pointer to a Game that
+    // is not being accessed elsewhere for the duration of this call.
+    let Some(game) = (unsafe { game.as_mut() }) else {
+        return;
+    };
+
+    let mutex = Mutex::new(AtomicPtr::new(context));
+
+    game.set_progress_callback(move |phase, done, total| {
+        // Phases that the C++ API doesn't know about are not reported.
+        let Some(phase) = progress_phase_to_u8(phase) else {
+            return;
+        };
+
+        let mut context = match mutex.lock() {
+            Ok(c) => c,
+            Err(e) => {
+                // The stored value is an atomic, since it's atomic it can't have been left in an invalid state.
+                mutex.clear_poison();
+                e.into_inner()
+            }
+        };
+
+        // SAFETY: This is safe so long as callback remains a valid function pointer.
+        unsafe {
+            callback(phase, done, total, *context.get_mut());
+        }
+    });
+}
@@ -251,6 +251,22 @@ TEST_P(DatabaseInterfaceTest,
   EXPECT_EQ("{}", readFileToString(minimalOutputPath_));
 }
 
+TEST_P(DatabaseInterfaceTest,
+       reloadMasterlistShouldReturnTheChangesFromTheLoadedMasterlist) {
+  ASSERT_NO_THROW(GenerateMasterlist());
+  ASSERT_NO_THROW(handle_->GetDatabase().LoadMasterlist(masterlistPath));
+
+  std::ofstream masterlist(masterlistPath);
+  masterlist << "bash_tags:\n  []\nglobals:\n  []\nplugins:\n  []";
+  masterlist.close();
+
+  const auto changes = handle_->GetDatabase().ReloadMasterlist(masterlistPath);
+
+  EXPECT_TRUE(changes.bashTagsChanged);
+  EXPECT_FALSE(changes.changedPlugins.empty());
+  EXPECT_TRUE(handle_->GetDatabase().GetKnownBashTags().empty());
+}
+
 TEST_P(DatabaseInterfaceTest, writeUserMetadataShouldShouldWriteUserMetadata) {
   ASSERT_NO_THROW(GenerateMasterlist());
   ASSERT_NO_THROW(std::filesystem::copy(masterlistPath, userlistPath_));
@@ -271,6 +287,24 @@ TEST_P(DatabaseInterfaceTest, writeUserMetadataShouldShouldWriteUserMetadata) {
   EXPECT_FALSE(readFileToString(minimalOutputPath_).empty());
 }
 
+TEST_P(DatabaseInterfaceTest,
+       writeUserMetadataChangesShouldWriteChangesThatAreLoadedWithTheUserlist) {
+  ASSERT_NO_THROW(
+      handle_->GetDatabase().SetUserKnownBashTags({"first", "second"}));
+
+  MetadataWriteOptions options;
+  options.SetTruncate(true);
+
+  EXPECT_NO_THROW(handle_->GetDatabase().WriteUserMetadataChanges(
+      minimalOutputPath_, options));
+
+  ASSERT_NO_THROW(handle_->GetDatabase().SetUserKnownBashTags({}));
+  ASSERT_NO_THROW(handle_->GetDatabase().LoadUserlist(minimalOutputPath_));
+
+  EXPECT_EQ(std::vector<std::string>({"first", "second"}),
+            handle_->GetDatabase().GetUserKnownBashTags());
+}
+
 TEST_P(DatabaseInterfaceTest, evaluateShouldReturnTrueIfTheConditionIsTrue) {
   touch(dataPath / BLANK_ESP);
   EXPECT_TRUE(handle_->GetDatabase().Evaluate("file(\"Blank.esp\")"));
@@ -280,6 +314,25 @@ TEST_P(DatabaseInterfaceTest, evaluateShouldReturnFalseIfTheConditionIsFalse) {
   EXPECT_FALSE(handle_->GetDatabase().Evaluate("file(\"missing.esp\")"));
 }
 
+TEST_P(DatabaseInterfaceTest,
+       evaluateManyShouldReturnTheResultOfEachConditionInTheGivenOrder) {
+  touch(dataPath / BLANK_ESP);
+
+  const auto results = handle_->GetDatabase().EvaluateMany({
+      "file(\"missing.esp\")",
+      "file(\"Blank.esp\")",
+      "file(\"missing.esp\")",
+  });
+
+  EXPECT_EQ(std::vector<bool>({false, true, false}), results);
+}
+
+TEST_P(DatabaseInterfaceTest, evaluateManyShouldThrowIfAnyConditionIsInvalid) {
+  EXPECT_THROW(
+      handle_->GetDatabase().EvaluateMany({"file(\"Blank.esp\")", "invalid"}),
+      std::runtime_error);
+}
+
 TEST_P(DatabaseInterfaceTest,
        clearConditionCacheShouldCauseConditionsToBeEvaluatedFromScratch) {
   touch(dataPath / BLANK_ESP);
@@ -297,6 +350,22 @@ TEST_P(DatabaseInterfaceTest,
   EXPECT_FALSE(handle_->GetDatabase().Evaluate(condition));
 }
 
+TEST_P(DatabaseInterfaceTest,
+       getConditionCacheStatsShouldCountCacheHitsMissesAndInvalidations) {
+  const auto condition = "file(\"missing.esp\")";
+
+  EXPECT_FALSE(handle_->GetDatabase().Evaluate(condition));
+  EXPECT_FALSE(handle_->GetDatabase().Evaluate(condition));
+
+  handle_->GetDatabase().ClearConditionCache();
+
+  const auto stats = handle_->GetDatabase().GetConditionCacheStats();
+
+  EXPECT_EQ(1, stats.hits);
+  EXPECT_EQ(1, stats.misses);
+  EXPECT_EQ(1, stats.invalidations);
+}
+
 TEST_P(DatabaseInterfaceTest,
        getGroupsShouldReturnAllGroupsListedInTheLoadedMetadata) {
   ASSERT_NO_THROW(GenerateMasterlist());
@@ -695,6 +764,97 @@ TEST_P(
   EXPECT_TRUE(metadata.GetMessages().empty());
 }
 
+TEST_P(
+    DatabaseInterfaceTest,
+    getPluginsMetadataShouldReturnTheSameMetadataAsGetPluginMetadataForEachPluginInTheGivenOrder) {
+  ASSERT_NO_THROW(GenerateMasterlist());
+  ASSERT_NO_THROW(GenerateUserlist());
+  ASSERT_NO_THROW(handle_->GetDatabase().LoadMasterlist(masterlistPath));
+  ASSERT_NO_THROW(handle_->GetDatabase().LoadUserlist(userlistPath_));
+
+  const std::vector<std::string> plugins({
+      std::string(BLANK_DIFFERENT_ESM),
+      std::string(MISSING_ESP),
+      std::string(BLANK_ESM),
+  });
+
+  for (const auto evaluateConditions : {false, true}) {
+    const auto metadata = handle_->GetDatabase().GetPluginsMetadata(
+        plugins, true, evaluateConditions);
+
+    ASSERT_EQ(plugins.size(), metadata.size());
+    for (size_t i = 0; i < plugins.size(); ++i) {
+      const auto expected = handle_->GetDatabase().GetPluginMetadata(
+          plugins[i], true, evaluateConditions);
+
+      ASSERT_EQ(expected.has_value(), metadata[i].has_value());
+      if (expected.has_value()) {
+        EXPECT_EQ(expected->GetName(), metadata[i]->GetName());
+        EXPECT_EQ(expected->GetLoadAfterFiles(),
+                  metadata[i]->GetLoadAfterFiles());
+        EXPECT_EQ(expected->GetMessages(), metadata[i]->GetMessages());
+        EXPECT_EQ(expected->GetTags(), metadata[i]->GetTags());
+      }
+    }
+  }
+}
+
+TEST_P(DatabaseInterfaceTest,
+       getPluginsReferencingShouldReturnEntriesThatReferenceTheGivenFile) {
+  ASSERT_NO_THROW(GenerateMasterlist());
+  ASSERT_NO_THROW(handle_->GetDatabase().LoadMasterlist(masterlistPath));
+
+  const auto plugins = handle_->GetDatabase().GetPluginsReferencing(
+      BLANK_MASTER_DEPENDENT_ESM, false);
+
+  EXPECT_NE(plugins.end(),
+            std::find(plugins.begin(), plugins.end(), BLANK_DIFFERENT_ESM));
+  EXPECT_TRUE(
+      handle_->GetDatabase().GetPluginsReferencing(MISSING_ESP).empty());
+}
+
+TEST_P(DatabaseInterfaceTest,
+       getPluginsInGroupShouldReturnEntriesThatAreInTheGivenGroup) {
+  PluginMetadata plugin(BLANK_ESM);
+  plugin.SetGroup("group1");
+  handle_->GetDatabase().SetPluginUserMetadata(plugin);
+
+  EXPECT_EQ(std::vector<std::string>({std::string(BLANK_ESM)}),
+            handle_->GetDatabase().GetPluginsInGroup("group1"));
+  EXPECT_TRUE(
+      handle_->GetDatabase().GetPluginsInGroup("group1", false).empty());
+}
+
+TEST_P(DatabaseInterfaceTest,
+       getLocalisedMetadataShouldKeepOnlyTheContentForTheGivenLanguage) {
+  const std::vector<MessageContent> content({
+      MessageContent("English"),
+      MessageContent("French", "fr"),
+  });
+  const Message message(MessageType::say, content);
+  handle_->GetDatabase().SetUserGeneralMessages({message});
+
+  PluginMetadata plugin(BLANK_ESM);
+  plugin.SetMessages({message});
+  handle_->GetDatabase().SetPluginUserMetadata(plugin);
+
+  const std::vector<MessageContent> expected({MessageContent("French", "fr")});
+
+  const auto messages =
+      handle_->GetDatabase().GetLocalisedGeneralMessages("fr");
+  ASSERT_EQ(1, messages.size());
+  EXPECT_EQ(expected, messages[0].GetContent());
+
+  const auto metadata =
+      handle_->GetDatabase().GetLocalisedPluginMetadata(BLANK_ESM, "fr");
+  ASSERT_TRUE(metadata.has_value());
+  ASSERT_EQ(1, metadata->GetMessages().size());
+  EXPECT_EQ(expected, metadata->GetMessages()[0].GetContent());
+
+  EXPECT_EQ(content,
+            handle_->GetDatabase().GetGeneralMessages()[0].GetContent());
+}
+
 TEST_P(
     DatabaseInterfaceTest,
     getPluginUserMetadataShouldReturnAnEmptyPluginMetadataObjectIfThePluginHasNoUserMetadata) {
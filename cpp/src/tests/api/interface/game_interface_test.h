@@ -60,6 +60,17 @@ TEST_P(GameInterfaceTest, setAdditionalDataPathsShouldDoThat) {
   EXPECT_EQ(paths, handle_->GetAdditionalDataPaths());
 }
 
+TEST_P(GameInterfaceTest, setAdditionalDataPathsUtf8ShouldDoThat) {
+  const auto paths = std::vector<std::filesystem::path>{
+      localPath, localPath.parent_path() / "other"};
+  const auto pathStrings =
+      std::vector<std::string>{paths[0].u8string(), paths[1].u8string()};
+
+  handle_->SetAdditionalDataPathsUtf8({pathStrings[0], pathStrings[1]});
+
+  EXPECT_EQ(paths, handle_->GetAdditionalDataPaths());
+}
+
 TEST_P(GameInterfaceTest, setAdditionalDataPathsShouldClearTheConditionCache) {
   PluginMetadata metadata(BLANK_ESM);
   metadata.SetLoadAfterFiles({File("plugin.esp", "", "file(\"plugin.esp\")")});
@@ -328,6 +339,31 @@ TEST_P(GameInterfaceTest, loadPluginsShouldNotClearThePluginsCache) {
   ASSERT_NE(nullptr, handle_->GetPlugin(BLANK_ESP));
 }
 
+TEST_P(GameInterfaceTest, loadPluginsAsyncShouldLoadTheGivenPlugins) {
+  copyPlugin(BLANK_ESP);
+
+  auto future = handle_->LoadPluginsAsync(
+      {std::filesystem::u8path(BLANK_ESP)}, true, CancellationToken());
+  future.get();
+
+  EXPECT_EQ(1, handle_->GetLoadedPlugins().size());
+  EXPECT_NE(nullptr, handle_->GetPlugin(BLANK_ESP));
+}
+
+TEST_P(GameInterfaceTest,
+       loadPluginsAsyncShouldThrowAndNotChangeLoadedPluginsIfCancelled) {
+  copyPlugin(BLANK_ESP);
+
+  CancellationToken token;
+  token.Cancel();
+
+  auto future = handle_->LoadPluginsAsync(
+      {std::filesystem::u8path(BLANK_ESP)}, true, token);
+
+  EXPECT_THROW(future.get(), OperationCancelledError);
+  EXPECT_TRUE(handle_->GetLoadedPlugins().empty());
+}
+
 TEST_P(GameInterfaceTest,
        loadPluginsShouldReplaceCacheEntriesForTheGivenPlugins) {
   copyPlugin(BLANK_ESP);
@@ -467,6 +503,100 @@ TEST_P(GameInterfaceTest, sortPluginsShouldOnlySortTheGivenPlugins) {
   EXPECT_EQ(plugins, sorted);
 }
 
+TEST_P(GameInterfaceTest, sortPluginsUtf8ShouldOnlySortTheGivenPlugins) {
+  if (GetParam() == GameType::starfield) {
+    copyPlugin(BLANK_FULL_ESM, BLANK_ESM);
+    copyPlugin(BLANK_ESP);
+    copyPlugin(BLANK_ESP, BLANK_DIFFERENT_ESP);
+  } else {
+    copyPlugin(BLANK_ESM);
+    copyPlugin(BLANK_ESP);
+    copyPlugin(BLANK_DIFFERENT_ESP);
+  }
+
+  handle_->LoadPluginsUtf8({BLANK_ESM, BLANK_ESP, BLANK_DIFFERENT_ESP}, false);
+
+  const auto sorted =
+      handle_->SortPluginsUtf8({BLANK_ESP, BLANK_DIFFERENT_ESP});
+
+  EXPECT_EQ(std::vector<std::string>(
+                {std::string(BLANK_ESP), std::string(BLANK_DIFFERENT_ESP)}),
+            sorted);
+}
+
+TEST_P(GameInterfaceTest, sortPluginsAsyncShouldOnlySortTheGivenPlugins) {
+  if (GetParam() == GameType::starfield) {
+    copyPlugin(BLANK_FULL_ESM, BLANK_ESM);
+    copyPlugin(BLANK_ESP);
+    copyPlugin(BLANK_ESP, BLANK_DIFFERENT_ESP);
+  } else {
+    copyPlugin(BLANK_ESM);
+    copyPlugin(BLANK_ESP);
+    copyPlugin(BLANK_DIFFERENT_ESP);
+  }
+
+  handle_->LoadPlugins({BLANK_ESM, BLANK_ESP, BLANK_DIFFERENT_ESP}, false);
+
+  std::vector<std::string> plugins{std::string(BLANK_ESP),
+                                   std::string(BLANK_DIFFERENT_ESP)};
+  auto future = handle_->SortPluginsAsync(plugins, CancellationToken());
+
+  EXPECT_EQ(plugins, future.get());
+}
+
+TEST_P(GameInterfaceTest, sortPluginsAsyncShouldThrowIfCancelled) {
+  copyPlugin(BLANK_ESP);
+  if (GetParam() == GameType::starfield) {
+    copyPlugin(BLANK_ESP, BLANK_DIFFERENT_ESP);
+  } else {
+    copyPlugin(BLANK_DIFFERENT_ESP);
+  }
+
+  handle_->LoadPlugins({BLANK_ESP, BLANK_DIFFERENT_ESP}, false);
+
+  CancellationToken token;
+  token.Cancel();
+
+  auto future = handle_->SortPluginsAsync(
+      {std::string(BLANK_ESP), std::string(BLANK_DIFFERENT_ESP)}, token);
+
+  EXPECT_THROW(future.get(), OperationCancelledError);
+}
+
+TEST_P(GameInterfaceTest,
+       setProgressCallbackShouldReportTheEndOfEachPhaseOfLoadingAndSorting) {
+  copyPlugin(BLANK_ESP);
+  if (GetParam() == GameType::starfield) {
+    copyPlugin(BLANK_ESP, BLANK_DIFFERENT_ESP);
+  } else {
+    copyPlugin(BLANK_DIFFERENT_ESP);
+  }
+
+  std::vector<ProgressPhase> completedPhases;
+  handle_->SetProgressCallback(
+      [&](ProgressPhase phase, size_t done, size_t total) {
+        if (done == total) {
+          completedPhases.push_back(phase);
+        }
+      });
+
+  handle_->LoadPlugins({BLANK_ESP, BLANK_DIFFERENT_ESP}, false);
+  handle_->SortPlugins(
+      {std::string(BLANK_ESP), std::string(BLANK_DIFFERENT_ESP)});
+
+  EXPECT_EQ(std::vector<ProgressPhase>({
+                ProgressPhase::validatingPaths,
+                ProgressPhase::readingArchives,
+                ProgressPhase::parsingPlugins,
+                ProgressPhase::preparingSortingData,
+                ProgressPhase::addingSpecificEdges,
+                ProgressPhase::addingGroupEdges,
+                ProgressPhase::addingOverlapEdges,
+                ProgressPhase::addingTieBreakEdges,
+            }),
+            completedPhases);
+}
+
 TEST_P(GameInterfaceTest,
        sortingShouldNotMakeUnnecessaryChangesToAnExistingLoadOrder) {
   std::vector<std::string> initialOrder;
@@ -876,6 +1006,51 @@ TEST_P(GameInterfaceTest, setLoadOrderShouldSetTheLoadOrder) {
   }
 }
 
+TEST_P(GameInterfaceTest, setLoadOrderUtf8ShouldSetTheLoadOrder) {
+  // Set no additional data paths to avoid picking up non-test plugins on PCs
+  // which have Starfield or Fallout 4 installed.
+  if (GetParam() == GameType::starfield || GetParam() == GameType::fo4) {
+    handle_->SetAdditionalDataPaths({});
+  }
+
+  std::vector<std::pair<std::string, bool>> initialLoadOrder;
+  std::vector<std::string> newLoadOrder;
+  if (GetParam() == GameType::starfield) {
+    initialLoadOrder = {{std::string(BLANK_FULL_ESM), true},
+                        {std::string(BLANK_ESP), false},
+                        {std::string(BLANK_OVERRIDE_ESP), false}};
+    newLoadOrder = {std::string(BLANK_FULL_ESM),
+                    std::string(BLANK_OVERRIDE_ESP),
+                    std::string(BLANK_ESP)};
+  } else {
+    initialLoadOrder = {{std::string(BLANK_ESM), true},
+                        {std::string(BLANK_ESP), false},
+                        {std::string(BLANK_DIFFERENT_ESP), false}};
+    newLoadOrder = {std::string(BLANK_ESM),
+                    std::string(BLANK_DIFFERENT_ESP),
+                    std::string(BLANK_ESP)};
+  }
+
+  for (const auto& [plugin, isActive] : initialLoadOrder) {
+    copyPlugin(plugin);
+  }
+
+  setLoadOrder(initialLoadOrder);
+  handle_->LoadCurrentLoadOrderState();
+
+  const std::vector<std::string_view> newLoadOrderViews(newLoadOrder.begin(),
+                                                        newLoadOrder.end());
+  EXPECT_NO_THROW(handle_->SetLoadOrderUtf8(newLoadOrderViews));
+
+  EXPECT_EQ(newLoadOrder, handle_->GetLoadOrder());
+
+  // It's not possible to persist the load order of inactive plugins for
+  // OpenMW.
+  if (GetParam() != GameType::openmw) {
+    EXPECT_EQ(newLoadOrder, getLoadOrder());
+  }
+}
+
 TEST_P(GameInterfaceTest, setLoadOrderShouldStripGhostExtensionsFromPlugins) {
   if (GetParam() == GameType::openmw) {
     return;
@@ -900,6 +1075,57 @@ TEST_P(GameInterfaceTest, setLoadOrderShouldStripGhostExtensionsFromPlugins) {
                 {std::string(pluginName), std::string(BLANK_ESP)}),
             handle_->GetLoadOrder());
 }
+
+TEST_P(GameInterfaceTest,
+       snapshotShouldNotReflectPluginsLoadedAfterItWasTaken) {
+  copyPlugin(BLANK_ESP);
+  if (GetParam() == GameType::starfield) {
+    copyPlugin(BLANK_ESP, BLANK_DIFFERENT_ESP);
+  } else {
+    copyPlugin(BLANK_DIFFERENT_ESP);
+  }
+
+  handle_->LoadPlugins({BLANK_ESP}, true);
+
+  const auto snapshot = handle_->Snapshot();
+
+  handle_->LoadPlugins({BLANK_DIFFERENT_ESP}, true);
+  handle_->ClearLoadedPlugins();
+
+  EXPECT_EQ(GetParam(), snapshot->GetType());
+  EXPECT_EQ(1, snapshot->GetLoadedPlugins().size());
+  ASSERT_NE(nullptr, snapshot->GetPlugin(BLANK_ESP));
+  EXPECT_EQ(BLANK_ESP, snapshot->GetPlugin(BLANK_ESP)->GetName());
+  EXPECT_EQ(nullptr, snapshot->GetPlugin(BLANK_DIFFERENT_ESP));
+}
+
+TEST_P(GameInterfaceTest,
+       snapshotShouldNotReflectMetadataChangesMadeAfterItWasTaken) {
+  PluginMetadata metadata(BLANK_ESM);
+  metadata.SetGroup("group1");
+  handle_->GetDatabase().SetPluginUserMetadata(metadata);
+
+  const auto snapshot = handle_->Snapshot();
+
+  handle_->GetDatabase().DiscardAllUserMetadata();
+
+  EXPECT_FALSE(
+      handle_->GetDatabase().GetPluginMetadata(BLANK_ESM).has_value());
+
+  const auto snapshotMetadata = snapshot->GetPluginMetadata(BLANK_ESM);
+  ASSERT_TRUE(snapshotMetadata.has_value());
+  EXPECT_EQ("group1", snapshotMetadata.value().GetGroup().value());
+}
+
+TEST_P(GameInterfaceTest, snapshotShouldOutliveTheGameHandle) {
+  handle_->LoadCurrentLoadOrderState();
+  const auto loadOrder = handle_->GetLoadOrder();
+
+  const auto snapshot = handle_->Snapshot();
+  handle_.reset();
+
+  EXPECT_EQ(loadOrder, snapshot->GetLoadOrder());
+}
 }
 }
 
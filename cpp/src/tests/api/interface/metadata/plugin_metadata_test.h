@@ -265,6 +265,35 @@ TEST(PluginMetadata, unsetGroupShouldLeaveNoGroupValueSet) {
   EXPECT_FALSE(plugin.GetGroup().has_value());
 }
 
+TEST(PluginMetadata, setLoadAfterFilesShouldCopyFromAnLvalueVector) {
+  PluginMetadata plugin;
+  const std::vector<File> files({File(BLANK_ESM), File(BLANK_DIFFERENT_ESM)});
+
+  plugin.SetLoadAfterFiles(files);
+
+  EXPECT_EQ(files, plugin.GetLoadAfterFiles());
+  EXPECT_EQ(2, files.size());
+}
+
+TEST(PluginMetadata, setLoadAfterFilesShouldMoveFromAnRvalueVector) {
+  PluginMetadata plugin;
+  std::vector<File> files({File(BLANK_ESM), File(BLANK_DIFFERENT_ESM)});
+  const auto data = files.data();
+
+  plugin.SetLoadAfterFiles(std::move(files));
+
+  EXPECT_EQ(data, plugin.GetLoadAfterFiles().data());
+  EXPECT_EQ(std::vector<File>({File(BLANK_ESM), File(BLANK_DIFFERENT_ESM)}),
+            plugin.GetLoadAfterFiles());
+}
+
+TEST(PluginMetadata, getLoadAfterFilesShouldReturnAReferenceToTheStoredFiles) {
+  PluginMetadata plugin;
+  plugin.SetLoadAfterFiles({File(BLANK_ESM)});
+
+  EXPECT_EQ(&plugin.GetLoadAfterFiles(), &plugin.GetLoadAfterFiles());
+}
+
 TEST(PluginMetadata,
      hasNameOnlyShouldBeTrueForADefaultConstructedPluginMetadataObject) {
   PluginMetadata plugin;
@@ -3,7 +3,7 @@ use std::{
     sync::{Arc, RwLock},
 };
 
-use libloot::error::DatabaseLockPoisonError;
+use libloot::{LoadedMetadata, error::DatabaseLockPoisonError};
 use libloot_ffi_errors::UnsupportedEnumValueError;
 use napi_derive::napi;
 
@@ -105,11 +105,15 @@ pub struct Database(Arc<RwLock<libloot::Database>>);
 impl Database {
     #[napi]
     pub fn load_masterlist(&self, path: String) -> Result<(), VerboseError> {
+        // Load the masterlist before taking the lock to avoid blocking readers
+        // while it's parsed.
+        let masterlist = LoadedMetadata::load_masterlist(Path::new(&path))?;
+
         self.0
             .write()
             .map_err(DatabaseLockPoisonError::from)?
-            .load_masterlist(Path::new(&path))
-            .map_err(Into::into)
+            .set_masterlist(masterlist);
+        Ok(())
     }
 
     #[napi]
@@ -118,20 +122,27 @@ impl Database {
         masterlist_path: String,
         prelude_path: String,
     ) -> Result<(), VerboseError> {
+        let masterlist = LoadedMetadata::load_masterlist_with_prelude(
+            Path::new(&masterlist_path),
+            Path::new(&prelude_path),
+        )?;
+
         self.0
             .write()
             .map_err(DatabaseLockPoisonError::from)?
-            .load_masterlist_with_prelude(Path::new(&masterlist_path), Path::new(&prelude_path))
-            .map_err(Into::into)
+            .set_masterlist(masterlist);
+        Ok(())
     }
 
     #[napi]
     pub fn load_userlist(&self, path: String) -> Result<(), VerboseError> {
+        let userlist = LoadedMetadata::load(Path::new(&path))?;
+
         self.0
             .write()
             .map_err(DatabaseLockPoisonError::from)?
-            .load_userlist(Path::new(&path))
-            .map_err(Into::into)
+            .set_userlist(userlist);
+        Ok(())
     }
 
     #[napi]
@@ -147,6 +158,19 @@ impl Database {
             .map_err(Into::into)
     }
 
+    #[napi]
+    pub fn write_user_metadata_changes(
+        &self,
+        userlist_path: String,
+        options: &MetadataWriteOptions,
+    ) -> Result<(), VerboseError> {
+        self.0
+            .write()
+            .map_err(DatabaseLockPoisonError::from)?
+            .write_user_metadata_changes(Path::new(&userlist_path), &options.0)
+            .map_err(Into::into)
+    }
+
     #[napi]
     pub fn write_minimal_list(
         &self,
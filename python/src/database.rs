@@ -3,7 +3,7 @@ use std::{
     sync::{Arc, RwLock},
 };
 
-use libloot::{EvalMode, MergeMode, error::DatabaseLockPoisonError};
+use libloot::{EvalMode, LoadedMetadata, MergeMode, error::DatabaseLockPoisonError};
 use libloot_ffi_errors::UnsupportedEnumValueError;
 use pyo3::{
     Bound, PyResult, pyclass, pymethods,
@@ -76,11 +76,15 @@ pub struct Database(Arc<RwLock<libloot::Database>>);
 impl Database {
     #[expect(clippy::needless_pass_by_value, reason = "Required by PyO3")]
     pub fn load_masterlist(&self, path: PathBuf) -> Result<(), VerboseError> {
+        // Load the masterlist before taking the lock to avoid blocking readers
+        // while it's parsed.
+        let masterlist = LoadedMetadata::load_masterlist(&path)?;
+
         self.0
             .write()
             .map_err(DatabaseLockPoisonError::from)?
-            .load_masterlist(&path)
-            .map_err(Into::into)
+            .set_masterlist(masterlist);
+        Ok(())
     }
 
     #[expect(clippy::needless_pass_by_value, reason = "Required by PyO3")]
@@ -89,20 +93,25 @@ impl Database {
         masterlist_path: PathBuf,
         prelude_path: PathBuf,
     ) -> Result<(), VerboseError> {
+        let masterlist =
+            LoadedMetadata::load_masterlist_with_prelude(&masterlist_path, &prelude_path)?;
+
         self.0
             .write()
             .map_err(DatabaseLockPoisonError::from)?
-            .load_masterlist_with_prelude(&masterlist_path, &prelude_path)
-            .map_err(Into::into)
+            .set_masterlist(masterlist);
+        Ok(())
     }
 
     #[expect(clippy::needless_pass_by_value, reason = "Required by PyO3")]
     pub fn load_userlist(&self, path: PathBuf) -> Result<(), VerboseError> {
+        let userlist = LoadedMetadata::load(&path)?;
+
         self.0
             .write()
             .map_err(DatabaseLockPoisonError::from)?
-            .load_userlist(&path)
-            .map_err(Into::into)
+            .set_userlist(userlist);
+        Ok(())
     }
 
     #[expect(clippy::needless_pass_by_value, reason = "Required by PyO3")]
@@ -118,6 +127,19 @@ impl Database {
             .map_err(Into::into)
     }
 
+    #[expect(clippy::needless_pass_by_value, reason = "Required by PyO3")]
+    pub fn write_user_metadata_changes(
+        &self,
+        userlist_path: PathBuf,
+        options: &MetadataWriteOptions,
+    ) -> Result<(), VerboseError> {
+        self.0
+            .write()
+            .map_err(DatabaseLockPoisonError::from)?
+            .write_user_metadata_changes(&userlist_path, &options.0)
+            .map_err(Into::into)
+    }
+
     #[expect(clippy::needless_pass_by_value, reason = "Required by PyO3")]
     pub fn write_minimal_list(
         &self,
@@ -0,0 +1,63 @@
+use std::sync::{
+    Arc,
+    atomic::{AtomicBool, Ordering},
+};
+
+/// A token that can be used to request the cancellation of a long-running
+/// operation, such as loading or sorting plugins.
+///
+/// Clones of a token share the same state, so a token can be cancelled from
+/// one thread while the operation that was given a clone of it runs on
+/// another. Cancellation is cooperative: operations check the token at
+/// convenient points and stop early if it has been cancelled, so an operation
+/// may still complete successfully if it is cancelled shortly before it would
+/// have finished anyway.
+#[derive(Clone, Debug, Default)]
+pub struct CancellationToken(Arc<AtomicBool>);
+
+impl CancellationToken {
+    /// Create a new token that has not been cancelled.
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Request cancellation of any operations that have been given this token
+    /// or one of its clones. Cancellation cannot be undone.
+    pub fn cancel(&self) {
+        self.0.store(true, Ordering::Relaxed);
+    }
+
+    /// Check if cancellation has been requested.
+    pub fn is_cancelled(&self) -> bool {
+        self.0.load(Ordering::Relaxed)
+    }
+
+    pub(crate) fn err_if_cancelled<E>(&self, error: E) -> Result<(), E> {
+        if self.is_cancelled() {
+            Err(error)
+        } else {
+            Ok(())
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn new_should_not_be_cancelled() {
+        assert!(!CancellationToken::new().is_cancelled());
+    }
+
+    #[test]
+    fn cancel_should_cancel_all_clones_of_the_token() {
+        let token = CancellationToken::new();
+        let clone = token.clone();
+
+        clone.cancel();
+
+        assert!(token.is_cancelled());
+        assert!(clone.is_cancelled());
+    }
+}
@@ -0,0 +1,609 @@
+use std::{
+    collections::{HashMap, HashSet},
+    path::PathBuf,
+    sync::{
+        PoisonError, RwLock,
+        atomic::{AtomicUsize, Ordering},
+    },
+};
+
+use crate::metadata::{
+    Filename,
+    plugin_metadata::{iends_with_ascii, trim_dot_ghost},
+};
+
+use super::directory_snapshot::DirectorySnapshot;
+
+/// The functions that only check which entries a directory has.
+///
+/// `readable()` isn't one, as a file can become readable or unreadable without
+/// its directory changing, so it may depend on anything.
+const LISTING_FUNCTIONS: [&str; 2] = ["file", "many"];
+
+/// The functions that read a plugin's contents, which can change without its
+/// version changing.
+const CONTENT_FUNCTIONS: [&str; 5] = [
+    "checksum",
+    "file_size",
+    "version",
+    "description_contains",
+    "is_master",
+];
+
+const PLUGIN_FILE_EXTENSIONS: [&str; 6] = [
+    ".esp",
+    ".esm",
+    ".esl",
+    ".omwaddon",
+    ".omwgame",
+    ".omwscripts",
+];
+
+/// Counts of how a database's condition cache has been used.
+#[derive(Clone, Copy, Debug, Default, Eq, PartialEq, Hash)]
+pub struct ConditionCacheStats {
+    hits: usize,
+    misses: usize,
+    invalidations: usize,
+}
+
+impl ConditionCacheStats {
+    /// Get the number of condition evaluations that used a cached result.
+    pub fn hits(&self) -> usize {
+        self.hits
+    }
+
+    /// Get the number of condition evaluations that had no cached result to
+    /// use.
+    pub fn misses(&self) -> usize {
+        self.misses
+    }
+
+    /// Get the number of cached results that have been discarded because they
+    /// may no longer be correct.
+    pub fn invalidations(&self) -> usize {
+        self.invalidations
+    }
+}
+
+/// Caches the results of evaluating whole conditions, along with the plugins
+/// and directories that each result depends on.
+///
+/// A condition's result is assumed to only depend on the plugins that are
+/// named (without a parent path) as the first argument of its functions, and on
+/// the entries of the directories that its `file()` and `many()` functions look
+/// in. If any other function is given a regex or a path to a
+/// file that isn't an installed plugin, the result may depend on anything, and
+/// is discarded whenever any plugin or directory changes.
+///
+/// Functions that read a plugin's contents are only assumed to depend on the
+/// plugin if it has a known CRC, as otherwise a change to its contents can't be
+/// detected. Results that may depend on anything are discarded whenever loaded
+/// plugins are set.
+#[derive(Debug, Default)]
+pub(crate) struct ConditionCache {
+    results: RwLock<HashMap<Box<str>, CachedResult>>,
+    directories: DirectorySnapshot,
+    plugins_with_crcs: HashSet<Filename>,
+    hits: AtomicUsize,
+    misses: AtomicUsize,
+    invalidations: AtomicUsize,
+}
+
+#[derive(Debug)]
+struct CachedResult {
+    result: bool,
+    dependencies: Dependencies,
+}
+
+impl ConditionCache {
+    pub(crate) fn get_or_insert_with<E>(
+        &self,
+        condition: &str,
+        evaluate: impl FnOnce() -> Result<bool, E>,
+    ) -> Result<bool, E> {
+        if let Some(result) = self.get(condition) {
+            self.hits.fetch_add(1, Ordering::Relaxed);
+            return Ok(result);
+        }
+
+        self.misses.fetch_add(1, Ordering::Relaxed);
+
+        // Directories must be recorded before they're read during evaluation.
+        let dependencies =
+            Dependencies::of(condition, &self.plugins_with_crcs).recorded_in(&self.directories);
+
+        let result = evaluate()?;
+
+        // If the lock is poisoned, fall back to not caching.
+        if let Ok(mut results) = self.results.write() {
+            results.insert(
+                condition.into(),
+                CachedResult {
+                    result,
+                    dependencies,
+                },
+            );
+        }
+
+        Ok(result)
+    }
+
+    fn get(&self, condition: &str) -> Option<bool> {
+        self.results.read().ok()?.get(condition).map(|r| r.result)
+    }
+
+    pub(crate) fn clear(&mut self) {
+        let results = self
+            .results
+            .get_mut()
+            .unwrap_or_else(PoisonError::into_inner);
+
+        self.invalidations
+            .fetch_add(results.len(), Ordering::Relaxed);
+        results.clear();
+        self.directories.clear();
+    }
+
+    /// Set the data path and additional data paths that directories are
+    /// looked for in, discarding all cached results.
+    pub(crate) fn set_data_paths(&mut self, data_paths: Vec<PathBuf>) {
+        self.clear();
+        self.directories.set_roots(data_paths);
+    }
+
+    /// Set the plugins that have known CRCs, discarding the cached results that
+    /// may depend on anything.
+    pub(crate) fn set_plugins_with_crcs(&mut self, plugins_with_crcs: HashSet<Filename>) {
+        self.plugins_with_crcs = plugins_with_crcs;
+
+        let results = self
+            .results
+            .get_mut()
+            .unwrap_or_else(PoisonError::into_inner);
+
+        let old_length = results.len();
+        results.retain(|_, r| r.dependencies != Dependencies::Unknown);
+
+        self.invalidations
+            .fetch_add(old_length.saturating_sub(results.len()), Ordering::Relaxed);
+    }
+
+    /// Discard the cached results that may depend on any of the given plugins,
+    /// or on any directory that has changed since it was first read.
+    pub(crate) fn invalidate(&mut self, changed_plugins: &HashSet<Filename>) {
+        let changed_directories = self.directories.refresh();
+
+        if changed_plugins.is_empty() && changed_directories.is_empty() {
+            return;
+        }
+
+        let results = self
+            .results
+            .get_mut()
+            .unwrap_or_else(PoisonError::into_inner);
+
+        let old_length = results.len();
+        results.retain(|_, r| {
+            !r.dependencies
+                .includes_any(changed_plugins, &changed_directories)
+        });
+
+        self.invalidations
+            .fetch_add(old_length.saturating_sub(results.len()), Ordering::Relaxed);
+    }
+
+    pub(crate) fn stats(&self) -> ConditionCacheStats {
+        ConditionCacheStats {
+            hits: self.hits.load(Ordering::Relaxed),
+            misses: self.misses.load(Ordering::Relaxed),
+            invalidations: self.invalidations.load(Ordering::Relaxed),
+        }
+    }
+}
+
+#[derive(Debug, Eq, PartialEq)]
+enum Dependencies {
+    Known {
+        plugins: Box<[Filename]>,
+        // Paths relative to the data path.
+        directories: Box<[PathBuf]>,
+    },
+    Unknown,
+}
+
+impl Dependencies {
+    fn of(condition: &str, plugins_with_crcs: &HashSet<Filename>) -> Self {
+        let mut plugins = Vec::new();
+        let mut directories = Vec::new();
+
+        // Condition strings can't contain escaped double quotes, so splitting
+        // on them alternates between text outside and inside string literals.
+        let mut segments = condition.split('"');
+        while let Some(before) = segments.next() {
+            let Some(literal) = segments.next() else {
+                break;
+            };
+
+            // Only a function's first argument is a path: any other string
+            // arguments are versions or description regexes.
+            let Some(function) = before.trim_end().strip_suffix('(') else {
+                continue;
+            };
+            let function = function.trim_end();
+            let function = function
+                .rsplit(|c: char| !c.is_ascii_alphanumeric() && c != '_')
+                .next()
+                .unwrap_or(function);
+
+            if function == "readable" {
+                return Self::Unknown;
+            }
+
+            let (parent, filename) = literal.rsplit_once('/').unwrap_or(("", literal));
+            // A plugin path with a parent refers to a file in another
+            // directory, which isn't tracked as a plugin.
+            let is_plugin = parent.is_empty()
+                && !is_regex_path(literal)
+                && PLUGIN_FILE_EXTENSIONS
+                    .iter()
+                    .any(|e| iends_with_ascii(trim_dot_ghost(filename), e));
+
+            if is_plugin {
+                let plugin = Filename::new(trim_dot_ghost(filename).to_owned());
+                if CONTENT_FUNCTIONS.contains(&function) && !plugins_with_crcs.contains(&plugin) {
+                    return Self::Unknown;
+                }
+                plugins.push(plugin);
+            } else if LISTING_FUNCTIONS.contains(&function) {
+                // These functions only check if a directory has a matching
+                // entry, and only the filename part of a regex path is a regex.
+                directories.push(PathBuf::from(parent));
+            } else {
+                return Self::Unknown;
+            }
+        }
+
+        Self::Known {
+            plugins: plugins.into_boxed_slice(),
+            directories: directories.into_boxed_slice(),
+        }
+    }
+
+    /// Returns `Unknown` if any of the directories can't be recorded.
+    fn recorded_in(self, snapshot: &DirectorySnapshot) -> Self {
+        if let Self::Known { directories, .. } = &self
+            && !directories.iter().all(|d| snapshot.record(d))
+        {
+            return Self::Unknown;
+        }
+
+        self
+    }
+
+    fn includes_any(
+        &self,
+        changed_plugins: &HashSet<Filename>,
+        changed_directories: &HashSet<PathBuf>,
+    ) -> bool {
+        match self {
+            Self::Known {
+                plugins,
+                directories,
+            } => {
+                plugins.iter().any(|p| changed_plugins.contains(p))
+                    || directories.iter().any(|d| changed_directories.contains(d))
+            }
+            Self::Unknown => true,
+        }
+    }
+}
+
+fn is_regex_path(path: &str) -> bool {
+    path.contains([':', '\\', '*', '?', '|'])
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn filenames(names: &[&str]) -> HashSet<Filename> {
+        names
+            .iter()
+            .map(|n| Filename::new((*n).to_owned()))
+            .collect()
+    }
+
+    mod dependencies {
+        use super::*;
+
+        fn known(plugins: &[&str], directories: &[&str]) -> Dependencies {
+            Dependencies::Known {
+                plugins: plugins
+                    .iter()
+                    .map(|p| Filename::new((*p).to_owned()))
+                    .collect(),
+                directories: directories.iter().map(PathBuf::from).collect(),
+            }
+        }
+
+        #[test]
+        fn of_should_find_plugins_named_as_first_function_arguments() {
+            let dependencies = Dependencies::of(
+                "active(\"A.esp\") and not version(\"B.esm\", \"1.0\", >=) or checksum(\"C.esl.ghost\", DEADBEEF)",
+                &filenames(&["B.esm", "C.esl"]),
+            );
+
+            assert_eq!(known(&["A.esp", "B.esm", "C.esl"], &[]), dependencies);
+        }
+
+        #[test]
+        fn of_should_be_unknown_if_a_plugin_without_a_crc_is_given_to_a_content_function() {
+            for function in CONTENT_FUNCTIONS {
+                let condition = format!("active(\"A.esp\") and {function}(\"B.esp\")");
+
+                assert_eq!(
+                    Dependencies::Unknown,
+                    Dependencies::of(&condition, &filenames(&["A.esp"]))
+                );
+                assert_eq!(
+                    known(&["A.esp", "B.esp"], &[]),
+                    Dependencies::of(&condition, &filenames(&["B.esp"]))
+                );
+            }
+        }
+
+        #[test]
+        fn of_should_find_the_directory_of_a_plugin_path_with_a_parent() {
+            assert_eq!(
+                known(&[], &["Optional", "../Data"]),
+                Dependencies::of(
+                    "file(\"Optional/A.esp\") or file(\"../Data/A.esp\")",
+                    &HashSet::new()
+                )
+            );
+        }
+
+        #[test]
+        fn of_should_be_unknown_if_a_plugin_path_with_a_parent_is_given_to_another_function() {
+            assert_eq!(
+                Dependencies::Unknown,
+                Dependencies::of("checksum(\"Optional/A.esp\", DEADBEEF)", &HashSet::new())
+            );
+        }
+
+        #[test]
+        fn of_should_find_the_directories_that_listing_functions_look_in() {
+            let dependencies = Dependencies::of(
+                "file(\"textures/a.dds\") and file(\"../SKSE\") or many(\"meshes/x/Foo.*\\.nif\")",
+                &HashSet::new(),
+            );
+
+            assert_eq!(known(&[], &["textures", "..", "meshes/x"]), dependencies);
+        }
+
+        #[test]
+        fn of_should_find_the_directory_of_a_regex_plugin_path_given_to_a_listing_function() {
+            assert_eq!(
+                known(&["A.esp"], &[""]),
+                Dependencies::of(
+                    "active(\"A.esp\") and many(\"Foo.*\\.esp\")",
+                    &HashSet::new()
+                )
+            );
+        }
+
+        #[test]
+        fn of_should_be_unknown_if_a_path_is_given_to_readable() {
+            assert_eq!(
+                Dependencies::Unknown,
+                Dependencies::of("readable(\"textures/a.dds\")", &HashSet::new())
+            );
+            assert_eq!(
+                Dependencies::Unknown,
+                Dependencies::of("readable(\"A.esp\")", &filenames(&["A.esp"]))
+            );
+        }
+
+        #[test]
+        fn of_should_be_unknown_if_a_path_given_to_another_function_is_a_regex() {
+            assert_eq!(
+                Dependencies::Unknown,
+                Dependencies::of(
+                    "active(\"A.esp\") and many_active(\"Foo.*\\.esp\")",
+                    &HashSet::new()
+                )
+            );
+        }
+
+        #[test]
+        fn of_should_be_unknown_if_a_path_given_to_another_function_is_not_a_plugin() {
+            assert_eq!(
+                Dependencies::Unknown,
+                Dependencies::of(
+                    "active(\"A.esp\") and checksum(\"skse.dll\", DEADBEEF)",
+                    &HashSet::new()
+                )
+            );
+        }
+
+        #[test]
+        fn of_should_ignore_string_arguments_after_the_first() {
+            assert_eq!(
+                known(&["A.esp"], &[]),
+                Dependencies::of("description(\"A.esp\", \"Foo.*\")", &HashSet::new())
+            );
+        }
+
+        #[test]
+        fn recorded_in_should_be_unknown_if_directories_cannot_be_recorded() {
+            let snapshot = DirectorySnapshot::default();
+
+            assert_eq!(
+                Dependencies::Unknown,
+                Dependencies::of("file(\"textures/a.dds\")", &HashSet::new())
+                    .recorded_in(&snapshot)
+            );
+            assert_eq!(
+                known(&["A.esp"], &[]),
+                Dependencies::of("file(\"A.esp\")", &HashSet::new()).recorded_in(&snapshot)
+            );
+        }
+    }
+
+    mod condition_cache {
+        use super::*;
+
+        #[test]
+        fn get_or_insert_with_should_only_evaluate_a_condition_once() {
+            let cache = ConditionCache::default();
+
+            let result = cache.get_or_insert_with("active(\"A.esp\")", || Ok::<_, ()>(true));
+            assert_eq!(Ok(true), result);
+
+            let result = cache.get_or_insert_with("active(\"A.esp\")", || Err(()));
+            assert_eq!(Ok(true), result);
+
+            assert_eq!(1, cache.stats().hits());
+            assert_eq!(1, cache.stats().misses());
+        }
+
+        #[test]
+        fn get_or_insert_with_should_not_cache_errors() {
+            let cache = ConditionCache::default();
+
+            let result = cache.get_or_insert_with("invalid", || Err::<bool, _>(()));
+            assert_eq!(Err(()), result);
+
+            let result = cache.get_or_insert_with("invalid", || Ok::<_, ()>(false));
+            assert_eq!(Ok(false), result);
+
+            assert_eq!(0, cache.stats().hits());
+            assert_eq!(2, cache.stats().misses());
+        }
+
+        #[test]
+        fn invalidate_should_only_discard_results_that_depend_on_the_given_plugins() {
+            let mut cache = ConditionCache::default();
+
+            for condition in [
+                "active(\"A.esp\")",
+                "active(\"B.esp\")",
+                "file(\"C.bsa\")",
+                "active(\"D.*\\.esp\")",
+            ] {
+                cache
+                    .get_or_insert_with(condition, || Ok::<_, ()>(true))
+                    .unwrap();
+            }
+
+            cache.invalidate(&filenames(&["a.ESP"]));
+
+            assert_eq!(3, cache.stats().invalidations());
+            assert!(cache.get("active(\"A.esp\")").is_none());
+            assert!(cache.get("active(\"B.esp\")").is_some());
+            assert!(cache.get("file(\"C.bsa\")").is_none());
+            assert!(cache.get("active(\"D.*\\.esp\")").is_none());
+        }
+
+        #[test]
+        fn invalidate_should_do_nothing_if_no_plugins_are_given() {
+            let mut cache = ConditionCache::default();
+            cache
+                .get_or_insert_with("file(\"C.bsa\")", || Ok::<_, ()>(true))
+                .unwrap();
+
+            cache.invalidate(&HashSet::new());
+
+            assert_eq!(0, cache.stats().invalidations());
+            assert!(cache.get("file(\"C.bsa\")").is_some());
+        }
+
+        #[test]
+        fn invalidate_should_discard_results_that_depend_on_a_changed_directory() {
+            let tmp_dir = tempfile::tempdir().unwrap();
+            let root = tmp_dir.path();
+            std::fs::create_dir_all(root.join("textures")).unwrap();
+
+            let mut cache = ConditionCache::default();
+            cache.set_data_paths(vec![root.to_path_buf()]);
+
+            for condition in ["file(\"textures/a.dds\")", "file(\"meshes/a.nif\")"] {
+                cache
+                    .get_or_insert_with(condition, || Ok::<_, ()>(false))
+                    .unwrap();
+            }
+
+            cache.invalidate(&HashSet::new());
+            assert_eq!(0, cache.stats().invalidations());
+
+            std::fs::create_dir_all(root.join("meshes")).unwrap();
+            cache.invalidate(&filenames(&["A.esp"]));
+
+            assert_eq!(1, cache.stats().invalidations());
+            assert!(cache.get("file(\"textures/a.dds\")").is_some());
+            assert!(cache.get("file(\"meshes/a.nif\")").is_none());
+        }
+
+        #[test]
+        fn invalidate_should_discard_results_for_a_plugin_path_with_a_parent_when_the_plugin_is_moved_there()
+         {
+            let tmp_dir = tempfile::tempdir().unwrap();
+            let root = tmp_dir.path();
+            std::fs::write(root.join("A.esp"), "").unwrap();
+
+            let mut cache = ConditionCache::default();
+            cache.set_data_paths(vec![root.to_path_buf()]);
+
+            let condition = "file(\"Optional/A.esp\")";
+            cache
+                .get_or_insert_with(condition, || Ok::<_, ()>(false))
+                .unwrap();
+
+            std::fs::create_dir(root.join("Optional")).unwrap();
+            std::fs::rename(root.join("A.esp"), root.join("Optional/A.esp")).unwrap();
+            cache.invalidate(&HashSet::new());
+
+            assert_eq!(1, cache.stats().invalidations());
+            assert!(cache.get(condition).is_none());
+        }
+
+        #[test]
+        fn set_plugins_with_crcs_should_discard_results_that_may_depend_on_anything() {
+            let mut cache = ConditionCache::default();
+
+            for condition in ["active(\"A.esp\")", "checksum(\"B.esp\", DEADBEEF)"] {
+                cache
+                    .get_or_insert_with(condition, || Ok::<_, ()>(true))
+                    .unwrap();
+            }
+
+            cache.set_plugins_with_crcs(filenames(&["B.esp"]));
+
+            assert_eq!(1, cache.stats().invalidations());
+            assert!(cache.get("active(\"A.esp\")").is_some());
+            assert!(cache.get("checksum(\"B.esp\", DEADBEEF)").is_none());
+
+            cache
+                .get_or_insert_with("checksum(\"B.esp\", DEADBEEF)", || Ok::<_, ()>(true))
+                .unwrap();
+            cache.set_plugins_with_crcs(filenames(&["B.esp"]));
+
+            assert_eq!(1, cache.stats().invalidations());
+            assert!(cache.get("checksum(\"B.esp\", DEADBEEF)").is_some());
+        }
+
+        #[test]
+        fn clear_should_discard_all_results() {
+            let mut cache = ConditionCache::default();
+            cache
+                .get_or_insert_with("active(\"A.esp\")", || Ok::<_, ()>(true))
+                .unwrap();
+
+            cache.clear();
+
+            assert_eq!(1, cache.stats().invalidations());
+            assert!(cache.get("active(\"A.esp\")").is_none());
+        }
+    }
+}
@@ -1,53 +1,262 @@
-use std::str::FromStr;
+use std::{
+    collections::{HashMap, HashSet},
+    path::{Path, PathBuf},
+    str::FromStr,
+};
 
 use loot_condition_interpreter::Expression;
+use rayon::iter::{IntoParallelIterator, IntoParallelRefIterator, ParallelIterator};
+
+use crate::{
+    logging,
+    metadata::{Condition, File, Filename, PluginCleaningData, PluginMetadata},
+};
+
+use super::condition_cache::{ConditionCache, ConditionCacheStats};
+
+/// Evaluates conditions using the condition interpreter, caching the results
+/// of whole conditions.
+///
+/// The condition interpreter has its own cache of function results that can't
+/// be partially invalidated, so it's cleared whenever the state of any plugin
+/// changes, but cached condition results are only discarded if they may depend
+/// on a plugin that changed.
+#[derive(Debug)]
+pub(crate) struct ConditionEvaluator {
+    state: loot_condition_interpreter::State,
+    cache: ConditionCache,
+    installed_plugins: HashSet<Filename>,
+    active_plugins: HashSet<Filename>,
+    plugin_versions: HashMap<Filename, String>,
+    // The CRCs of loaded plugins, used to check cleaning data without
+    // evaluating a checksum condition.
+    plugin_crcs: HashMap<Filename, u32>,
+    // Used to find the directories that cached results depend on.
+    data_path: Option<PathBuf>,
+}
+
+impl ConditionEvaluator {
+    pub(crate) fn new(state: loot_condition_interpreter::State) -> Self {
+        Self {
+            state,
+            cache: ConditionCache::default(),
+            installed_plugins: HashSet::new(),
+            active_plugins: HashSet::new(),
+            plugin_versions: HashMap::new(),
+            plugin_crcs: HashMap::new(),
+            data_path: None,
+        }
+    }
+
+    pub(crate) fn evaluate(
+        &self,
+        condition: &Condition,
+    ) -> Result<bool, loot_condition_interpreter::Error> {
+        self.cache
+            .get_or_insert_with(condition.as_str(), || condition.evaluate(&self.state))
+    }
+
+    pub(crate) fn evaluate_str(
+        &self,
+        condition: &str,
+    ) -> Result<bool, loot_condition_interpreter::Error> {
+        self.cache.get_or_insert_with(condition, || {
+            Expression::from_str(condition).and_then(|e| e.eval(&self.state))
+        })
+    }
+
+    pub(crate) fn plugin_crc(&self, plugin_name: &str) -> Option<u32> {
+        self.plugin_crcs
+            .get(&Filename::new(plugin_name.to_owned()))
+            .copied()
+    }
+
+    pub(crate) fn cache_stats(&self) -> ConditionCacheStats {
+        self.cache.stats()
+    }
+
+    pub(crate) fn clear_cache(&mut self) {
+        self.clear_interpreter_cache();
+        self.cache.clear();
+    }
+
+    /// Set the paths that the state looks for files in, so that cached results
+    /// that depend on the contents of directories in those paths are only
+    /// discarded when the directories change.
+    ///
+    /// This doesn't change the paths that the state uses.
+    pub(crate) fn set_data_paths(&mut self, data_path: PathBuf, additional_data_paths: &[PathBuf]) {
+        self.cache
+            .set_data_paths(all_data_paths(&data_path, additional_data_paths));
+        self.data_path = Some(data_path);
+    }
+
+    pub(crate) fn set_additional_data_paths(&mut self, additional_data_paths: Vec<PathBuf>) {
+        self.clear_cache();
 
-use crate::metadata::{File, PluginCleaningData, PluginMetadata};
+        if let Some(data_path) = &self.data_path {
+            self.cache
+                .set_data_paths(all_data_paths(data_path, &additional_data_paths));
+        }
+
+        self.state.set_additional_data_paths(additional_data_paths);
+    }
+
+    /// Set the installed and active plugins, discarding cached results that
+    /// may depend on plugins that have been installed, uninstalled, activated
+    /// or deactivated.
+    pub(crate) fn set_load_order_state(
+        &mut self,
+        installed_plugin_names: &[&str],
+        active_plugin_names: &[&str],
+    ) {
+        let installed_plugins = to_filenames(installed_plugin_names);
+        let active_plugins = to_filenames(active_plugin_names);
+
+        let changed_plugins: HashSet<Filename> = self
+            .installed_plugins
+            .symmetric_difference(&installed_plugins)
+            .chain(self.active_plugins.symmetric_difference(&active_plugins))
+            .cloned()
+            .collect();
+
+        self.clear_interpreter_cache();
+        self.cache.invalidate(&changed_plugins);
+
+        self.state.set_active_plugins(active_plugin_names);
+        self.installed_plugins = installed_plugins;
+        self.active_plugins = active_plugins;
+    }
+
+    /// Set the versions and CRCs of loaded plugins, discarding cached results
+    /// that may depend on plugins with versions or CRCs that have changed, or
+    /// on the contents of plugins that have no known CRC.
+    pub(crate) fn set_loaded_plugins(
+        &mut self,
+        plugin_versions: &[(&str, &str)],
+        plugin_crcs: &[(&str, u32)],
+    ) {
+        let new_versions: HashMap<Filename, String> = plugin_versions
+            .iter()
+            .map(|(n, v)| (Filename::new((*n).to_owned()), (*v).to_owned()))
+            .collect();
+        let new_crcs: HashMap<Filename, u32> = plugin_crcs
+            .iter()
+            .map(|(n, c)| (Filename::new((*n).to_owned()), *c))
+            .collect();
+
+        let mut changed_plugins = changed_keys(&self.plugin_versions, &new_versions);
+        changed_plugins.extend(changed_keys(&self.plugin_crcs, &new_crcs));
+
+        self.clear_interpreter_cache();
+        self.cache.invalidate(&changed_plugins);
+        self.cache
+            .set_plugins_with_crcs(new_crcs.keys().cloned().collect());
+
+        self.state.set_plugin_versions(plugin_versions);
+
+        if let Err(e) = self.state.set_cached_crcs(plugin_crcs) {
+            logging::error!(
+                "The condition interpreter's CRC cache's lock is poisoned, clearing the cache and assigning a new value"
+            );
+            let mut cache = e.into_inner();
+            cache.clear();
+            *cache = plugin_crcs
+                .iter()
+                .map(|(n, c)| (n.to_lowercase(), *c))
+                .collect();
+        }
+
+        self.plugin_versions = new_versions;
+        self.plugin_crcs = new_crcs;
+    }
+
+    fn clear_interpreter_cache(&mut self) {
+        if let Err(e) = self.state.clear_condition_cache() {
+            logging::error!("The condition cache's lock is poisoned, assigning a new cache");
+            *e.into_inner() = HashMap::new();
+        }
+    }
+}
+
+fn all_data_paths(data_path: &Path, additional_data_paths: &[PathBuf]) -> Vec<PathBuf> {
+    additional_data_paths
+        .iter()
+        .cloned()
+        .chain(std::iter::once(data_path.to_path_buf()))
+        .collect()
+}
+
+fn to_filenames(names: &[&str]) -> HashSet<Filename> {
+    names
+        .iter()
+        .map(|n| Filename::new((*n).to_owned()))
+        .collect()
+}
+
+fn changed_keys<T: PartialEq>(
+    old: &HashMap<Filename, T>,
+    new: &HashMap<Filename, T>,
+) -> HashSet<Filename> {
+    old.iter()
+        .filter(|(k, v)| new.get(*k) != Some(*v))
+        .chain(new.iter().filter(|(k, v)| old.get(*k) != Some(*v)))
+        .map(|(k, _)| k.clone())
+        .collect()
+}
 
 pub(crate) fn evaluate_all_conditions(
     mut metadata: PluginMetadata,
-    state: &loot_condition_interpreter::State,
+    evaluator: &ConditionEvaluator,
 ) -> Result<Option<PluginMetadata>, loot_condition_interpreter::Error> {
-    metadata.set_load_after_files(filter_files_on_conditions(
-        metadata.load_after_files(),
-        state,
-    )?);
+    // Each list is only replaced if some of its items are filtered out, so
+    // that unfiltered lists continue to be shared with the unevaluated
+    // metadata.
+    if let Some(files) = filter_files_on_conditions(metadata.load_after_files(), evaluator)? {
+        metadata.set_load_after_files(files);
+    }
 
-    metadata.set_requirements(filter_files_on_conditions(metadata.requirements(), state)?);
+    if let Some(files) = filter_files_on_conditions(metadata.requirements(), evaluator)? {
+        metadata.set_requirements(files);
+    }
 
-    metadata.set_incompatibilities(filter_files_on_conditions(
-        metadata.incompatibilities(),
-        state,
-    )?);
+    if let Some(files) = filter_files_on_conditions(metadata.incompatibilities(), evaluator)? {
+        metadata.set_incompatibilities(files);
+    }
 
-    metadata.set_messages(
-        metadata
-            .messages()
-            .iter()
-            .filter_map(|m| filter_map_on_condition(m, m.condition(), state))
-            .collect::<Result<Vec<_>, _>>()?,
-    );
+    if let Some(messages) = filter_on_conditions(metadata.messages(), |m| {
+        evaluate_condition_option(m.parsed_condition(), evaluator)
+    })? {
+        metadata.set_messages(messages);
+    }
 
-    metadata.set_tags(
-        metadata
-            .tags()
-            .iter()
-            .filter_map(|t| filter_map_on_condition(t, t.condition(), state))
-            .collect::<Result<Vec<_>, _>>()?,
-    );
+    if let Some(tags) = filter_on_conditions(metadata.tags(), |t| {
+        evaluate_condition_option(t.parsed_condition(), evaluator)
+    })? {
+        metadata.set_tags(tags);
+    }
 
-    if !metadata.is_regex_plugin() {
-        metadata.set_dirty_info(filter_cleaning_data_on_conditions(
+    let has_cleaning_data = !metadata.dirty_info().is_empty() || !metadata.clean_info().is_empty();
+    if !metadata.is_regex_plugin() && has_cleaning_data {
+        let plugin_crc = evaluator.plugin_crc(metadata.name());
+
+        if let Some(info) = filter_cleaning_data_on_conditions(
             metadata.name(),
+            plugin_crc,
             metadata.dirty_info(),
-            state,
-        )?);
+            evaluator,
+        )? {
+            metadata.set_dirty_info(info);
+        }
 
-        metadata.set_clean_info(filter_cleaning_data_on_conditions(
+        if let Some(info) = filter_cleaning_data_on_conditions(
             metadata.name(),
+            plugin_crc,
             metadata.clean_info(),
-            state,
-        )?);
+            evaluator,
+        )? {
+            metadata.set_clean_info(info);
+        }
     }
 
     if metadata.has_name_only() {
@@ -57,19 +266,54 @@ pub(crate) fn evaluate_all_conditions(
     }
 }
 
-pub(crate) fn evaluate_condition(
-    condition: &str,
-    state: &loot_condition_interpreter::State,
-) -> Result<bool, loot_condition_interpreter::Error> {
-    Expression::from_str(condition).and_then(|e| e.eval(state))
+/// Evaluate the conditions in many plugins' metadata in parallel.
+///
+/// The distinct conditions in all the given metadata are evaluated first, so
+/// that each is only evaluated once however many plugins share it, and then
+/// the metadata is filtered using the cached results.
+pub(crate) fn evaluate_all_conditions_in_parallel(
+    metadata: Vec<Option<PluginMetadata>>,
+    evaluator: &ConditionEvaluator,
+) -> Result<Vec<Option<PluginMetadata>>, loot_condition_interpreter::Error> {
+    let conditions: HashSet<&Condition> = metadata.iter().flatten().flat_map(conditions).collect();
+
+    conditions
+        .par_iter()
+        .try_for_each(|c| evaluator.evaluate(c).map(|_| ()))?;
+
+    metadata
+        .into_par_iter()
+        .map(|m| match m {
+            Some(m) => evaluate_all_conditions(m, evaluator),
+            None => Ok(None),
+        })
+        .collect()
+}
+
+/// Cleaning data conditions are not included, as they're only evaluated if
+/// the plugin's CRC matches.
+fn conditions(metadata: &PluginMetadata) -> impl Iterator<Item = &Condition> {
+    metadata
+        .load_after_files()
+        .iter()
+        .chain(metadata.requirements())
+        .chain(metadata.incompatibilities())
+        .filter_map(File::parsed_condition)
+        .chain(
+            metadata
+                .messages()
+                .iter()
+                .filter_map(|m| m.parsed_condition()),
+        )
+        .chain(metadata.tags().iter().filter_map(|t| t.parsed_condition()))
 }
 
 fn evaluate_condition_option(
-    condition: Option<&str>,
-    state: &loot_condition_interpreter::State,
+    condition: Option<&Condition>,
+    evaluator: &ConditionEvaluator,
 ) -> Result<bool, loot_condition_interpreter::Error> {
     if let Some(condition) = condition {
-        evaluate_condition(condition, state)
+        evaluator.evaluate(condition)
     } else {
         Ok(true)
     }
@@ -77,45 +321,71 @@ fn evaluate_condition_option(
 
 pub(crate) fn filter_map_on_condition<T: Clone>(
     item: &T,
-    condition: Option<&str>,
-    state: &loot_condition_interpreter::State,
+    condition: Option<&Condition>,
+    evaluator: &ConditionEvaluator,
 ) -> Option<Result<T, loot_condition_interpreter::Error>> {
-    evaluate_condition_option(condition, state)
+    evaluate_condition_option(condition, evaluator)
         .map(|r| r.then(|| item.clone()))
         .transpose()
 }
 
+/// Returns `None` if no items are filtered out, to avoid copying them.
+fn filter_on_conditions<T: Clone>(
+    items: &[T],
+    mut evaluate: impl FnMut(&T) -> Result<bool, loot_condition_interpreter::Error>,
+) -> Result<Option<Vec<T>>, loot_condition_interpreter::Error> {
+    let results = items
+        .iter()
+        .map(&mut evaluate)
+        .collect::<Result<Vec<_>, _>>()?;
+
+    if results.iter().all(|r| *r) {
+        return Ok(None);
+    }
+
+    Ok(Some(
+        items
+            .iter()
+            .zip(results)
+            .filter_map(|(item, result)| result.then(|| item.clone()))
+            .collect(),
+    ))
+}
+
 fn filter_files_on_conditions(
     files: &[File],
-    state: &loot_condition_interpreter::State,
-) -> Result<Vec<File>, loot_condition_interpreter::Error> {
-    files
-        .iter()
-        .filter_map(|file| filter_map_on_condition(file, file.condition(), state))
-        .collect()
+    evaluator: &ConditionEvaluator,
+) -> Result<Option<Vec<File>>, loot_condition_interpreter::Error> {
+    filter_on_conditions(files, |file| {
+        evaluate_condition_option(file.parsed_condition(), evaluator)
+    })
 }
 
+/// If the plugin's CRC is known, it's compared directly against each entry's
+/// CRC, otherwise a checksum condition is evaluated to get the CRC. An entry's
+/// own condition is only evaluated if the CRCs match.
 fn filter_cleaning_data_on_conditions(
     plugin_name: &str,
+    plugin_crc: Option<u32>,
     cleaning_info: &[PluginCleaningData],
-    state: &loot_condition_interpreter::State,
-) -> Result<Vec<PluginCleaningData>, loot_condition_interpreter::Error> {
+    evaluator: &ConditionEvaluator,
+) -> Result<Option<Vec<PluginCleaningData>>, loot_condition_interpreter::Error> {
     if plugin_name.is_empty() {
-        return Ok(Vec::new());
+        return Ok((!cleaning_info.is_empty()).then(Vec::new));
     }
 
-    cleaning_info
-        .iter()
-        .filter_map(|i| {
-            let condition = if let Some(c) = i.condition() {
-                format!("checksum(\"{}\", {:08X}) and ({})", plugin_name, i.crc(), c)
-            } else {
-                format!("checksum(\"{}\", {:08X})", plugin_name, i.crc())
-            };
-
-            filter_map_on_condition(i, Some(condition.as_str()), state)
-        })
-        .collect()
+    filter_on_conditions(cleaning_info, |i| {
+        let crc_matches = match plugin_crc {
+            Some(crc) => crc == i.crc(),
+            None => evaluator.evaluate_str(&format!(
+                "checksum(\"{}\", {:08X})",
+                plugin_name,
+                i.crc()
+            ))?,
+        };
+
+        Ok(crc_matches && evaluate_condition_option(i.parsed_condition(), evaluator)?)
+    })
 }
 
 #[cfg(test)]
@@ -161,11 +431,13 @@ mod tests {
             plugin.set_dirty_info(vec![info1.clone(), info2.clone(), info3.clone()]);
             plugin.set_clean_info(vec![info1.clone(), info2.clone()]);
 
-            let state = loot_condition_interpreter::State::new(
+            let evaluator = ConditionEvaluator::new(loot_condition_interpreter::State::new(
                 loot_condition_interpreter::GameType::Oblivion,
                 source_plugins_path(crate::GameType::Oblivion),
-            );
-            let result = evaluate_all_conditions(plugin, &state).unwrap().unwrap();
+            ));
+            let result = evaluate_all_conditions(plugin, &evaluator)
+                .unwrap()
+                .unwrap();
 
             let expected_files = &[files[0].clone()];
             let expected_info = &[info1];
@@ -179,6 +451,52 @@ mod tests {
             assert_eq!(expected_info, result.clean_info());
         }
 
+        #[test]
+        fn should_not_copy_metadata_that_has_nothing_filtered_out() {
+            let mut plugin = PluginMetadata::new(BLANK_ESM).unwrap();
+            plugin.set_load_after_files(vec![
+                File::new(BLANK_ESP.into()),
+                File::new(BLANK_DIFFERENT_ESM.into())
+                    .with_condition("file(\"missing.esp\")".into()),
+            ]);
+            plugin.set_messages(vec![Message::new(MessageType::Say, "content".into())]);
+
+            let evaluator = ConditionEvaluator::new(loot_condition_interpreter::State::new(
+                loot_condition_interpreter::GameType::Oblivion,
+                source_plugins_path(crate::GameType::Oblivion),
+            ));
+            let result = evaluate_all_conditions(plugin.clone(), &evaluator)
+                .unwrap()
+                .unwrap();
+
+            assert_eq!(1, result.load_after_files().len());
+            assert!(std::ptr::eq(
+                plugin.messages().as_ptr(),
+                result.messages().as_ptr()
+            ));
+        }
+
+        #[test]
+        fn should_compare_cleaning_data_crcs_with_known_plugin_crc() {
+            let mut plugin = PluginMetadata::new("missing.esp").unwrap();
+            let info1 = PluginCleaningData::new(0xDEAD_BEEF, "utility1".into());
+            let info2 = PluginCleaningData::new(0x374E_2A6F, "utility2".into());
+            let info3 = PluginCleaningData::new(0xDEAD_BEEF, "utility3".into())
+                .with_condition("file(\"missing.esp\")".into());
+            plugin.set_dirty_info(vec![info1.clone(), info2, info3]);
+
+            let mut evaluator = ConditionEvaluator::new(loot_condition_interpreter::State::new(
+                loot_condition_interpreter::GameType::Oblivion,
+                source_plugins_path(crate::GameType::Oblivion),
+            ));
+            evaluator.set_loaded_plugins(&[], &[("MISSING.esp", 0xDEAD_BEEF)]);
+            let result = evaluate_all_conditions(plugin, &evaluator)
+                .unwrap()
+                .unwrap();
+
+            assert_eq!(&[info1], result.dirty_info());
+        }
+
         #[test]
         fn should_return_none_if_evaluated_plugin_metadata_has_name_only() {
             let mut plugin = PluginMetadata::new(BLANK_ESM).unwrap();
@@ -187,38 +505,171 @@ mod tests {
                 .with_condition("file(\"missing.esp\")".into());
             plugin.set_load_after_files(vec![file]);
 
-            let state = loot_condition_interpreter::State::new(
+            let evaluator = ConditionEvaluator::new(loot_condition_interpreter::State::new(
                 loot_condition_interpreter::GameType::Oblivion,
                 source_plugins_path(crate::GameType::Oblivion),
+            ));
+            assert!(
+                evaluate_all_conditions(plugin, &evaluator)
+                    .unwrap()
+                    .is_none()
             );
-            assert!(evaluate_all_conditions(plugin, &state).unwrap().is_none());
         }
     }
 
-    mod evaluate_condition {
+    mod evaluate_all_conditions_in_parallel {
+        use crate::{
+            metadata::{Message, MessageType},
+            tests::{BLANK_DIFFERENT_ESM, BLANK_ESM, BLANK_ESP, source_plugins_path},
+        };
+
+        use super::*;
+
+        fn evaluator() -> ConditionEvaluator {
+            ConditionEvaluator::new(loot_condition_interpreter::State::new(
+                loot_condition_interpreter::GameType::Oblivion,
+                source_plugins_path(crate::GameType::Oblivion),
+            ))
+        }
+
+        #[test]
+        fn should_evaluate_each_distinct_condition_once() {
+            let condition = "file(\"missing.esp\")".to_owned();
+            let metadata = [BLANK_ESM, BLANK_DIFFERENT_ESM, BLANK_ESP]
+                .into_iter()
+                .map(|name| {
+                    let mut plugin = PluginMetadata::new(name).unwrap();
+                    plugin.set_load_after_files(vec![
+                        File::new(BLANK_ESM.into()).with_condition(condition.clone()),
+                    ]);
+                    plugin.set_messages(vec![
+                        Message::new(MessageType::Say, "content".into())
+                            .with_condition(condition.clone()),
+                    ]);
+                    Some(plugin)
+                })
+                .collect();
+
+            let evaluator = evaluator();
+            let result = evaluate_all_conditions_in_parallel(metadata, &evaluator).unwrap();
+
+            assert_eq!(vec![None, None, None], result);
+            assert_eq!(1, evaluator.cache_stats().misses());
+        }
+
+        #[test]
+        fn should_preserve_the_order_of_the_given_metadata() {
+            let mut plugin = PluginMetadata::new(BLANK_ESP).unwrap();
+            plugin.set_messages(vec![Message::new(MessageType::Say, "content".into())]);
+
+            let evaluator = evaluator();
+            let result =
+                evaluate_all_conditions_in_parallel(vec![None, Some(plugin.clone())], &evaluator)
+                    .unwrap();
+
+            assert_eq!(vec![None, Some(plugin)], result);
+        }
+
+        #[test]
+        fn should_error_if_a_condition_is_invalid() {
+            let mut plugin = PluginMetadata::new(BLANK_ESP).unwrap();
+            plugin.set_messages(vec![
+                Message::new(MessageType::Say, "content".into()).with_condition("invalid".into()),
+            ]);
+
+            assert!(evaluate_all_conditions_in_parallel(vec![Some(plugin)], &evaluator()).is_err());
+        }
+    }
+
+    mod condition_evaluator {
         use crate::tests::source_plugins_path;
 
         use super::*;
 
         #[test]
         fn should_support_version_with_comparator_as_second_parameter() {
-            let mut state = loot_condition_interpreter::State::new(
+            let mut evaluator = ConditionEvaluator::new(loot_condition_interpreter::State::new(
                 loot_condition_interpreter::GameType::Oblivion,
                 source_plugins_path(crate::GameType::Oblivion),
-            );
-            state.set_plugin_versions(&[("Blank.esp", "1.0.0")]);
+            ));
+            evaluator.set_loaded_plugins(&[("Blank.esp", "1.0.0")], &[]);
 
-            assert!(evaluate_condition("version(\"Blank.esp\", ==, \"1.0.0\")", &state).unwrap());
+            assert!(
+                evaluator
+                    .evaluate_str("version(\"Blank.esp\", ==, \"1.0.0\")")
+                    .unwrap()
+            );
         }
 
         #[test]
         fn should_eval_less_than_missing_version_as_false() {
-            let state = loot_condition_interpreter::State::new(
+            let evaluator = ConditionEvaluator::new(loot_condition_interpreter::State::new(
                 loot_condition_interpreter::GameType::Oblivion,
                 source_plugins_path(crate::GameType::Oblivion),
+            ));
+
+            assert!(
+                !evaluator
+                    .evaluate_str("version(\"example.esp\", \"1.0.0\", <)")
+                    .unwrap()
             );
+        }
+
+        #[test]
+        fn set_load_order_state_should_only_invalidate_results_for_changed_plugins() {
+            let mut evaluator = ConditionEvaluator::new(loot_condition_interpreter::State::new(
+                loot_condition_interpreter::GameType::Oblivion,
+                source_plugins_path(crate::GameType::Oblivion),
+            ));
+            evaluator.set_load_order_state(&["Blank.esm", "Blank.esp"], &["Blank.esm"]);
+
+            assert!(evaluator.evaluate_str("active(\"Blank.esm\")").unwrap());
+            assert!(!evaluator.evaluate_str("active(\"Blank.esp\")").unwrap());
+
+            evaluator
+                .set_load_order_state(&["Blank.esm", "Blank.esp"], &["Blank.esm", "Blank.esp"]);
+
+            assert!(evaluator.evaluate_str("active(\"Blank.esm\")").unwrap());
+            assert!(evaluator.evaluate_str("active(\"Blank.esp\")").unwrap());
+
+            let stats = evaluator.cache_stats();
+            assert_eq!(1, stats.hits());
+            assert_eq!(3, stats.misses());
+            assert_eq!(1, stats.invalidations());
+        }
+
+        #[test]
+        fn set_loaded_plugins_should_only_invalidate_results_for_changed_plugins() {
+            let mut evaluator = ConditionEvaluator::new(loot_condition_interpreter::State::new(
+                loot_condition_interpreter::GameType::Oblivion,
+                source_plugins_path(crate::GameType::Oblivion),
+            ));
+            evaluator.set_loaded_plugins(&[("Blank.esp", "1.0.0"), ("Blank.esm", "1.0.0")], &[]);
+
+            let condition1 = "version(\"Blank.esp\", \"1.0.0\", ==)";
+            let condition2 = "version(\"Blank.esm\", \"1.0.0\", ==)";
+            assert!(evaluator.evaluate_str(condition1).unwrap());
+            assert!(evaluator.evaluate_str(condition2).unwrap());
+
+            evaluator.set_loaded_plugins(&[("Blank.esp", "2.0.0"), ("Blank.esm", "1.0.0")], &[]);
+
+            assert!(!evaluator.evaluate_str(condition1).unwrap());
+            assert!(evaluator.evaluate_str(condition2).unwrap());
+            assert_eq!(1, evaluator.cache_stats().invalidations());
+        }
+
+        #[test]
+        fn clear_cache_should_invalidate_all_results() {
+            let mut evaluator = ConditionEvaluator::new(loot_condition_interpreter::State::new(
+                loot_condition_interpreter::GameType::Oblivion,
+                source_plugins_path(crate::GameType::Oblivion),
+            ));
+
+            evaluator.evaluate_str("active(\"Blank.esm\")").unwrap();
+            evaluator.evaluate_str("file(\"Blank.bsa\")").unwrap();
+            evaluator.clear_cache();
 
-            assert!(!evaluate_condition("version(\"example.esp\", \"1.0.0\", <)", &state).unwrap());
+            assert_eq!(2, evaluator.cache_stats().invalidations());
         }
     }
 }
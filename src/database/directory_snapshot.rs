@@ -0,0 +1,202 @@
+use std::{
+    collections::{BTreeMap, HashSet},
+    path::{Path, PathBuf},
+    sync::{PoisonError, RwLock},
+    time::SystemTime,
+};
+
+/// Records the modification times of the directories that cached condition
+/// results depend on the contents of, so that those results only need to be
+/// discarded if a directory's entries may have changed.
+///
+/// Directories are identified by their paths relative to the data path, and
+/// are checked in the data path and each additional data path. A directory's
+/// modification time changes when an entry is added to, removed from or
+/// renamed in it, but not when an existing file is written to or has its
+/// permissions changed.
+///
+/// A change is missed if it's made within the filesystem's timestamp
+/// resolution of when the directory's modification time was recorded, as the
+/// time won't change. Some filesystems have coarse timestamps, e.g. FAT32 has
+/// a resolution of 2 seconds, and network filesystems and Wine's mapped drives
+/// may also report coarse modification times.
+#[derive(Debug, Default)]
+pub(crate) struct DirectorySnapshot {
+    roots: Box<[PathBuf]>,
+    modified_times: RwLock<BTreeMap<PathBuf, Box<[Option<SystemTime>]>>>,
+}
+
+impl DirectorySnapshot {
+    /// Returns false if there are no data paths, so directories can't be
+    /// tracked.
+    pub(crate) fn is_tracking(&self) -> bool {
+        !self.roots.is_empty()
+    }
+
+    pub(crate) fn set_roots(&mut self, roots: Vec<PathBuf>) {
+        self.roots = roots.into_boxed_slice();
+        self.clear();
+    }
+
+    /// Record the given directory's modification times if they haven't
+    /// already been recorded, returning false if they can't be recorded.
+    ///
+    /// This must be called before the directory's contents are read, so that
+    /// any change made after they're read is detected when refreshing.
+    pub(crate) fn record(&self, directory: &Path) -> bool {
+        if !self.is_tracking() {
+            return false;
+        }
+
+        if self
+            .modified_times
+            .read()
+            .is_ok_and(|times| times.contains_key(directory))
+        {
+            return true;
+        }
+
+        let times = modified_times_in(&self.roots, directory);
+
+        // If the lock is poisoned, fall back to not recording the directory.
+        if let Ok(mut modified_times) = self.modified_times.write() {
+            modified_times
+                .entry(directory.to_path_buf())
+                .or_insert(times);
+            true
+        } else {
+            false
+        }
+    }
+
+    /// Check each recorded directory's modification times, returning the
+    /// directories that have changed and recording their new times.
+    pub(crate) fn refresh(&mut self) -> HashSet<PathBuf> {
+        let roots = &self.roots;
+        let modified_times = self
+            .modified_times
+            .get_mut()
+            .unwrap_or_else(PoisonError::into_inner);
+
+        let mut changed = HashSet::new();
+        for (directory, times) in modified_times.iter_mut() {
+            let new_times = modified_times_in(roots, directory);
+            if new_times != *times {
+                *times = new_times;
+                changed.insert(directory.clone());
+            }
+        }
+
+        changed
+    }
+
+    pub(crate) fn clear(&mut self) {
+        self.modified_times
+            .get_mut()
+            .unwrap_or_else(PoisonError::into_inner)
+            .clear();
+    }
+}
+
+fn modified_times_in(roots: &[PathBuf], directory: &Path) -> Box<[Option<SystemTime>]> {
+    roots
+        .iter()
+        .map(|root| {
+            root.join(directory)
+                .metadata()
+                .and_then(|m| m.modified())
+                .ok()
+        })
+        .collect()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn snapshot(root: &Path) -> DirectorySnapshot {
+        let mut snapshot = DirectorySnapshot::default();
+        snapshot.set_roots(vec![root.to_path_buf()]);
+        snapshot
+    }
+
+    #[test]
+    fn record_should_return_false_if_there_are_no_roots() {
+        let snapshot = DirectorySnapshot::default();
+
+        assert!(!snapshot.is_tracking());
+        assert!(!snapshot.record(Path::new("a")));
+    }
+
+    #[test]
+    fn refresh_should_return_nothing_if_no_recorded_directories_have_changed() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let root = tmp_dir.path();
+        std::fs::create_dir_all(root.join("a")).unwrap();
+
+        let mut snapshot = snapshot(root);
+        snapshot.record(Path::new("a"));
+        snapshot.record(Path::new("b"));
+
+        assert!(snapshot.refresh().is_empty());
+    }
+
+    #[test]
+    fn refresh_should_detect_a_recorded_directory_being_removed() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let root = tmp_dir.path();
+        std::fs::create_dir_all(root.join("a")).unwrap();
+        std::fs::create_dir_all(root.join("b")).unwrap();
+
+        let mut snapshot = snapshot(root);
+        snapshot.record(Path::new("a"));
+        snapshot.record(Path::new("b"));
+
+        std::fs::remove_dir(root.join("a")).unwrap();
+
+        assert_eq!(HashSet::from([PathBuf::from("a")]), snapshot.refresh());
+        assert!(snapshot.refresh().is_empty());
+    }
+
+    #[test]
+    fn refresh_should_detect_a_recorded_directory_being_created() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let root = tmp_dir.path();
+
+        let mut snapshot = snapshot(root);
+        snapshot.record(Path::new("a"));
+
+        std::fs::create_dir_all(root.join("a")).unwrap();
+
+        assert_eq!(HashSet::from([PathBuf::from("a")]), snapshot.refresh());
+    }
+
+    #[test]
+    fn record_should_not_overwrite_an_existing_record() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let root = tmp_dir.path();
+
+        let mut snapshot = snapshot(root);
+        snapshot.record(Path::new("a"));
+
+        std::fs::create_dir_all(root.join("a")).unwrap();
+        snapshot.record(Path::new("a"));
+
+        assert_eq!(HashSet::from([PathBuf::from("a")]), snapshot.refresh());
+    }
+
+    #[test]
+    fn clear_should_forget_recorded_directories() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+
+        let root = tmp_dir.path();
+
+        let mut snapshot = snapshot(root);
+        snapshot.record(Path::new("a"));
+        snapshot.clear();
+
+        std::fs::create_dir_all(root.join("a")).unwrap();
+
+        assert!(snapshot.refresh().is_empty());
+    }
+}
@@ -1,16 +1,31 @@
+mod condition_cache;
 mod conditions;
+mod directory_snapshot;
 mod error;
 
-use std::{collections::HashMap, path::Path};
+use std::{
+    collections::HashSet,
+    path::{Path, PathBuf},
+    sync::Arc,
+};
+
+use rayon::iter::{IntoParallelRefIterator, ParallelIterator};
 
-use conditions::{evaluate_all_conditions, evaluate_condition, filter_map_on_condition};
+pub use condition_cache::ConditionCacheStats;
+use conditions::{
+    ConditionEvaluator, evaluate_all_conditions, evaluate_all_conditions_in_parallel,
+    filter_map_on_condition,
+};
 
 use crate::{
-    logging,
     metadata::{
-        Group, Message, PluginMetadata,
+        Condition, Filename, Group, Message, PluginMetadata,
         error::{LoadMetadataError, WriteMetadataError, WriteMetadataErrorReason},
-        metadata_document::{MetadataDocument, MetadataWriteOptions},
+        journal::{self, UserlistChanges},
+        localise::SelectLanguage,
+        metadata_document::{
+            LoadedMetadata, MetadataChanges, MetadataDocument, MetadataWriteOptions,
+        },
     },
     sorting::{
         error::GroupsPathError,
@@ -44,32 +59,64 @@ pub enum EvalMode {
 /// The interface through which metadata can be accessed.
 #[derive(Debug)]
 pub struct Database {
-    masterlist: MetadataDocument,
-    userlist: MetadataDocument,
-    condition_evaluator_state: loot_condition_interpreter::State,
+    // The metadata documents are shared with any game snapshots that were
+    // taken while they were loaded, and are copied on write if they're shared.
+    masterlist: Arc<MetadataDocument>,
+    // The path that the masterlist was loaded from.
+    masterlist_path: PathBuf,
+    userlist: Arc<MetadataDocument>,
+    // The userlist changes that haven't been written to its journal.
+    userlist_changes: UserlistChanges,
+    condition_evaluator: ConditionEvaluator,
 }
 
 impl Database {
     #[must_use]
     pub(crate) fn new(condition_evaluator_state: loot_condition_interpreter::State) -> Self {
         Self {
-            masterlist: MetadataDocument::default(),
-            userlist: MetadataDocument::default(),
-            condition_evaluator_state,
+            masterlist: Arc::default(),
+            masterlist_path: PathBuf::new(),
+            userlist: Arc::default(),
+            userlist_changes: UserlistChanges::default(),
+            condition_evaluator: ConditionEvaluator::new(condition_evaluator_state),
         }
     }
 
-    pub(crate) fn condition_evaluator_state_mut(
-        &mut self,
-    ) -> &mut loot_condition_interpreter::State {
-        &mut self.condition_evaluator_state
+    /// Create a database that shares this database's loaded metadata, but
+    /// evaluates conditions using the given state.
+    #[must_use]
+    pub(crate) fn with_shared_metadata(
+        &self,
+        condition_evaluator_state: loot_condition_interpreter::State,
+    ) -> Self {
+        Self {
+            masterlist: Arc::clone(&self.masterlist),
+            masterlist_path: self.masterlist_path.clone(),
+            userlist: Arc::clone(&self.userlist),
+            userlist_changes: UserlistChanges::default(),
+            condition_evaluator: ConditionEvaluator::new(condition_evaluator_state),
+        }
+    }
+
+    pub(crate) fn condition_evaluator_mut(&mut self) -> &mut ConditionEvaluator {
+        &mut self.condition_evaluator
     }
 
     /// Loads the masterlist from the given path.
     ///
     /// Replaces any existing data that was previously loaded from a masterlist.
+    ///
+    /// A compiled copy of the masterlist's metadata is used if it's up to date,
+    /// and is otherwise written: see [`LoadedMetadata::load_masterlist`]. To
+    /// check that all of a compiled copy's metadata is valid, load it using
+    /// that function, call [`LoadedMetadata::validate`] and then pass it to
+    /// [`Database::set_masterlist`].
+    ///
+    /// If another database has already loaded the same masterlist content from
+    /// the same path, the two databases share one copy of its metadata.
     pub fn load_masterlist(&mut self, path: &Path) -> Result<(), LoadMetadataError> {
-        self.masterlist.load(path)
+        self.set_masterlist(LoadedMetadata::load_masterlist(path)?);
+        Ok(())
     }
 
     /// Loads the masterlist from the given path, using the prelude at the given
@@ -82,21 +129,126 @@ impl Database {
         masterlist_path: &Path,
         prelude_path: &Path,
     ) -> Result<(), LoadMetadataError> {
-        self.masterlist
-            .load_with_prelude(masterlist_path, prelude_path)
+        self.set_masterlist(LoadedMetadata::load_masterlist_with_prelude(
+            masterlist_path,
+            prelude_path,
+        )?);
+        Ok(())
+    }
+
+    /// Loads the masterlist from the given path to replace the currently-loaded
+    /// masterlist, and returns the differences between them.
+    ///
+    /// Unlike [`Database::load_masterlist`], metadata that is unchanged from
+    /// the currently-loaded masterlist is kept, along with any work that has
+    /// already been done to decode it, parse its conditions or compile its
+    /// regexes, so that only changed metadata needs to be processed again. The
+    /// returned changes can be used to decide which plugins' derived data
+    /// needs to be updated.
+    ///
+    /// Comparing the masterlists decodes any of their plugin metadata that
+    /// hasn't yet been decoded, so this is slower than
+    /// [`Database::load_masterlist`] if most of the masterlist has changed.
+    ///
+    /// To reload the masterlist without holding exclusive access to the
+    /// database while it's read, parsed and compared, use
+    /// [`LoadedMetadata::reload_masterlist`] with
+    /// [`Database::loaded_masterlist`] and
+    /// [`Database::replace_masterlist`] instead.
+    pub fn reload_masterlist(&mut self, path: &Path) -> Result<MetadataChanges, LoadMetadataError> {
+        let (masterlist, changes) =
+            LoadedMetadata::reload_masterlist(path, &self.loaded_masterlist())?;
+        self.set_masterlist(masterlist);
+        Ok(changes)
+    }
+
+    /// Loads the masterlist from the given path, using the prelude at the given
+    /// path, to replace the currently-loaded masterlist, and returns the
+    /// differences between them.
+    ///
+    /// See [`Database::reload_masterlist`] for details.
+    pub fn reload_masterlist_with_prelude(
+        &mut self,
+        masterlist_path: &Path,
+        prelude_path: &Path,
+    ) -> Result<MetadataChanges, LoadMetadataError> {
+        let (masterlist, changes) = LoadedMetadata::reload_masterlist_with_prelude(
+            masterlist_path,
+            prelude_path,
+            &self.loaded_masterlist(),
+        )?;
+        self.set_masterlist(masterlist);
+        Ok(changes)
+    }
+
+    /// Replaces any existing data that was previously loaded from a masterlist
+    /// and prelude with the given metadata.
+    ///
+    /// This can be used to load a masterlist without holding exclusive access
+    /// to the database while it's read and parsed.
+    pub fn set_masterlist(&mut self, masterlist: LoadedMetadata) {
+        (self.masterlist, self.masterlist_path) = masterlist.into_parts();
+    }
+
+    /// Get the metadata that was loaded from a masterlist.
+    ///
+    /// The metadata is shared with the database, so this is cheap.
+    pub fn loaded_masterlist(&self) -> LoadedMetadata {
+        LoadedMetadata::new(Arc::clone(&self.masterlist), &self.masterlist_path)
+    }
+
+    /// Replaces the data that was previously loaded from a masterlist with
+    /// the given metadata, but only if the previously-loaded data is
+    /// `previous`, returning `false` and leaving the database unchanged if it
+    /// isn't.
+    ///
+    /// This can be used to give the database a masterlist that was reloaded
+    /// using [`LoadedMetadata::reload_masterlist`], as the returned changes
+    /// are only correct if the masterlist hasn't been replaced since
+    /// `previous` was taken from the database.
+    pub fn replace_masterlist(
+        &mut self,
+        previous: &LoadedMetadata,
+        masterlist: LoadedMetadata,
+    ) -> bool {
+        if !previous.is_document(&self.masterlist) {
+            return false;
+        }
+
+        self.set_masterlist(masterlist);
+        true
     }
 
     /// Loads the userlist from the given path.
     ///
     /// Replaces any existing data that was previously loaded from a userlist.
+    ///
+    /// Any changes that were written to the userlist's journal using
+    /// [`Database::write_user_metadata_changes`] are applied after the userlist
+    /// is loaded.
     pub fn load_userlist(&mut self, path: &Path) -> Result<(), LoadMetadataError> {
-        self.userlist.load(path)
+        self.set_userlist(LoadedMetadata::load(path)?);
+        Ok(())
+    }
+
+    /// Replaces any existing data that was previously loaded from a userlist
+    /// with the given metadata.
+    ///
+    /// This can be used to load a userlist without holding exclusive access to
+    /// the database while it's read and parsed.
+    pub fn set_userlist(&mut self, userlist: LoadedMetadata) {
+        self.userlist = userlist.into_document();
+        self.userlist_changes = UserlistChanges::default();
     }
 
     /// Writes a metadata file containing all loaded user-added metadata.
     ///
     /// If `output_path` already exists, it will be written if `overwrite` is
     /// `true`, otherwise no data will be written.
+    ///
+    /// If `output_path` has a journal of changes written by
+    /// [`Database::write_user_metadata_changes`], the journal is removed, as
+    /// its changes are included in the written file.
     pub fn write_user_metadata(
         &self,
         output_path: &Path,
@@ -104,7 +256,49 @@ impl Database {
     ) -> Result<(), WriteMetadataError> {
         validate_write_path(output_path, options)?;
 
-        self.userlist.save(output_path, options)
+        self.userlist.save(output_path, options)?;
+
+        journal::remove(output_path)
+    }
+
+    /// Writes the changes made to the loaded user metadata since the userlist
+    /// was loaded or its changes were last written, without rewriting the
+    /// whole userlist.
+    ///
+    /// The changes are appended to a journal alongside the userlist at the
+    /// given path, with `.journal` appended to its filename, so the time taken
+    /// depends on the size of the changes and not the size of the userlist.
+    /// The journal is applied when the userlist is next loaded. Once the
+    /// journal is as large as the userlist, it's compacted by writing all the
+    /// user metadata to the userlist using the given options (overwriting the
+    /// existing file) and removing the journal. The userlist is also written
+    /// if it doesn't exist.
+    ///
+    /// The journal records the content of the userlist that its changes were
+    /// written against, and if the userlist's content has changed by the time
+    /// it's next loaded (e.g. because it was restored from a backup), the
+    /// journal is ignored and removed.
+    pub fn write_user_metadata_changes(
+        &mut self,
+        userlist_path: &Path,
+        options: &MetadataWriteOptions,
+    ) -> Result<(), WriteMetadataError> {
+        if self.userlist_changes.is_empty() {
+            return Ok(());
+        }
+
+        let mut options = options.clone();
+        options.set_truncate(true);
+        validate_write_path(userlist_path, &options)?;
+
+        let journal_size = journal::append(userlist_path, &self.userlist, &self.userlist_changes)?;
+        self.userlist_changes = UserlistChanges::default();
+
+        if journal::should_compact(userlist_path, journal_size) {
+            self.write_user_metadata(userlist_path, &options)?;
+        }
+
+        Ok(())
     }
 
     /// Writes a metadata file that only contains plugin Bash Tag suggestions
@@ -134,7 +328,35 @@ impl Database {
 
     /// Evaluate the given condition string.
     pub fn evaluate(&self, condition: &str) -> Result<bool, ConditionEvaluationError> {
-        evaluate_condition(condition, &self.condition_evaluator_state).map_err(Into::into)
+        self.condition_evaluator
+            .evaluate_str(condition)
+            .map_err(Into::into)
+    }
+
+    /// Evaluate each of the given condition strings, returning their results in
+    /// the same order.
+    ///
+    /// This gives the same results as calling [`Database::evaluate`] for each
+    /// condition, but the conditions are parsed and evaluated in parallel. If
+    /// any condition is invalid, an error is returned.
+    pub fn evaluate_many(
+        &self,
+        conditions: &[&str],
+    ) -> Result<Vec<bool>, ConditionEvaluationError> {
+        conditions
+            .par_iter()
+            .map(|c| self.condition_evaluator.evaluate_str(c))
+            .collect::<Result<Vec<_>, _>>()
+            .map_err(Into::into)
+    }
+
+    pub(crate) fn evaluate_parsed(
+        &self,
+        condition: &Condition,
+    ) -> Result<bool, ConditionEvaluationError> {
+        self.condition_evaluator
+            .evaluate(condition)
+            .map_err(Into::into)
     }
 
     /// Clears the cache of metadata condition evaluation results.
@@ -147,10 +369,16 @@ impl Database {
     /// evaluated, it will be evaluated from scratch instead of using a cached
     /// result.
     pub fn clear_condition_cache(&mut self) {
-        if let Err(e) = self.condition_evaluator_state.clear_condition_cache() {
-            logging::error!("The condition cache's lock is poisoned, assigning a new cache");
-            *e.into_inner() = HashMap::new();
-        }
+        self.condition_evaluator.clear_cache();
+    }
+
+    /// Get counts of how the condition cache has been used since this database
+    /// was created.
+    ///
+    /// Cached results are invalidated when they're cleared, and when the state
+    /// of a plugin that they may depend on changes.
+    pub fn condition_cache_stats(&self) -> ConditionCacheStats {
+        self.condition_evaluator.cache_stats()
     }
 
     /// Gets the Bash Tags that are listed in the loaded metadata lists.
@@ -176,7 +404,8 @@ impl Database {
     /// Sets the known Bash Tags to store in the userlist, replacing any
     /// existing values stored there.
     pub fn set_user_known_bash_tags(&mut self, bash_tags: Vec<String>) {
-        self.userlist.set_bash_tags(bash_tags);
+        Arc::make_mut(&mut self.userlist).set_bash_tags(bash_tags);
+        self.userlist_changes.set_bash_tags();
     }
 
     /// Get all general messages listed in the loaded metadata lists.
@@ -190,18 +419,38 @@ impl Database {
         if include_user_metadata == MergeMode::WithUserMetadata {
             process_messages(
                 messages_iter.chain(self.userlist.messages()),
-                &self.condition_evaluator_state,
+                &self.condition_evaluator,
                 evaluate_conditions,
             )
         } else {
             process_messages(
                 messages_iter,
-                &self.condition_evaluator_state,
+                &self.condition_evaluator,
                 evaluate_conditions,
             )
         }
     }
 
+    /// Get all general messages listed in the loaded metadata lists, with each
+    /// message's content reduced to the content for the given language.
+    ///
+    /// This gives the same messages as [`Database::general_messages`], except
+    /// that each message with content in more than one language only keeps
+    /// the content that
+    /// [`select_message_content`](crate::metadata::select_message_content)
+    /// chooses for the given language. This avoids returning translations that
+    /// a caller that displays one language would discard.
+    pub fn localised_general_messages(
+        &self,
+        language: &str,
+        include_user_metadata: MergeMode,
+        evaluate_conditions: EvalMode,
+    ) -> Result<Vec<Message>, ConditionEvaluationError> {
+        let mut messages = self.general_messages(include_user_metadata, evaluate_conditions)?;
+        messages.select_language(language);
+        Ok(messages)
+    }
+
     /// Get all general messages listed in the loaded userlist.
     pub fn user_general_messages(
         &self,
@@ -209,7 +458,7 @@ impl Database {
     ) -> Result<Vec<Message>, ConditionEvaluationError> {
         process_messages(
             self.userlist.messages().iter(),
-            &self.condition_evaluator_state,
+            &self.condition_evaluator,
             evaluate_conditions,
         )
     }
@@ -217,7 +466,8 @@ impl Database {
     /// Sets the general messages to store in the userlist, replacing any
     /// existing values stored there.
     pub fn set_user_general_messages(&mut self, general_messages: Vec<Message>) {
-        self.userlist.set_messages(general_messages);
+        Arc::make_mut(&mut self.userlist).set_messages(general_messages);
+        self.userlist_changes.set_messages();
     }
 
     /// Gets the groups that are defined in the loaded metadata lists.
@@ -237,7 +487,8 @@ impl Database {
     /// Sets the group definitions to store in the userlist, replacing any
     /// definitions already loaded from the userlist.
     pub fn set_user_groups(&mut self, groups: Vec<Group>) {
-        self.userlist.set_groups(groups);
+        Arc::make_mut(&mut self.userlist).set_groups(groups);
+        self.userlist_changes.set_groups();
     }
 
     /// Get the "shortest" path between the two given groups according to their
@@ -267,6 +518,69 @@ impl Database {
         plugin_name: &str,
         include_user_metadata: MergeMode,
         evaluate_conditions: EvalMode,
+    ) -> Result<Option<PluginMetadata>, MetadataRetrievalError> {
+        let metadata = self.unevaluated_plugin_metadata(plugin_name, include_user_metadata)?;
+
+        if evaluate_conditions == EvalMode::Evaluate
+            && let Some(metadata) = metadata
+        {
+            evaluate_all_conditions(metadata, &self.condition_evaluator).map_err(Into::into)
+        } else {
+            Ok(metadata)
+        }
+    }
+
+    /// Get all of a plugin's loaded metadata, with its message content and its
+    /// files' and cleaning data's detail reduced to the content for the given
+    /// language.
+    ///
+    /// Like [`Database::localised_general_messages`], this gives the same
+    /// metadata as [`Database::plugin_metadata`] without the content in other
+    /// languages.
+    pub fn localised_plugin_metadata(
+        &self,
+        plugin_name: &str,
+        language: &str,
+        include_user_metadata: MergeMode,
+        evaluate_conditions: EvalMode,
+    ) -> Result<Option<PluginMetadata>, MetadataRetrievalError> {
+        let mut metadata =
+            self.plugin_metadata(plugin_name, include_user_metadata, evaluate_conditions)?;
+        if let Some(metadata) = &mut metadata {
+            metadata.select_language(language);
+        }
+        Ok(metadata)
+    }
+
+    /// Get all of the loaded metadata for each of the given plugins.
+    ///
+    /// This gives the same results as calling [`Database::plugin_metadata`] for
+    /// each plugin, in the same order as the given plugins, but the plugins'
+    /// metadata is retrieved and evaluated in parallel, and each distinct
+    /// condition is only evaluated once.
+    pub fn plugins_metadata(
+        &self,
+        plugin_names: &[&str],
+        include_user_metadata: MergeMode,
+        evaluate_conditions: EvalMode,
+    ) -> Result<Vec<Option<PluginMetadata>>, MetadataRetrievalError> {
+        let metadata = plugin_names
+            .par_iter()
+            .map(|n| self.unevaluated_plugin_metadata(n, include_user_metadata))
+            .collect::<Result<Vec<_>, _>>()?;
+
+        if evaluate_conditions == EvalMode::Evaluate {
+            evaluate_all_conditions_in_parallel(metadata, &self.condition_evaluator)
+                .map_err(Into::into)
+        } else {
+            Ok(metadata)
+        }
+    }
+
+    fn unevaluated_plugin_metadata(
+        &self,
+        plugin_name: &str,
+        include_user_metadata: MergeMode,
     ) -> Result<Option<PluginMetadata>, MetadataRetrievalError> {
         let mut metadata = self.masterlist.find_plugin(plugin_name)?;
 
@@ -279,13 +593,84 @@ impl Database {
             metadata = Some(user_metadata);
         }
 
-        if evaluate_conditions == EvalMode::Evaluate
-            && let Some(metadata) = metadata
-        {
-            evaluate_all_conditions(metadata, &self.condition_evaluator_state).map_err(Into::into)
+        Ok(metadata)
+    }
+
+    /// Get the names of the plugin metadata entries that reference the given
+    /// file in their load after, requirement or incompatibility metadata.
+    ///
+    /// Conditions are not evaluated, and entries with regex names are listed
+    /// by their regex. Masterlist entries are listed first, followed by any
+    /// userlist entries that don't have the same name as a masterlist entry.
+    ///
+    /// The loaded metadata is indexed by the files that it references when
+    /// this is first called after the metadata changes, so that subsequent
+    /// calls don't need to look at every plugin's metadata.
+    pub fn plugins_referencing(
+        &self,
+        filename: &str,
+        include_user_metadata: MergeMode,
+    ) -> Vec<String> {
+        let mut names = UniqueNames::default();
+        names.extend(self.masterlist.plugins_referencing(filename));
+
+        if include_user_metadata == MergeMode::WithUserMetadata {
+            names.extend(self.userlist.plugins_referencing(filename));
+        }
+
+        names.into_vec()
+    }
+
+    /// Get the names of the plugin metadata entries that are in the given
+    /// group.
+    ///
+    /// Entries with regex names are listed by their regex. Entries that don't
+    /// have a group are in the default group, but plugins that have no
+    /// metadata entries aren't listed. When user metadata is included, an
+    /// entry is not listed if merging it with the entry with the same name in
+    /// the other metadata list puts the plugin in a different group.
+    /// Masterlist entries are listed first, followed by any userlist entries
+    /// that don't have the same name as a masterlist entry.
+    ///
+    /// Like [`Database::plugins_referencing`], this uses an index of the loaded
+    /// metadata.
+    pub fn plugins_in_group(
+        &self,
+        group_name: &str,
+        include_user_metadata: MergeMode,
+    ) -> Vec<String> {
+        let mut names = UniqueNames::default();
+
+        if include_user_metadata == MergeMode::WithoutUserMetadata {
+            names.extend(self.masterlist.plugins_in_group(group_name));
         } else {
-            Ok(metadata)
+            names.extend(
+                self.masterlist
+                    .plugins_in_group(group_name)
+                    .iter()
+                    .filter(|name| {
+                        self.userlist
+                            .plugin_entry_group(name)
+                            .is_none_or(|group| group == group_name)
+                    }),
+            );
+            // A userlist entry without a group doesn't override the group of
+            // the masterlist entry with the same name.
+            names.extend(
+                self.userlist
+                    .plugins_in_group(group_name)
+                    .iter()
+                    .filter(|name| {
+                        self.userlist.plugin_entry_group(name).is_some()
+                            || self
+                                .masterlist
+                                .plugin_entry_group(name)
+                                .is_none_or(|group| group == group_name)
+                    }),
+            );
         }
+
+        names.into_vec()
     }
 
     /// Get a plugin's metadata loaded from the loaded userlist.
@@ -299,7 +684,7 @@ impl Database {
         if evaluate_conditions == EvalMode::Evaluate
             && let Some(metadata) = metadata
         {
-            evaluate_all_conditions(metadata, &self.condition_evaluator_state).map_err(Into::into)
+            evaluate_all_conditions(metadata, &self.condition_evaluator).map_err(Into::into)
         } else {
             Ok(metadata)
         }
@@ -314,7 +699,8 @@ impl Database {
     /// be appended to the list of regex metadata entries, and any existing
     /// entries with the same regex name will be retained.
     pub fn set_plugin_user_metadata(&mut self, plugin_metadata: PluginMetadata) {
-        self.userlist.set_plugin_metadata(plugin_metadata);
+        self.userlist_changes.set_plugin(plugin_metadata.name());
+        Arc::make_mut(&mut self.userlist).set_plugin_metadata(plugin_metadata);
     }
 
     /// Discards all loaded user metadata that is specific to the plugin
@@ -325,13 +711,40 @@ impl Database {
     /// equal to the given name will be removed. Regex name matching is not
     /// performed.
     pub fn discard_plugin_user_metadata(&mut self, plugin_name: &str) {
-        self.userlist.remove_plugin_metadata(plugin_name);
+        Arc::make_mut(&mut self.userlist).remove_plugin_metadata(plugin_name);
+        self.userlist_changes.set_plugin(plugin_name);
     }
 
     /// Discards all loaded user metadata for all groups, plugins, and any
     /// user-added general messages and known bash tags.
     pub fn discard_all_user_metadata(&mut self) {
-        self.userlist.clear();
+        Arc::make_mut(&mut self.userlist).clear();
+        self.userlist_changes.discard_all();
+    }
+}
+
+/// Collects plugin metadata entry names, ignoring any name that's
+/// case-insensitively equal to a name that's already been collected: regex
+/// entries in the same document may have the same name, and userlist entries
+/// may have the same name as masterlist entries.
+#[derive(Debug, Default)]
+struct UniqueNames {
+    names: Vec<String>,
+    seen: HashSet<Filename>,
+}
+
+impl UniqueNames {
+    fn extend<'a>(&mut self, names: impl IntoIterator<Item = &'a Arc<str>>) {
+        for name in names {
+            let name: &str = name;
+            if self.seen.insert(Filename::new(name.to_owned())) {
+                self.names.push(name.to_owned());
+            }
+        }
+    }
+
+    fn into_vec(self) -> Vec<String> {
+        self.names
     }
 }
 
@@ -392,12 +805,12 @@ fn merge_groups(lhs: &[Group], rhs: &[Group]) -> Vec<Group> {
 
 fn process_messages<'a, I: Iterator<Item = &'a Message>>(
     messages_iter: I,
-    condition_evaluator_state: &loot_condition_interpreter::State,
+    condition_evaluator: &ConditionEvaluator,
     evaluate_conditions: EvalMode,
 ) -> Result<Vec<Message>, ConditionEvaluationError> {
     if evaluate_conditions == EvalMode::Evaluate {
         let messages = messages_iter
-            .filter_map(|m| filter_map_on_condition(m, m.condition(), condition_evaluator_state))
+            .filter_map(|m| filter_map_on_condition(m, m.parsed_condition(), condition_evaluator))
             .collect::<Result<Vec<_>, _>>()?;
 
         Ok(messages)
@@ -408,8 +821,6 @@ fn process_messages<'a, I: Iterator<Item = &'a Message>>(
 
 #[cfg(test)]
 mod tests {
-    use std::path::PathBuf;
-
     use crate::{
         EdgeType, GameType,
         metadata::{File, MessageType},
@@ -543,6 +954,66 @@ plugins:
         );
     }
 
+    #[test]
+    fn reload_masterlist_should_replace_the_masterlist_and_return_its_changes() {
+        let fixture = Fixture::new(GameType::Oblivion);
+        let mut database = fixture.database();
+
+        database.load_masterlist(&fixture.metadata_path).unwrap();
+
+        let masterlist_path = fixture.inner.local_path.join("masterlist.yaml");
+        std::fs::write(&masterlist_path, "bash_tags: [Relev]").unwrap();
+
+        let changes = database.reload_masterlist(&masterlist_path).unwrap();
+
+        assert!(changes.bash_tags_changed());
+        assert!(!changes.changed_plugins().is_empty());
+        assert_eq!(
+            &["Relev"],
+            database
+                .known_bash_tags(MergeMode::WithUserMetadata)
+                .as_slice()
+        );
+
+        let changes = database.reload_masterlist(&masterlist_path).unwrap();
+
+        assert!(changes.is_empty());
+    }
+
+    #[test]
+    fn replace_masterlist_should_only_replace_the_masterlist_if_it_has_not_changed() {
+        let fixture = Fixture::new(GameType::Oblivion);
+        let mut database = fixture.database();
+
+        database.load_masterlist(&fixture.metadata_path).unwrap();
+        let previous = database.loaded_masterlist();
+
+        let masterlist_path = fixture.inner.local_path.join("masterlist.yaml");
+        std::fs::write(&masterlist_path, "bash_tags: [Relev]").unwrap();
+
+        let (masterlist, changes) =
+            LoadedMetadata::reload_masterlist(&masterlist_path, &previous).unwrap();
+        assert!(changes.bash_tags_changed());
+
+        database.set_masterlist(LoadedMetadata::load(&fixture.metadata_path).unwrap());
+        assert!(!database.replace_masterlist(&previous, masterlist.clone()));
+        assert_ne!(
+            &["Relev"],
+            database
+                .known_bash_tags(MergeMode::WithoutUserMetadata)
+                .as_slice()
+        );
+
+        let previous = database.loaded_masterlist();
+        assert!(database.replace_masterlist(&previous, masterlist));
+        assert_eq!(
+            &["Relev"],
+            database
+                .known_bash_tags(MergeMode::WithoutUserMetadata)
+                .as_slice()
+        );
+    }
+
     #[test]
     fn load_userlist_should_succeed_if_given_a_valid_path() {
         let fixture = Fixture::new(GameType::Oblivion);
@@ -566,6 +1037,46 @@ plugins:
         );
     }
 
+    #[test]
+    fn set_masterlist_and_set_userlist_should_replace_only_their_metadata() {
+        let fixture = Fixture::new(GameType::Oblivion);
+        let mut database = fixture.database();
+
+        database.load_masterlist(&fixture.metadata_path).unwrap();
+        database.load_userlist(&fixture.metadata_path).unwrap();
+
+        let masterlist = LoadedMetadata::load_masterlist_with_prelude(
+            &fixture.metadata_path,
+            &fixture.prelude_path,
+        )
+        .unwrap();
+        database.set_masterlist(masterlist);
+
+        assert_eq!(
+            &["Actors.ACBS", "C.Climate"],
+            database
+                .known_bash_tags(MergeMode::WithUserMetadata)
+                .as_slice()
+        );
+        assert_eq!(
+            &["Actors.ACBS"],
+            database
+                .known_bash_tags(MergeMode::WithoutUserMetadata)
+                .as_slice()
+        );
+
+        let userlist_path = fixture.inner.local_path.join("userlist.yaml");
+        std::fs::write(&userlist_path, "bash_tags: [Relev]").unwrap();
+        database.set_userlist(LoadedMetadata::load(&userlist_path).unwrap());
+
+        assert_eq!(
+            &["Actors.ACBS", "Relev"],
+            database
+                .known_bash_tags(MergeMode::WithUserMetadata)
+                .as_slice()
+        );
+    }
+
     mod write_user_metadata {
         use super::*;
 
@@ -715,11 +1226,123 @@ plugins:
 
             std::fs::File::create(&output_path).unwrap();
 
-            assert!(
-                database
-                    .write_user_metadata(&output_path, &MetadataWriteOptions::new())
-                    .is_err()
-            );
+            assert!(
+                database
+                    .write_user_metadata(&output_path, &MetadataWriteOptions::new())
+                    .is_err()
+            );
+        }
+    }
+
+    mod write_user_metadata_changes {
+        use super::*;
+
+        fn plugin(name: &str, group: &str) -> PluginMetadata {
+            let mut plugin = PluginMetadata::new(name).unwrap();
+            plugin.set_group(group.into());
+            plugin
+        }
+
+        #[test]
+        fn should_write_the_userlist_if_it_does_not_exist() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let mut database = fixture.database();
+            let userlist_path = fixture.inner.local_path.join("userlist.yaml");
+
+            database.set_plugin_user_metadata(plugin("Blank.esp", "group1"));
+            database
+                .write_user_metadata_changes(&userlist_path, &MetadataWriteOptions::new())
+                .unwrap();
+
+            assert!(userlist_path.exists());
+            assert!(
+                !fixture
+                    .inner
+                    .local_path
+                    .join("userlist.yaml.journal")
+                    .exists()
+            );
+        }
+
+        #[test]
+        fn should_append_changes_that_are_applied_when_the_userlist_is_loaded() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let mut database = fixture.database();
+            let userlist_path = fixture.inner.local_path.join("userlist.yaml");
+
+            database.set_plugin_user_metadata(plugin("Blank.esp", "group1"));
+            database.set_plugin_user_metadata(plugin("Blank.esm", "group1"));
+            database
+                .write_user_metadata(&userlist_path, &MetadataWriteOptions::new())
+                .unwrap();
+            let userlist = std::fs::read_to_string(&userlist_path).unwrap();
+
+            database.set_plugin_user_metadata(plugin("Blank.esp", "group2"));
+            database.discard_plugin_user_metadata("Blank.esm");
+            database.set_user_known_bash_tags(vec!["Relev".into()]);
+            database
+                .write_user_metadata_changes(&userlist_path, &MetadataWriteOptions::new())
+                .unwrap();
+
+            assert_eq!(userlist, std::fs::read_to_string(&userlist_path).unwrap());
+            assert!(
+                fixture
+                    .inner
+                    .local_path
+                    .join("userlist.yaml.journal")
+                    .exists()
+            );
+
+            let mut database = fixture.database();
+            database.load_userlist(&userlist_path).unwrap();
+
+            let metadata = database
+                .plugin_user_metadata("Blank.esp", EvalMode::DoNotEvaluate)
+                .unwrap()
+                .unwrap();
+            assert_eq!(Some("group2"), metadata.group());
+            assert!(
+                database
+                    .plugin_user_metadata("Blank.esm", EvalMode::DoNotEvaluate)
+                    .unwrap()
+                    .is_none()
+            );
+            assert_eq!(&["Relev"], database.user_known_bash_tags());
+        }
+
+        #[test]
+        fn should_do_nothing_if_there_are_no_changes() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let mut database = fixture.database();
+            let userlist_path = fixture.inner.local_path.join("userlist.yaml");
+
+            database
+                .write_user_metadata_changes(&userlist_path, &MetadataWriteOptions::new())
+                .unwrap();
+
+            assert!(!userlist_path.exists());
+        }
+
+        #[test]
+        fn write_user_metadata_should_remove_the_journal() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let mut database = fixture.database();
+            let userlist_path = fixture.inner.local_path.join("userlist.yaml");
+            let journal_path = fixture.inner.local_path.join("userlist.yaml.journal");
+
+            database
+                .write_user_metadata(&userlist_path, &MetadataWriteOptions::new())
+                .unwrap();
+            database.set_plugin_user_metadata(plugin("Blank.esp", "group1"));
+            database
+                .write_user_metadata_changes(&userlist_path, &MetadataWriteOptions::new())
+                .unwrap();
+            assert!(journal_path.exists());
+
+            database
+                .write_user_metadata(&userlist_path, &truncate_options())
+                .unwrap();
+            assert!(!journal_path.exists());
         }
     }
 
@@ -912,6 +1535,60 @@ plugins:
         }
     }
 
+    mod evaluate_many {
+        use super::*;
+
+        #[test]
+        fn should_return_the_result_of_each_condition_in_the_given_order() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let database = fixture.database();
+
+            let results = database
+                .evaluate_many(&[
+                    "file(\"missing.esp\")",
+                    "file(\"Blank.esp\")",
+                    "file(\"missing.esp\")",
+                ])
+                .unwrap();
+
+            assert_eq!(vec![false, true, false], results);
+        }
+
+        #[test]
+        fn should_return_an_empty_vec_if_given_no_conditions() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let database = fixture.database();
+
+            assert!(database.evaluate_many(&[]).unwrap().is_empty());
+        }
+
+        #[test]
+        fn should_error_if_any_condition_is_invalid() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let database = fixture.database();
+
+            assert!(
+                database
+                    .evaluate_many(&["file(\"Blank.esp\")", "invalid"])
+                    .is_err()
+            );
+        }
+
+        #[test]
+        fn should_share_the_condition_cache() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let database = fixture.database();
+
+            assert!(database.evaluate("file(\"Blank.esp\")").unwrap());
+            assert_eq!(
+                vec![true],
+                database.evaluate_many(&["file(\"Blank.esp\")"]).unwrap()
+            );
+
+            assert_eq!(1, database.condition_cache_stats().hits());
+        }
+    }
+
     #[test]
     fn clear_condition_cache_should_cause_conditions_to_be_evaluated_from_scratch() {
         let fixture = Fixture::new(GameType::Oblivion);
@@ -1424,6 +2101,334 @@ plugins:
         }
     }
 
+    mod plugins_metadata {
+        use super::*;
+
+        #[test]
+        fn should_return_the_same_metadata_as_plugin_metadata_in_the_given_order() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let mut database = fixture.database();
+
+            database.load_masterlist(&fixture.metadata_path).unwrap();
+
+            let plugin_names = [BLANK_DIFFERENT_ESM, BLANK_MASTER_DEPENDENT_ESM, BLANK_ESM];
+            for eval_mode in [EvalMode::DoNotEvaluate, EvalMode::Evaluate] {
+                let expected: Vec<_> = plugin_names
+                    .iter()
+                    .map(|n| {
+                        database
+                            .plugin_metadata(n, MergeMode::WithUserMetadata, eval_mode)
+                            .unwrap()
+                    })
+                    .collect();
+
+                let metadata = database
+                    .plugins_metadata(&plugin_names, MergeMode::WithUserMetadata, eval_mode)
+                    .unwrap();
+
+                assert_eq!(expected, metadata);
+            }
+        }
+
+        #[test]
+        fn should_evaluate_conditions_shared_by_plugins_once() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let mut database = fixture.database();
+
+            for name in [BLANK_ESM, BLANK_DIFFERENT_ESM] {
+                let mut plugin = PluginMetadata::new(name).unwrap();
+                plugin.set_messages(vec![
+                    Message::new(MessageType::Say, "content".into())
+                        .with_condition("file(\"missing.esp\")".into()),
+                ]);
+                database.set_plugin_user_metadata(plugin);
+            }
+
+            let metadata = database
+                .plugins_metadata(
+                    &[BLANK_ESM, BLANK_DIFFERENT_ESM],
+                    MergeMode::WithUserMetadata,
+                    EvalMode::Evaluate,
+                )
+                .unwrap();
+
+            assert_eq!(vec![None, None], metadata);
+            assert_eq!(1, database.condition_cache_stats().misses());
+        }
+    }
+
+    mod plugins_referencing {
+        use super::*;
+
+        #[test]
+        fn should_return_masterlist_entries_that_reference_the_file() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let mut database = fixture.database();
+
+            database.load_masterlist(&fixture.metadata_path).unwrap();
+
+            assert_eq!(
+                [
+                    "Blank - Different.esm",
+                    "Blank - Different Master Dependent.esp"
+                ],
+                database
+                    .plugins_referencing(BLANK_MASTER_DEPENDENT_ESM, MergeMode::WithUserMetadata)
+                    .as_slice()
+            );
+            assert!(
+                database
+                    .plugins_referencing("missing.esp", MergeMode::WithUserMetadata)
+                    .is_empty()
+            );
+        }
+
+        #[test]
+        fn should_only_include_user_entries_if_user_metadata_is_included() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let mut database = fixture.database();
+
+            database.load_masterlist(&fixture.metadata_path).unwrap();
+
+            let mut plugin = PluginMetadata::new(BLANK_ESM).unwrap();
+            plugin.set_requirements(vec![File::new(BLANK_MASTER_DEPENDENT_ESM.into())]);
+            database.set_plugin_user_metadata(plugin);
+
+            assert_eq!(
+                [
+                    "Blank - Different.esm",
+                    "Blank - Different Master Dependent.esp",
+                    BLANK_ESM
+                ],
+                database
+                    .plugins_referencing(BLANK_MASTER_DEPENDENT_ESM, MergeMode::WithUserMetadata)
+                    .as_slice()
+            );
+            assert_eq!(
+                2,
+                database
+                    .plugins_referencing(BLANK_MASTER_DEPENDENT_ESM, MergeMode::WithoutUserMetadata)
+                    .len()
+            );
+        }
+
+        #[test]
+        fn should_reflect_changes_to_user_metadata() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let mut database = fixture.database();
+
+            let mut plugin = PluginMetadata::new(BLANK_ESM).unwrap();
+            plugin.set_load_after_files(vec![File::new(BLANK_DIFFERENT_ESM.into())]);
+            database.set_plugin_user_metadata(plugin);
+
+            assert_eq!(
+                [BLANK_ESM],
+                database
+                    .plugins_referencing(BLANK_DIFFERENT_ESM, MergeMode::WithUserMetadata)
+                    .as_slice()
+            );
+
+            database.discard_plugin_user_metadata(BLANK_ESM);
+
+            assert!(
+                database
+                    .plugins_referencing(BLANK_DIFFERENT_ESM, MergeMode::WithUserMetadata)
+                    .is_empty()
+            );
+        }
+    }
+
+    mod plugins_in_group {
+        use super::*;
+
+        fn plugin(name: &str, group: &str) -> PluginMetadata {
+            let mut plugin = PluginMetadata::new(name).unwrap();
+            plugin.set_group(group.into());
+            plugin
+        }
+
+        #[test]
+        fn should_respect_user_group_overrides_if_user_metadata_is_included() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let mut database = fixture.database();
+
+            let masterlist_path = fixture.inner.local_path.join("masterlist.yaml");
+            std::fs::write(
+                &masterlist_path,
+                "plugins:\n  - name: A.esp\n    group: group1\n  - name: B.esp\n    group: group1",
+            )
+            .unwrap();
+            database.load_masterlist(&masterlist_path).unwrap();
+
+            database.set_plugin_user_metadata(plugin("B.esp", "group2"));
+            database.set_plugin_user_metadata(plugin("C.esp", "group1"));
+            database.set_plugin_user_metadata(plugin("a.esp", "group1"));
+
+            assert_eq!(
+                ["A.esp", "B.esp"],
+                database
+                    .plugins_in_group("group1", MergeMode::WithoutUserMetadata)
+                    .as_slice()
+            );
+            assert_eq!(
+                ["A.esp", "C.esp"],
+                database
+                    .plugins_in_group("group1", MergeMode::WithUserMetadata)
+                    .as_slice()
+            );
+            assert_eq!(
+                ["B.esp"],
+                database
+                    .plugins_in_group("group2", MergeMode::WithUserMetadata)
+                    .as_slice()
+            );
+        }
+
+        #[test]
+        fn should_list_entries_without_a_group_in_the_default_group() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let mut database = fixture.database();
+
+            let masterlist_path = fixture.inner.local_path.join("masterlist.yaml");
+            std::fs::write(
+                &masterlist_path,
+                "plugins:\n  - name: A.esp\n  - name: B.esp\n    group: group1\n  - name: C.esp",
+            )
+            .unwrap();
+            database.load_masterlist(&masterlist_path).unwrap();
+
+            database.set_plugin_user_metadata(PluginMetadata::new("B.esp").unwrap());
+            database.set_plugin_user_metadata(plugin("C.esp", "group1"));
+            database.set_plugin_user_metadata(PluginMetadata::new("D.esp").unwrap());
+
+            assert_eq!(
+                ["A.esp", "C.esp"],
+                database
+                    .plugins_in_group(Group::DEFAULT_NAME, MergeMode::WithoutUserMetadata)
+                    .as_slice()
+            );
+            assert_eq!(
+                ["A.esp", "D.esp"],
+                database
+                    .plugins_in_group(Group::DEFAULT_NAME, MergeMode::WithUserMetadata)
+                    .as_slice()
+            );
+            assert_eq!(
+                ["B.esp", "C.esp"],
+                database
+                    .plugins_in_group("group1", MergeMode::WithUserMetadata)
+                    .as_slice()
+            );
+        }
+    }
+
+    mod localised_metadata {
+        use crate::metadata::MessageContent;
+
+        use super::*;
+
+        const MULTILINGUAL_CONTENT: &str = "[{lang: en, text: English}, {lang: fr, text: French}]";
+
+        fn french_content() -> Box<[MessageContent]> {
+            Box::new([MessageContent::new("French".into()).with_language("fr".into())])
+        }
+
+        #[test]
+        fn localised_general_messages_should_keep_only_the_content_for_the_given_language() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let mut database = fixture.database();
+
+            let userlist_path = fixture.inner.local_path.join("userlist.yaml");
+            std::fs::write(
+                &userlist_path,
+                format!(
+                    "globals: [{{type: say, content: {MULTILINGUAL_CONTENT}}}, {{type: say, content: 'A user message'}}]"
+                ),
+            )
+            .unwrap();
+            database.load_userlist(&userlist_path).unwrap();
+
+            let messages = database
+                .localised_general_messages(
+                    "fr",
+                    MergeMode::WithUserMetadata,
+                    EvalMode::DoNotEvaluate,
+                )
+                .unwrap();
+
+            assert_eq!(
+                &[
+                    Message::multilingual(MessageType::Say, french_content().into_vec()).unwrap(),
+                    Message::new(MessageType::Say, "A user message".into())
+                ],
+                messages.as_slice()
+            );
+            assert_eq!(
+                2,
+                database
+                    .general_messages(MergeMode::WithUserMetadata, EvalMode::DoNotEvaluate)
+                    .unwrap()
+                    .first()
+                    .unwrap()
+                    .content()
+                    .len()
+            );
+        }
+
+        #[test]
+        fn localised_plugin_metadata_should_keep_only_the_content_for_the_given_language() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let mut database = fixture.database();
+
+            let userlist_path = fixture.inner.local_path.join("userlist.yaml");
+            std::fs::write(
+                &userlist_path,
+                format!(
+                    "plugins:\n  - name: {BLANK_ESM}\n    msg: [{{type: say, content: {MULTILINGUAL_CONTENT}}}]\n    req: [{{name: A.esp, detail: {MULTILINGUAL_CONTENT}}}]"
+                ),
+            )
+            .unwrap();
+            database.load_userlist(&userlist_path).unwrap();
+
+            let metadata = database
+                .localised_plugin_metadata(
+                    BLANK_ESM,
+                    "fr_FR",
+                    MergeMode::WithUserMetadata,
+                    EvalMode::DoNotEvaluate,
+                )
+                .unwrap()
+                .unwrap();
+
+            assert_eq!(
+                &*french_content(),
+                metadata.messages().first().unwrap().content()
+            );
+            assert_eq!(
+                &*french_content(),
+                metadata.requirements().first().unwrap().detail()
+            );
+        }
+
+        #[test]
+        fn localised_plugin_metadata_should_return_none_if_the_plugin_has_no_metadata() {
+            let fixture = Fixture::new(GameType::Oblivion);
+            let database = fixture.database();
+
+            assert!(
+                database
+                    .localised_plugin_metadata(
+                        BLANK_ESM,
+                        "fr",
+                        MergeMode::WithUserMetadata,
+                        EvalMode::DoNotEvaluate
+                    )
+                    .unwrap()
+                    .is_none()
+            );
+        }
+    }
+
     mod plugin_user_metadata {
         use super::*;
 
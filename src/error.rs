@@ -99,6 +99,7 @@ pub enum LoadPluginsError {
     PluginValidationError(Box<dyn std::error::Error + Send + Sync + 'static>),
     PluginDataError(PluginDataError),
     PluginNotLoaded(String),
+    Cancelled,
 }
 
 impl std::fmt::Display for LoadPluginsError {
@@ -109,6 +110,7 @@ impl std::fmt::Display for LoadPluginsError {
             Self::PluginValidationError(_) => write!(f, "failed validation of input plugin paths"),
             Self::PluginDataError(_) => write!(f, "failed to read loaded plugin data"),
             Self::PluginNotLoaded(n) => write!(f, "the plugin \"{n}\" has not been loaded"),
+            Self::Cancelled => write!(f, "loading plugins was cancelled"),
         }
     }
 }
@@ -116,7 +118,7 @@ impl std::fmt::Display for LoadPluginsError {
 impl std::error::Error for LoadPluginsError {
     fn source(&self) -> Option<&(dyn std::error::Error + 'static)> {
         match self {
-            Self::DatabaseLockPoisoned | Self::PluginNotLoaded(_) => None,
+            Self::DatabaseLockPoisoned | Self::PluginNotLoaded(_) | Self::Cancelled => None,
             Self::IoError(e) => Some(e),
             Self::PluginValidationError(e) => Some(e.as_ref()),
             Self::PluginDataError(e) => Some(e),
@@ -209,6 +211,7 @@ pub enum SortPluginsError {
     CycleFoundInvolving(String),
     PluginDataError(PluginDataError),
     PathfindingError(Box<dyn std::error::Error + Send + Sync + 'static>),
+    Cancelled,
 }
 
 impl std::fmt::Display for SortPluginsError {
@@ -222,6 +225,7 @@ impl std::fmt::Display for SortPluginsError {
             Self::PluginDataError(_) => write!(f, "failed to read loaded plugin data"),
             Self::MetadataRetrievalError(_) => write!(f, "failed to retrieve plugin metadata"),
             Self::PathfindingError(_) => write!(f, "failed to find a path in the plugins graph"),
+            Self::Cancelled => write!(f, "sorting plugins was cancelled"),
         }
     }
 }
@@ -255,6 +259,7 @@ impl From<SortingError> for SortPluginsError {
             SortingError::CycleInvolving(n) => Self::CycleFoundInvolving(n),
             SortingError::PluginDataError(e) => Self::PluginDataError(e),
             SortingError::PathfindingError(e) => Self::PathfindingError(Box::new(e)),
+            SortingError::Cancelled => Self::Cancelled,
         }
     }
 }
@@ -9,7 +9,7 @@ use loadorder::WritableLoadOrder;
 use rayon::iter::{IntoParallelRefIterator, ParallelIterator};
 
 use crate::{
-    EvalMode, LogLevel, MergeMode,
+    CancellationToken, EvalMode, LogLevel, MergeMode,
     database::Database,
     error::{
         DatabaseLockPoisonError, GameHandleCreationError, LoadOrderError, LoadOrderStateError,
@@ -26,6 +26,8 @@ use crate::{
         error::{InvalidFilenameReason, PluginValidationError},
         plugins_metadata, validate_plugin_path_and_header,
     },
+    progress::{ProgressPhase, ProgressReporter},
+    snapshot::GameSnapshot,
     sorting::{
         groups::build_groups_graph,
         plugins::{PluginSortingData, sort_plugins},
@@ -145,6 +147,7 @@ pub struct Game {
     // loading plugins.
     database: Arc<RwLock<Database>>,
     cache: GameCache,
+    progress: ProgressReporter,
 }
 
 impl Game {
@@ -174,15 +177,15 @@ impl Game {
         let load_order =
             loadorder::GameSettings::new(game_type.into(), game_path)?.into_load_order();
 
-        let condition_evaluator_state =
-            new_condition_evaluator_state(game_type, game_path, load_order.as_ref());
+        let database = new_database(game_type, game_path, load_order.as_ref());
 
         Ok(Game {
             base_type: game_type,
             install_path: game_path.to_path_buf(),
             load_order,
-            database: Arc::new(RwLock::new(Database::new(condition_evaluator_state))),
+            database: Arc::new(RwLock::new(database)),
             cache: GameCache::default(),
+            progress: ProgressReporter::default(),
         })
     }
 
@@ -223,15 +226,15 @@ impl Game {
             loadorder::GameSettings::with_local_path(game_type.into(), game_path, game_local_path)?
                 .into_load_order();
 
-        let condition_evaluator_state =
-            new_condition_evaluator_state(game_type, game_path, load_order.as_ref());
+        let database = new_database(game_type, game_path, load_order.as_ref());
 
         Ok(Game {
             base_type: game_type,
             install_path: game_path.to_path_buf(),
             load_order,
-            database: Arc::new(RwLock::new(Database::new(condition_evaluator_state))),
+            database: Arc::new(RwLock::new(database)),
             cache: GameCache::default(),
+            progress: ProgressReporter::default(),
         })
     }
 
@@ -269,19 +272,38 @@ impl Game {
         additional_data_paths: Vec<PathBuf>,
     ) -> Result<(), DatabaseLockPoisonError> {
         let mut database = self.database.write()?;
-        database.clear_condition_cache();
 
         self.load_order
             .game_settings_mut()
             .set_additional_plugins_directories(additional_data_paths.clone());
 
         database
-            .condition_evaluator_state_mut()
+            .condition_evaluator_mut()
             .set_additional_data_paths(additional_data_paths);
 
         Ok(())
     }
 
+    /// Set the callback function that is called to report progress while
+    /// loading and sorting plugins.
+    ///
+    /// The `callback` function's first parameter is the phase of loading or
+    /// sorting that progress is being reported for, the second is the number of
+    /// steps in that phase that have been done, and the third is the total
+    /// number of steps in the phase. It is called with zero steps done at the
+    /// start of each phase, and then at most once per percent of the phase's
+    /// steps, so may not be called for every step. Sorting adds edges to
+    /// master, blueprint master and other plugins separately, so each of the
+    /// edge-adding phases is reported up to three times per sort.
+    ///
+    /// The callback may be called from multiple threads at the same time.
+    pub fn set_progress_callback<T>(&mut self, callback: T)
+    where
+        T: Fn(ProgressPhase, usize, usize) + Send + Sync + 'static,
+    {
+        self.progress = ProgressReporter::new(Box::new(callback));
+    }
+
     /// Get the object used for accessing metadata-related functionality.
     pub fn database(&self) -> Arc<RwLock<Database>> {
         Arc::clone(&self.database)
@@ -318,10 +340,29 @@ impl Game {
     /// plugins directory, while absolute paths are used as given. Each plugin
     /// filename must be unique within the vector.
     ///
-    /// Loading plugins clears the condition cache in this game's database
-    /// object.
+    /// Loading plugins invalidates any cached condition results in this game's
+    /// database object that may depend on plugins with versions or CRCs that
+    /// have changed.
     pub fn load_plugins(&mut self, plugin_paths: &[&Path]) -> Result<(), LoadPluginsError> {
-        let mut plugins = self.load_plugins_common(plugin_paths, LoadScope::WholePlugin)?;
+        self.load_plugins_with_cancellation(plugin_paths, &CancellationToken::new())
+    }
+
+    /// Fully parses plugins and loads their data, stopping early if the given
+    /// cancellation token is cancelled.
+    ///
+    /// This behaves like [`Game::load_plugins`], except that the token is
+    /// checked before and after validating the given paths and before each
+    /// plugin is loaded. If cancellation is requested, a
+    /// [`LoadPluginsError::Cancelled`] error is returned and the game's loaded
+    /// plugins and archive data are left as they were before this function was
+    /// called.
+    pub fn load_plugins_with_cancellation(
+        &mut self,
+        plugin_paths: &[&Path],
+        cancellation: &CancellationToken,
+    ) -> Result<(), LoadPluginsError> {
+        let mut staged =
+            self.load_plugins_common(plugin_paths, LoadScope::WholePlugin, cancellation)?;
 
         if matches!(
             self.base_type,
@@ -334,7 +375,7 @@ impl Game {
                 .map(|(k, v)| (k.clone(), v.as_ref()))
                 .collect();
 
-            for plugin in &plugins {
+            for plugin in &staged.plugins {
                 loaded_plugins.insert(Filename::new(plugin.name().to_owned()), plugin);
             }
 
@@ -342,12 +383,14 @@ impl Game {
 
             let plugins_metadata = plugins_metadata(&loaded_plugins)?;
 
-            for plugin in &mut plugins {
+            for plugin in &mut staged.plugins {
                 plugin.resolve_record_ids(&plugins_metadata)?;
             }
         }
 
-        self.store_plugins(plugins)?;
+        cancellation.err_if_cancelled(LoadPluginsError::Cancelled)?;
+
+        self.store_plugins(staged)?;
 
         Ok(())
     }
@@ -361,50 +404,96 @@ impl Game {
     /// plugins directory, while absolute paths are used as given. Each plugin
     /// filename must be unique within the vector.
     ///
-    /// Loading plugins clears the condition cache in this game's database
-    /// object.
+    /// Loading plugins invalidates any cached condition results in this game's
+    /// database object that may depend on plugins with versions or CRCs that
+    /// have changed.
     pub fn load_plugin_headers(&mut self, plugin_paths: &[&Path]) -> Result<(), LoadPluginsError> {
-        let plugins = self.load_plugins_common(plugin_paths, LoadScope::HeaderOnly)?;
+        self.load_plugin_headers_with_cancellation(plugin_paths, &CancellationToken::new())
+    }
+
+    /// Parses plugin headers and loads their data, stopping early if the given
+    /// cancellation token is cancelled.
+    ///
+    /// This behaves like [`Game::load_plugin_headers`], with cancellation
+    /// handled as described for [`Game::load_plugins_with_cancellation`].
+    pub fn load_plugin_headers_with_cancellation(
+        &mut self,
+        plugin_paths: &[&Path],
+        cancellation: &CancellationToken,
+    ) -> Result<(), LoadPluginsError> {
+        let staged = self.load_plugins_common(plugin_paths, LoadScope::HeaderOnly, cancellation)?;
+
+        cancellation.err_if_cancelled(LoadPluginsError::Cancelled)?;
 
-        self.store_plugins(plugins)?;
+        self.store_plugins(staged)?;
 
         Ok(())
     }
 
+    // This doesn't modify the game's cache, so that if loading fails or is
+    // cancelled part-way through the cache is left unchanged: the loaded data
+    // is instead only stored once everything has been loaded successfully.
     fn load_plugins_common(
-        &mut self,
+        &self,
         plugin_paths: &[&Path],
         load_scope: LoadScope,
-    ) -> Result<Vec<Plugin>, LoadPluginsError> {
+        cancellation: &CancellationToken,
+    ) -> Result<StagedPlugins, LoadPluginsError> {
+        cancellation.err_if_cancelled(LoadPluginsError::Cancelled)?;
+
         let data_path = data_path(self.base_type, &self.install_path);
 
-        validate_plugin_paths(self.base_type, &data_path, plugin_paths)?;
+        validate_plugin_paths(self.base_type, &data_path, plugin_paths, &self.progress)?;
 
-        let archive_paths =
-            find_archives(self.base_type, self.additional_data_paths(), &data_path)?;
+        cancellation.err_if_cancelled(LoadPluginsError::Cancelled)?;
+
+        let archive_paths = find_archives(
+            self.base_type,
+            self.additional_data_paths(),
+            &data_path,
+            &self.progress,
+        )?;
 
-        self.cache.set_archive_paths(archive_paths);
+        let mut archive_cache = GameCache::default();
+        archive_cache.set_archive_paths(archive_paths);
 
         logging::trace!("Starting loading {load_scope}s.");
 
+        let progress = self
+            .progress
+            .start(ProgressPhase::ParsingPlugins, plugin_paths.len());
+
         let plugins: Vec<_> = plugin_paths
             .par_iter()
             .filter_map(|path| {
-                try_load_plugin(&data_path, path, self.base_type, &self.cache, load_scope)
+                if cancellation.is_cancelled() {
+                    return None;
+                }
+
+                let plugin =
+                    try_load_plugin(&data_path, path, self.base_type, &archive_cache, load_scope);
+                progress.step();
+                plugin
             })
             .collect();
 
-        Ok(plugins)
-    }
+        cancellation.err_if_cancelled(LoadPluginsError::Cancelled)?;
 
-    fn store_plugins(&mut self, plugins: Vec<Plugin>) -> Result<(), DatabaseLockPoisonError> {
-        self.cache.insert_plugins(plugins);
+        Ok(StagedPlugins {
+            archive_cache,
+            plugins,
+        })
+    }
 
+    fn store_plugins(&mut self, staged: StagedPlugins) -> Result<(), DatabaseLockPoisonError> {
+        // Get the lock before modifying the cache so that the cache and the
+        // database's loaded plugin state are either both updated or neither is.
         let mut database = self.database.write()?;
-        update_loaded_plugin_state(
-            database.condition_evaluator_state_mut(),
-            self.cache.plugins_iter(),
-        );
+
+        self.cache.replace_archive_paths(staged.archive_cache);
+        self.cache.insert_plugins(staged.plugins);
+
+        update_loaded_plugin_state(&mut database, self.cache.plugins_iter());
 
         Ok(())
     }
@@ -425,6 +514,45 @@ impl Game {
         self.cache.plugins_iter().cloned().collect()
     }
 
+    /// Take an immutable snapshot of the game's loaded plugins, load order and
+    /// metadata.
+    ///
+    /// The snapshot can be queried from any thread without blocking or being
+    /// blocked by changes to this game or to its database, and taking it
+    /// doesn't copy any loaded plugin data or metadata. See [`GameSnapshot`]
+    /// for details.
+    pub fn snapshot(&self) -> Result<GameSnapshot, DatabaseLockPoisonError> {
+        let active_plugin_names = self.load_order.active_plugin_names();
+
+        let mut condition_evaluator_state = new_condition_evaluator_state(
+            self.base_type,
+            &self.install_path,
+            self.load_order.as_ref(),
+        );
+        condition_evaluator_state.set_active_plugins(&active_plugin_names);
+
+        let mut database = self
+            .database
+            .read()?
+            .with_shared_metadata(condition_evaluator_state);
+        update_loaded_plugin_state(&mut database, self.cache.plugins_iter());
+
+        Ok(GameSnapshot::new(
+            self.base_type,
+            self.cache.shared_plugins(),
+            self.load_order
+                .plugin_names()
+                .into_iter()
+                .map(str::to_owned)
+                .collect(),
+            active_plugin_names
+                .into_iter()
+                .map(|n| Filename::new(n.to_owned()))
+                .collect(),
+            database,
+        ))
+    }
+
     /// Calculates a new load order for the game's installed plugins (including
     /// inactive plugins) and returns the sorted order.
     ///
@@ -437,6 +565,20 @@ impl Game {
     /// their current load order. All given plugins must have been already been
     /// loaded using [`Game::load_plugins`] or [`Game::load_plugin_headers`].
     pub fn sort_plugins(&self, plugin_names: &[&str]) -> Result<Vec<String>, SortPluginsError> {
+        self.sort_plugins_with_cancellation(plugin_names, &CancellationToken::new())
+    }
+
+    /// Calculates a new load order for the given plugins, stopping early if
+    /// the given cancellation token is cancelled.
+    ///
+    /// This behaves like [`Game::sort_plugins`], except that the token is
+    /// checked between each phase of sorting. If cancellation is requested, a
+    /// [`SortPluginsError::Cancelled`] error is returned.
+    pub fn sort_plugins_with_cancellation(
+        &self,
+        plugin_names: &[&str],
+        cancellation: &CancellationToken,
+    ) -> Result<Vec<String>, SortPluginsError> {
         let plugins = plugin_names
             .iter()
             .map(|n| {
@@ -448,12 +590,22 @@ impl Game {
 
         let database = self.database.read()?;
 
+        let progress = self
+            .progress
+            .start(ProgressPhase::PreparingSortingData, plugins.len());
+
         let plugins_sorting_data = plugins
             .into_iter()
             .enumerate()
-            .map(|(i, p)| to_plugin_sorting_data(&database, p, i))
+            .map(|(i, p)| {
+                let data = to_plugin_sorting_data(&database, p, i);
+                progress.step();
+                data
+            })
             .collect::<Result<Vec<_>, _>>()?;
 
+        cancellation.err_if_cancelled(SortPluginsError::Cancelled)?;
+
         if is_log_enabled(LogLevel::Debug) {
             logging::debug!("Current load order:");
             for plugin_name in plugin_names {
@@ -470,6 +622,8 @@ impl Game {
             plugins_sorting_data,
             &groups_graph,
             self.load_order.game_settings().early_loading_plugins(),
+            cancellation,
+            &self.progress,
         )?;
 
         if is_log_enabled(LogLevel::Debug) {
@@ -488,16 +642,19 @@ impl Game {
     /// of plugins "on disk" changes, so that the cached state is updated to
     /// reflect the changes.
     ///
-    /// Loading the current load order state clears the condition cache in this
-    /// game's database object.
+    /// Loading the current load order state invalidates any cached condition
+    /// results in this game's database object that may depend on plugins that
+    /// have been installed, uninstalled, activated or deactivated, or on the
+    /// entries of a directory that has been modified since the results were
+    /// cached.
     pub fn load_current_load_order_state(&mut self) -> Result<(), LoadOrderStateError> {
         self.load_order.load()?;
 
         let mut database = self.database.write()?;
-        database.clear_condition_cache();
-        database
-            .condition_evaluator_state_mut()
-            .set_active_plugins(&self.load_order.active_plugin_names());
+        database.condition_evaluator_mut().set_load_order_state(
+            &self.load_order.plugin_names(),
+            &self.load_order.active_plugin_names(),
+        );
         Ok(())
     }
 
@@ -552,6 +709,23 @@ fn data_path(game_type: GameType, game_path: &Path) -> PathBuf {
     }
 }
 
+fn new_database(
+    game_type: GameType,
+    game_path: &Path,
+    load_order: &(dyn WritableLoadOrder + Send + Sync + 'static),
+) -> Database {
+    let mut database = Database::new(new_condition_evaluator_state(
+        game_type, game_path, load_order,
+    ));
+
+    database.condition_evaluator_mut().set_data_paths(
+        data_path(game_type, game_path),
+        load_order.game_settings().additional_plugins_directories(),
+    );
+
+    database
+}
+
 fn new_condition_evaluator_state(
     game_type: GameType,
     game_path: &Path,
@@ -575,6 +749,7 @@ fn validate_plugin_paths(
     game_type: GameType,
     data_path: &Path,
     plugin_paths: &[&Path],
+    progress: &ProgressReporter,
 ) -> Result<(), PluginValidationError> {
     // Check that all plugin filenames are unique.
     let mut set = HashSet::new();
@@ -596,11 +771,15 @@ fn validate_plugin_paths(
         }
     }
 
+    let progress = progress.start(ProgressPhase::ValidatingPaths, plugin_paths.len());
+
     plugin_paths
         .par_iter()
         .map(|path| {
             let resolved_path = resolve_plugin_path(game_type, data_path, path);
-            validate_plugin_path_and_header(game_type, &resolved_path)
+            let result = validate_plugin_path_and_header(game_type, &resolved_path);
+            progress.step();
+            result
         })
         .collect()
 }
@@ -609,18 +788,26 @@ fn find_archives(
     game_type: GameType,
     additional_data_paths: &[PathBuf],
     data_path: &Path,
+    progress: &ProgressReporter,
 ) -> std::io::Result<Vec<PathBuf>> {
     let extension = archive_file_extension(game_type);
     let allow_symlinks = allow_archive_symlinks(game_type);
 
+    let progress = progress.start(
+        ProgressPhase::ReadingArchives,
+        additional_data_paths.len().saturating_add(1),
+    );
+
     let mut archive_paths = Vec::new();
     for path in additional_data_paths {
         let paths = find_archives_in_path(path, extension, allow_symlinks)?;
         archive_paths.extend(paths);
+        progress.step();
     }
 
     let paths = find_archives_in_path(data_path, extension, allow_symlinks)?;
     archive_paths.extend(paths);
+    progress.step();
 
     Ok(archive_paths)
 }
@@ -711,7 +898,7 @@ fn resolve_plugin_path(game_type: GameType, data_path: &Path, plugin_path: &Path
 }
 
 fn update_loaded_plugin_state<'a>(
-    state: &mut loot_condition_interpreter::State,
+    database: &mut Database,
     plugins: impl Iterator<Item = &'a Arc<Plugin>>,
 ) {
     let mut plugin_versions = Vec::new();
@@ -727,24 +914,9 @@ fn update_loaded_plugin_state<'a>(
         }
     }
 
-    if let Err(e) = state.clear_condition_cache() {
-        logging::error!("The condition cache's lock is poisoned, assigning a new cache");
-        *e.into_inner() = HashMap::new();
-    }
-
-    state.set_plugin_versions(&plugin_versions);
-
-    if let Err(e) = state.set_cached_crcs(&plugin_crcs) {
-        logging::error!(
-            "The condition interpreter's CRC cache's lock is poisoned, clearing the cache and assigning a new value"
-        );
-        let mut cache = e.into_inner();
-        cache.clear();
-        *cache = plugin_crcs
-            .into_iter()
-            .map(|(n, c)| (n.to_lowercase(), c))
-            .collect();
-    }
+    database
+        .condition_evaluator_mut()
+        .set_loaded_plugins(&plugin_versions, &plugin_crcs);
 }
 
 fn to_plugin_sorting_data<'a>(
@@ -775,9 +947,19 @@ fn to_plugin_sorting_data<'a>(
     .map_err(Into::into)
 }
 
+/// Plugins that have been loaded but not yet stored in a game's cache, along
+/// with the archives that were found when loading them.
+#[derive(Debug)]
+struct StagedPlugins {
+    archive_cache: GameCache,
+    plugins: Vec<Plugin>,
+}
+
 #[derive(Clone, Debug, Default, Eq, PartialEq)]
 pub(crate) struct GameCache {
-    plugins: HashMap<Filename, Arc<Plugin>>,
+    // Shared with any snapshots that were taken while these plugins were
+    // loaded, and copied on write if it's shared.
+    plugins: Arc<HashMap<Filename, Arc<Plugin>>>,
     archive_paths: HashSet<PathBuf>,
 }
 
@@ -787,15 +969,23 @@ impl GameCache {
         self.archive_paths.extend(archive_paths);
     }
 
+    fn replace_archive_paths(&mut self, other: GameCache) {
+        self.archive_paths = other.archive_paths;
+    }
+
     fn insert_plugins(&mut self, plugins: Vec<Plugin>) {
+        let cached_plugins = Arc::make_mut(&mut self.plugins);
         for plugin in plugins {
-            self.plugins
-                .insert(Filename::new(plugin.name().to_owned()), Arc::new(plugin));
+            cached_plugins.insert(Filename::new(plugin.name().to_owned()), Arc::new(plugin));
         }
     }
 
     fn clear_plugins(&mut self) {
-        self.plugins.clear();
+        self.plugins = Arc::default();
+    }
+
+    fn shared_plugins(&self) -> Arc<HashMap<Filename, Arc<Plugin>>> {
+        Arc::clone(&self.plugins)
     }
 
     fn plugins(&self) -> &HashMap<Filename, Arc<Plugin>> {
@@ -1327,6 +1517,51 @@ mod tests {
             }
         }
 
+        mod set_progress_callback {
+            use std::sync::Mutex;
+
+            use super::*;
+
+            #[test]
+            fn should_report_progress_through_each_phase_of_loading_and_sorting() {
+                let fixture = Fixture::new(GameType::Oblivion);
+
+                let mut game = Game::with_local_path(
+                    fixture.game_type,
+                    &fixture.game_path,
+                    &fixture.local_path,
+                )
+                .unwrap();
+
+                let phases = Arc::new(Mutex::new(Vec::new()));
+                let phases_clone = Arc::clone(&phases);
+                game.set_progress_callback(move |phase, done, total| {
+                    if done == total {
+                        phases_clone.lock().unwrap().push(phase);
+                    }
+                });
+
+                game.load_plugins(&[Path::new(BLANK_ESP), Path::new(BLANK_DIFFERENT_ESP)])
+                    .unwrap();
+                game.sort_plugins(&[BLANK_ESP, BLANK_DIFFERENT_ESP])
+                    .unwrap();
+
+                assert_eq!(
+                    vec![
+                        ProgressPhase::ValidatingPaths,
+                        ProgressPhase::ReadingArchives,
+                        ProgressPhase::ParsingPlugins,
+                        ProgressPhase::PreparingSortingData,
+                        ProgressPhase::AddingSpecificEdges,
+                        ProgressPhase::AddingGroupEdges,
+                        ProgressPhase::AddingOverlapEdges,
+                        ProgressPhase::AddingTieBreakEdges,
+                    ],
+                    *phases.lock().unwrap()
+                );
+            }
+        }
+
         mod is_valid_plugin {
             use super::*;
 
@@ -1566,6 +1801,52 @@ mod tests {
 
                 assert_ne!(plugin2, plugin3);
             }
+
+            #[test]
+            fn should_discard_cached_checksum_results_for_a_plugin_rewritten_with_the_same_version()
+            {
+                let fixture = Fixture::new(GameType::Morrowind);
+
+                let mut game = Game::with_local_path(
+                    fixture.game_type,
+                    &fixture.game_path,
+                    &fixture.local_path,
+                )
+                .unwrap();
+
+                game.load_plugins(&[Path::new(BLANK_ESP)]).unwrap();
+                let crc = game.plugin(BLANK_ESP).unwrap().crc().unwrap();
+                let version = game.plugin(BLANK_ESP).unwrap().version().map(str::to_owned);
+                let condition = format!("checksum(\"{BLANK_ESP}\", {crc:08X})");
+
+                game.load_plugin_headers(&[Path::new(BLANK_ESP)]).unwrap();
+                assert!(
+                    game.database()
+                        .read()
+                        .unwrap()
+                        .evaluate(&condition)
+                        .unwrap()
+                );
+
+                let path = fixture.data_path().join(BLANK_ESP);
+                let mut bytes = std::fs::read(&path).unwrap();
+                bytes.push(0);
+                std::fs::write(&path, bytes).unwrap();
+
+                game.load_plugin_headers(&[Path::new(BLANK_ESP)]).unwrap();
+                assert_eq!(
+                    version.as_deref(),
+                    game.plugin(BLANK_ESP).unwrap().version()
+                );
+                assert!(
+                    !game
+                        .database()
+                        .read()
+                        .unwrap()
+                        .evaluate(&condition)
+                        .unwrap()
+                );
+            }
         }
 
         mod load_plugins {
@@ -1599,6 +1880,34 @@ mod tests {
                 assert!(game.plugin(BLANK_ESP).is_some());
             }
 
+            #[test]
+            fn should_not_modify_the_cache_if_cancelled() {
+                let fixture = Fixture::new(GameType::Oblivion);
+
+                let mut game = Game::with_local_path(
+                    fixture.game_type,
+                    &fixture.game_path,
+                    &fixture.local_path,
+                )
+                .unwrap();
+
+                game.load_plugins(&[Path::new(BLANK_ESM)]).unwrap();
+                std::fs::File::create(fixture.data_path().join("Blank.bsa")).unwrap();
+
+                let cancellation = CancellationToken::new();
+                cancellation.cancel();
+
+                let result = game.load_plugins_with_cancellation(
+                    &[Path::new(BLANK_ESM), Path::new(BLANK_ESP)],
+                    &cancellation,
+                );
+
+                assert!(matches!(result, Err(LoadPluginsError::Cancelled)));
+                assert!(game.plugin(BLANK_ESM).is_some());
+                assert!(game.plugin(BLANK_ESP).is_none());
+                assert!(game.cache.archive_paths.is_empty());
+            }
+
             #[test]
             fn should_not_clear_the_plugins_cache() {
                 let fixture = Fixture::new(GameType::Morrowind);
@@ -1778,8 +2087,7 @@ mod tests {
                 ])
                 .unwrap();
 
-                game.load_plugins_common(&[], LoadScope::HeaderOnly)
-                    .unwrap();
+                game.load_plugin_headers(&[]).unwrap();
 
                 assert_eq!(HashSet::from([path1, path2]), game.cache.archive_paths);
             }
@@ -1797,10 +2105,8 @@ mod tests {
 
                 std::fs::File::create(fixture.data_path().join("Blank.bsa")).unwrap();
 
-                game.load_plugins_common(&[], LoadScope::HeaderOnly)
-                    .unwrap();
-                game.load_plugins_common(&[], LoadScope::HeaderOnly)
-                    .unwrap();
+                game.load_plugin_headers(&[]).unwrap();
+                game.load_plugin_headers(&[]).unwrap();
 
                 assert_eq!(1, game.cache.archive_paths.len());
             }
@@ -1821,7 +2127,10 @@ mod tests {
                     "\u{2551}\u{00BB}\u{00C1}\u{2510}\u{2557}\u{00FE}\u{00C3}\u{00CE}.txt";
                 std::fs::File::create(fixture.data_path().join(filename)).unwrap();
 
-                assert!(game.load_plugins_common(&[], LoadScope::HeaderOnly).is_ok());
+                assert!(
+                    game.load_plugins_common(&[], LoadScope::HeaderOnly, &CancellationToken::new())
+                        .is_ok()
+                );
             }
 
             #[test]
@@ -1845,7 +2154,11 @@ mod tests {
                 } else {
                     "b/Blank.esm"
                 };
-                match game.load_plugins_common(&[&paths[0], &paths[1]], LoadScope::HeaderOnly) {
+                match game.load_plugins_common(
+                    &[&paths[0], &paths[1]],
+                    LoadScope::HeaderOnly,
+                    &CancellationToken::new(),
+                ) {
                     Err(LoadPluginsError::PluginValidationError(e)) => {
                         assert_eq!(
                             format!(
@@ -1873,12 +2186,12 @@ mod tests {
                     .join(fixture.data_path().file_name().unwrap())
                     .join(BLANK_ESM);
 
-                let plugins = game
-                    .load_plugins_common(&[&path], LoadScope::HeaderOnly)
+                let staged = game
+                    .load_plugins_common(&[&path], LoadScope::HeaderOnly, &CancellationToken::new())
                     .unwrap();
 
-                assert_eq!(1, plugins.len());
-                assert_eq!(BLANK_ESM, plugins[0].name());
+                assert_eq!(1, staged.plugins.len());
+                assert_eq!(BLANK_ESM, staged.plugins[0].name());
             }
 
             #[test]
@@ -1894,12 +2207,12 @@ mod tests {
 
                 let path = fixture.data_path().join(BLANK_ESM);
 
-                let plugins = game
-                    .load_plugins_common(&[&path], LoadScope::HeaderOnly)
+                let staged = game
+                    .load_plugins_common(&[&path], LoadScope::HeaderOnly, &CancellationToken::new())
                     .unwrap();
 
-                assert_eq!(1, plugins.len());
-                assert_eq!(BLANK_ESM, plugins[0].name());
+                assert_eq!(1, staged.plugins.len());
+                assert_eq!(BLANK_ESM, staged.plugins[0].name());
             }
 
             #[test]
@@ -1917,12 +2230,12 @@ mod tests {
                     .data_path()
                     .join(format!("{BLANK_MASTER_DEPENDENT_ESM}.ghost"));
 
-                let plugins = game
-                    .load_plugins_common(&[&path], LoadScope::HeaderOnly)
+                let staged = game
+                    .load_plugins_common(&[&path], LoadScope::HeaderOnly, &CancellationToken::new())
                     .unwrap();
 
-                assert_eq!(1, plugins.len());
-                assert_eq!(BLANK_MASTER_DEPENDENT_ESM, plugins[0].name());
+                assert_eq!(1, staged.plugins.len());
+                assert_eq!(BLANK_MASTER_DEPENDENT_ESM, staged.plugins[0].name());
             }
         }
 
@@ -1990,6 +2303,30 @@ mod tests {
                 assert_eq!(input, sorted.as_slice());
             }
 
+            #[test]
+            fn should_error_if_cancelled() {
+                let fixture = Fixture::new(GameType::Oblivion);
+
+                let mut game = Game::with_local_path(
+                    fixture.game_type,
+                    &fixture.game_path,
+                    &fixture.local_path,
+                )
+                .unwrap();
+
+                load_all_installed_plugins(&mut game, &fixture);
+
+                let cancellation = CancellationToken::new();
+                cancellation.cancel();
+
+                let result = game.sort_plugins_with_cancellation(
+                    &[BLANK_ESP, BLANK_DIFFERENT_ESP],
+                    &cancellation,
+                );
+
+                assert!(matches!(result, Err(SortPluginsError::Cancelled)));
+            }
+
             #[test]
             fn should_error_if_a_given_plugin_is_not_loaded() {
                 let fixture = Fixture::new(GameType::Oblivion);
@@ -2037,6 +2374,126 @@ mod tests {
             }
         }
 
+        mod snapshot {
+            use super::*;
+
+            use crate::metadata::Group;
+
+            #[test]
+            fn should_not_reflect_plugins_loaded_after_it_was_taken() {
+                let fixture = Fixture::new(GameType::Oblivion);
+
+                let mut game = Game::with_local_path(
+                    fixture.game_type,
+                    &fixture.game_path,
+                    &fixture.local_path,
+                )
+                .unwrap();
+
+                game.load_plugin_headers(&[Path::new(BLANK_ESM)]).unwrap();
+
+                let snapshot = game.snapshot().unwrap();
+
+                game.load_plugin_headers(&[Path::new(BLANK_ESP)]).unwrap();
+                game.clear_loaded_plugins();
+
+                assert!(game.plugin(BLANK_ESM).is_none());
+                assert_eq!(BLANK_ESM, snapshot.plugin(BLANK_ESM).unwrap().name());
+                assert!(snapshot.plugin(BLANK_ESP).is_none());
+                assert_eq!(1, snapshot.loaded_plugins().len());
+            }
+
+            #[test]
+            fn should_share_plugin_data_with_the_game() {
+                let fixture = Fixture::new(GameType::Oblivion);
+
+                let mut game = Game::with_local_path(
+                    fixture.game_type,
+                    &fixture.game_path,
+                    &fixture.local_path,
+                )
+                .unwrap();
+
+                game.load_plugin_headers(&[Path::new(BLANK_ESM)]).unwrap();
+
+                let snapshot = game.snapshot().unwrap();
+
+                assert!(Arc::ptr_eq(
+                    &game.plugin(BLANK_ESM).unwrap(),
+                    &snapshot.plugin(BLANK_ESM).unwrap()
+                ));
+            }
+
+            #[test]
+            fn should_capture_the_load_order_state_when_it_was_taken() {
+                let fixture = Fixture::new(GameType::Oblivion);
+
+                let mut game = Game::with_local_path(
+                    fixture.game_type,
+                    &fixture.game_path,
+                    &fixture.local_path,
+                )
+                .unwrap();
+
+                game.load_current_load_order_state().unwrap();
+
+                let snapshot = game.snapshot().unwrap();
+
+                assert_eq!(game.load_order(), snapshot.load_order());
+                assert!(snapshot.is_plugin_active(BLANK_ESM));
+                assert!(snapshot.is_plugin_active(&BLANK_ESM.to_lowercase()));
+                assert!(!snapshot.is_plugin_active(BLANK_ESP));
+                assert!(
+                    snapshot
+                        .database()
+                        .evaluate("active(\"Blank.esm\")")
+                        .unwrap()
+                );
+            }
+
+            #[test]
+            fn should_not_reflect_metadata_changes_made_after_it_was_taken() {
+                let fixture = Fixture::new(GameType::Oblivion);
+
+                let game = Game::with_local_path(
+                    fixture.game_type,
+                    &fixture.game_path,
+                    &fixture.local_path,
+                )
+                .unwrap();
+
+                let mut metadata = PluginMetadata::new(BLANK_ESM).unwrap();
+                metadata.set_group("group1".into());
+                game.database()
+                    .write()
+                    .unwrap()
+                    .set_plugin_user_metadata(metadata);
+
+                let snapshot = game.snapshot().unwrap();
+
+                {
+                    let database = game.database();
+                    let mut database = database.write().unwrap();
+                    database.discard_all_user_metadata();
+                    database.set_user_groups(vec![Group::new("group2".into())]);
+                }
+
+                let metadata = snapshot
+                    .database()
+                    .plugin_user_metadata(BLANK_ESM, EvalMode::DoNotEvaluate)
+                    .unwrap()
+                    .unwrap();
+                assert_eq!(Some("group1"), metadata.group());
+                assert!(
+                    !snapshot
+                        .database()
+                        .user_groups()
+                        .iter()
+                        .any(|g| g.name() == "group2")
+                );
+            }
+        }
+
         #[test]
         fn set_load_order_should_persist_the_given_load_order() {
             let fixture = Fixture::new(GameType::Oblivion);
@@ -2131,7 +2588,9 @@ mod tests {
 
             symlink_file(&archive_path, &symlink_path);
 
-            let archives = find_archives(game_type, &[], tmp_dir.path()).unwrap();
+            let archives =
+                find_archives(game_type, &[], tmp_dir.path(), &ProgressReporter::default())
+                    .unwrap();
 
             assert!(archives.contains(&archive_path));
 
@@ -16,12 +16,15 @@
 )]
 
 mod archive;
+mod cancellation;
 mod database;
 pub mod error;
 mod game;
 mod logging;
 pub mod metadata;
 mod plugin;
+mod progress;
+mod snapshot;
 mod sorting;
 #[cfg(test)]
 mod tests;
@@ -31,11 +34,14 @@ use std::{path::Path, slice::EscapeAscii};
 
 use regress::{Error as RegexImplError, Regex};
 
-pub use database::{Database, EvalMode, MergeMode};
+pub use cancellation::CancellationToken;
+pub use database::{ConditionCacheStats, Database, EvalMode, MergeMode};
 pub use game::{Game, GameType};
 pub use logging::{LogLevel, set_log_level, set_logging_callback};
-pub use metadata::metadata_document::MetadataWriteOptions;
+pub use metadata::metadata_document::{LoadedMetadata, MetadataChanges, MetadataWriteOptions};
 pub use plugin::Plugin;
+pub use progress::ProgressPhase;
+pub use snapshot::GameSnapshot;
 pub use sorting::vertex::{EdgeType, Vertex};
 pub use version::{
     LIBLOOT_VERSION_MAJOR, LIBLOOT_VERSION_MINOR, LIBLOOT_VERSION_PATCH, is_compatible,
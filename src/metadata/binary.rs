@@ -0,0 +1,651 @@
+use std::{
+    collections::HashMap,
+    ops::Range,
+    sync::{Arc, OnceLock},
+};
+
+use super::{Condition, compiled_metadata::ContentHash};
+
+/// An error that occurred while decoding compiled metadata.
+#[derive(Clone, Copy, Debug, Eq, PartialEq)]
+pub(crate) enum DecodeError {
+    UnexpectedEnd,
+    TrailingData,
+    InvalidStringIndex,
+    InvalidString,
+    InvalidValue,
+    ChecksumMismatch,
+}
+
+impl std::fmt::Display for DecodeError {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        match self {
+            Self::UnexpectedEnd => write!(f, "the data ended unexpectedly"),
+            Self::TrailingData => write!(f, "the data continued after its expected end"),
+            Self::InvalidStringIndex => write!(f, "a string index is out of range"),
+            Self::InvalidString => write!(f, "a string is not valid UTF-8"),
+            Self::InvalidValue => write!(f, "a value is out of range"),
+            Self::ChecksumMismatch => write!(f, "the data's checksum does not match"),
+        }
+    }
+}
+
+impl std::error::Error for DecodeError {}
+
+pub(crate) trait EncodeBinary {
+    fn encode_binary(&self, encoder: &mut BinaryEncoder);
+}
+
+pub(crate) trait DecodeBinary: Sized {
+    fn decode_binary(decoder: &mut BinaryDecoder<'_>) -> Result<Self, DecodeError>;
+}
+
+impl EncodeBinary for String {
+    fn encode_binary(&self, encoder: &mut BinaryEncoder) {
+        encoder.write_str(self);
+    }
+}
+
+impl DecodeBinary for String {
+    fn decode_binary(decoder: &mut BinaryDecoder<'_>) -> Result<Self, DecodeError> {
+        decoder.read_string()
+    }
+}
+
+/// Writes metadata in a compact binary form. Integers are written as LEB128
+/// variable-length integers, and each distinct string is written once in a
+/// table that precedes the data, with the data referring to strings by their
+/// index in the table.
+#[derive(Debug, Default)]
+pub(crate) struct BinaryEncoder {
+    strings: Vec<Box<str>>,
+    string_indices: HashMap<Box<str>, u64>,
+    data: Vec<u8>,
+    // Hashes the content of the lazy value that's being written, if any.
+    lazy_content: Option<ContentHasher>,
+}
+
+impl BinaryEncoder {
+    pub(crate) fn write_u8(&mut self, value: u8) {
+        self.data.push(value);
+
+        if let Some(content) = &mut self.lazy_content {
+            content.update(&[value]);
+        }
+    }
+
+    pub(crate) fn write_u32(&mut self, value: u32) {
+        self.write_varint(u64::from(value));
+    }
+
+    pub(crate) fn write_bool(&mut self, value: bool) {
+        self.write_u8(u8::from(value));
+    }
+
+    pub(crate) fn write_len(&mut self, len: usize) {
+        // If the length somehow doesn't fit, decoding will fail and the
+        // compiled metadata won't be used.
+        self.write_varint(u64::try_from(len).unwrap_or(u64::MAX));
+    }
+
+    pub(crate) fn write_str(&mut self, value: &str) {
+        let index = if let Some(index) = self.string_indices.get(value) {
+            *index
+        } else {
+            let index = u64::try_from(self.strings.len()).unwrap_or(u64::MAX);
+            self.strings.push(value.into());
+            self.string_indices.insert(value.into(), index);
+            index
+        };
+
+        push_varint(&mut self.data, index);
+
+        // A string's index depends on what else has been written, so hash the
+        // string itself.
+        if let Some(content) = &mut self.lazy_content {
+            content.update_str(value);
+        }
+    }
+
+    pub(crate) fn write_option_str(&mut self, value: Option<&str>) {
+        self.write_bool(value.is_some());
+        if let Some(value) = value {
+            self.write_str(value);
+        }
+    }
+
+    pub(crate) fn write_condition(&mut self, condition: Option<&Condition>) {
+        self.write_option_str(condition.map(Condition::as_str));
+    }
+
+    pub(crate) fn write_slice<T: EncodeBinary>(&mut self, values: &[T]) {
+        self.write_len(values.len());
+        for value in values {
+            value.encode_binary(self);
+        }
+    }
+
+    /// Write the value preceded by its encoded length, so that it can be
+    /// skipped when decoding and decoded later using a [`LazyValue`].
+    ///
+    /// The value is followed by a hash of its content that doesn't depend on
+    /// the string table, so that lazy values can be compared without decoding
+    /// them.
+    pub(crate) fn write_lazy<T: EncodeBinary>(&mut self, value: &T) {
+        let data = std::mem::take(&mut self.data);
+        let outer_content = self.lazy_content.replace(ContentHasher::default());
+        value.encode_binary(self);
+        let value_data = std::mem::replace(&mut self.data, data);
+        let content = std::mem::replace(&mut self.lazy_content, outer_content)
+            .unwrap_or_default()
+            .finish();
+
+        // The encoded length depends on the string table, so it isn't part of
+        // the content of any lazy value that this one is written in.
+        push_varint(
+            &mut self.data,
+            u64::try_from(value_data.len()).unwrap_or(u64::MAX),
+        );
+        self.data.extend(value_data);
+
+        self.write_u32(content.crc);
+        self.write_varint(content.length);
+    }
+
+    /// Returns the string table followed by the encoded data.
+    pub(crate) fn into_bytes(self) -> Vec<u8> {
+        let mut table = BinaryEncoder::default();
+
+        table.write_len(self.strings.len());
+        for string in &self.strings {
+            table.write_len(string.len());
+            table.data.extend_from_slice(string.as_bytes());
+        }
+
+        let mut bytes = table.data;
+        bytes.extend(self.data);
+        bytes
+    }
+
+    fn write_varint(&mut self, value: u64) {
+        let start = self.data.len();
+        push_varint(&mut self.data, value);
+
+        if let Some(content) = &mut self.lazy_content {
+            content.update(self.data.get(start..).unwrap_or_default());
+        }
+    }
+}
+
+fn push_varint(data: &mut Vec<u8>, mut value: u64) {
+    loop {
+        let byte = u8::try_from(value & 0x7F).unwrap_or_default();
+        value >>= 7;
+
+        if value == 0 {
+            data.push(byte);
+            break;
+        }
+
+        data.push(byte | 0x80);
+    }
+}
+
+/// Hashes the content of a value as it's written, with strings in place of
+/// their indices.
+#[derive(Debug, Default)]
+struct ContentHasher {
+    hasher: crc32fast::Hasher,
+    length: u64,
+}
+
+impl ContentHasher {
+    fn update(&mut self, bytes: &[u8]) {
+        self.hasher.update(bytes);
+        self.length = self
+            .length
+            .saturating_add(u64::try_from(bytes.len()).unwrap_or(u64::MAX));
+    }
+
+    fn update_str(&mut self, value: &str) {
+        let mut length = Vec::new();
+        push_varint(&mut length, u64::try_from(value.len()).unwrap_or(u64::MAX));
+        self.update(&length);
+        self.update(value.as_bytes());
+    }
+
+    fn finish(self) -> ContentHash {
+        ContentHash {
+            crc: self.hasher.finalize(),
+            length: self.length,
+        }
+    }
+}
+
+/// Data that was written by a [`BinaryEncoder`], with its string table
+/// indexed so that it can be shared by values that are decoded separately.
+///
+/// The string table also acts as the interner for decoded values: each string
+/// is only copied out of the table once, and every value that refers to it
+/// shares that copy.
+pub(crate) struct BinaryData {
+    bytes: Vec<u8>,
+    strings: Box<[Range<usize>]>,
+    shared_strings: Box<[OnceLock<Arc<str>>]>,
+    data_start: usize,
+}
+
+impl BinaryData {
+    pub(crate) fn new(bytes: Vec<u8>) -> Result<Arc<Self>, DecodeError> {
+        let mut data = bytes.as_slice();
+
+        let count = read_len(&mut data)?;
+        // Each string takes at least one byte, which guards against
+        // allocating for an invalid count.
+        if count > data.len() {
+            return Err(DecodeError::UnexpectedEnd);
+        }
+
+        let mut strings = Vec::with_capacity(count);
+        for _ in 0..count {
+            let len = read_len(&mut data)?;
+            let start = bytes.len() - data.len();
+            let string = read_bytes(&mut data, len)?;
+            std::str::from_utf8(string).map_err(|_e| DecodeError::InvalidString)?;
+            strings.push(start..start + len);
+        }
+
+        let data_start = bytes.len() - data.len();
+
+        Ok(Arc::new(Self {
+            bytes,
+            shared_strings: strings.iter().map(|_| OnceLock::new()).collect(),
+            strings: strings.into_boxed_slice(),
+            data_start,
+        }))
+    }
+
+    fn str(&self, index: usize) -> Result<&str, DecodeError> {
+        let span = self
+            .strings
+            .get(index)
+            .ok_or(DecodeError::InvalidStringIndex)?;
+
+        let bytes = self
+            .bytes
+            .get(span.clone())
+            .ok_or(DecodeError::InvalidStringIndex)?;
+
+        // The string was validated when the string table was read.
+        std::str::from_utf8(bytes).map_err(|_e| DecodeError::InvalidString)
+    }
+
+    fn shared_str(&self, index: usize) -> Result<Arc<str>, DecodeError> {
+        let shared = self
+            .shared_strings
+            .get(index)
+            .ok_or(DecodeError::InvalidStringIndex)?;
+
+        if let Some(string) = shared.get() {
+            return Ok(Arc::clone(string));
+        }
+
+        let string: Arc<str> = self.str(index)?.into();
+
+        // If another thread has shared the string in the meantime, use its
+        // copy so that there's only one.
+        Ok(Arc::clone(shared.get_or_init(|| string)))
+    }
+
+    /// Get a decoder for all the data after the string table.
+    pub(crate) fn decoder(self: &Arc<Self>) -> BinaryDecoder<'_> {
+        BinaryDecoder {
+            source: self,
+            data: self.bytes.get(self.data_start..).unwrap_or_default(),
+        }
+    }
+}
+
+impl std::fmt::Debug for BinaryData {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("BinaryData")
+            .field("bytes_len", &self.bytes.len())
+            .field("strings_len", &self.strings.len())
+            .finish_non_exhaustive()
+    }
+}
+
+/// A value that was written using [`BinaryEncoder::write_lazy`] and hasn't
+/// been decoded yet.
+#[derive(Clone, Debug)]
+pub(crate) struct LazyValue {
+    source: Arc<BinaryData>,
+    span: Range<usize>,
+    content: ContentHash,
+}
+
+impl LazyValue {
+    /// Check if the two values have the same content without decoding them,
+    /// even if they were written with different string tables.
+    ///
+    /// Like the check for whether compiled metadata is stale, this compares
+    /// CRC-32s and lengths.
+    pub(crate) fn has_same_content(&self, other: &Self) -> bool {
+        self.content == other.content
+    }
+
+    pub(crate) fn decode<T: DecodeBinary>(&self) -> Result<T, DecodeError> {
+        let mut decoder = BinaryDecoder {
+            source: &self.source,
+            data: self
+                .source
+                .bytes
+                .get(self.span.clone())
+                .ok_or(DecodeError::UnexpectedEnd)?,
+        };
+
+        let value = T::decode_binary(&mut decoder)?;
+        decoder.finish()?;
+
+        Ok(value)
+    }
+}
+
+/// Reads metadata from [`BinaryData`].
+#[derive(Debug)]
+pub(crate) struct BinaryDecoder<'a> {
+    source: &'a Arc<BinaryData>,
+    data: &'a [u8],
+}
+
+impl<'a> BinaryDecoder<'a> {
+    pub(crate) fn read_u8(&mut self) -> Result<u8, DecodeError> {
+        read_u8(&mut self.data)
+    }
+
+    pub(crate) fn read_u32(&mut self) -> Result<u32, DecodeError> {
+        u32::try_from(read_varint(&mut self.data)?).map_err(|_e| DecodeError::InvalidValue)
+    }
+
+    pub(crate) fn read_bool(&mut self) -> Result<bool, DecodeError> {
+        match self.read_u8()? {
+            0 => Ok(false),
+            1 => Ok(true),
+            _ => Err(DecodeError::InvalidValue),
+        }
+    }
+
+    pub(crate) fn read_len(&mut self) -> Result<usize, DecodeError> {
+        read_len(&mut self.data)
+    }
+
+    pub(crate) fn read_str(&mut self) -> Result<&'a str, DecodeError> {
+        let source: &'a BinaryData = self.source;
+        source.str(self.read_string_index()?)
+    }
+
+    /// Read a string that's shared with all other values decoded from the
+    /// same data that refer to the same string.
+    pub(crate) fn read_shared_str(&mut self) -> Result<Arc<str>, DecodeError> {
+        let index = self.read_string_index()?;
+        self.source.shared_str(index)
+    }
+
+    pub(crate) fn read_string(&mut self) -> Result<String, DecodeError> {
+        self.read_str().map(ToOwned::to_owned)
+    }
+
+    pub(crate) fn read_option_str(&mut self) -> Result<Option<&'a str>, DecodeError> {
+        if self.read_bool()? {
+            self.read_str().map(Some)
+        } else {
+            Ok(None)
+        }
+    }
+
+    pub(crate) fn read_option_shared_str(&mut self) -> Result<Option<Arc<str>>, DecodeError> {
+        if self.read_bool()? {
+            self.read_shared_str().map(Some)
+        } else {
+            Ok(None)
+        }
+    }
+
+    /// Conditions are only written after they've been validated, so they're
+    /// not parsed until they're evaluated.
+    pub(crate) fn read_condition(&mut self) -> Result<Option<Condition>, DecodeError> {
+        Ok(self.read_option_shared_str()?.map(Condition::validated))
+    }
+
+    pub(crate) fn read_vec<T: DecodeBinary>(&mut self) -> Result<Vec<T>, DecodeError> {
+        let len = self.read_len()?;
+        // Each value takes at least one byte.
+        if len > self.data.len() {
+            return Err(DecodeError::UnexpectedEnd);
+        }
+
+        let mut values = Vec::with_capacity(len);
+        for _ in 0..len {
+            values.push(T::decode_binary(self)?);
+        }
+
+        Ok(values)
+    }
+
+    /// Skip over a value that was written using
+    /// [`BinaryEncoder::write_lazy`], so that it can be decoded later.
+    pub(crate) fn read_lazy(&mut self) -> Result<LazyValue, DecodeError> {
+        let len = self.read_len()?;
+        let start = self.source.bytes.len() - self.data.len();
+        read_bytes(&mut self.data, len)?;
+
+        let content = ContentHash {
+            crc: self.read_u32()?,
+            length: read_varint(&mut self.data)?,
+        };
+
+        Ok(LazyValue {
+            source: Arc::clone(self.source),
+            span: start..start + len,
+            content,
+        })
+    }
+
+    /// Check that all the data has been read.
+    pub(crate) fn finish(self) -> Result<(), DecodeError> {
+        if self.data.is_empty() {
+            Ok(())
+        } else {
+            Err(DecodeError::TrailingData)
+        }
+    }
+
+    fn read_string_index(&mut self) -> Result<usize, DecodeError> {
+        usize::try_from(read_varint(&mut self.data)?).map_err(|_e| DecodeError::InvalidStringIndex)
+    }
+}
+
+fn read_u8(data: &mut &[u8]) -> Result<u8, DecodeError> {
+    let (byte, rest) = data.split_first().ok_or(DecodeError::UnexpectedEnd)?;
+    *data = rest;
+    Ok(*byte)
+}
+
+fn read_bytes<'a>(data: &mut &'a [u8], len: usize) -> Result<&'a [u8], DecodeError> {
+    let (bytes, rest) = data
+        .split_at_checked(len)
+        .ok_or(DecodeError::UnexpectedEnd)?;
+    *data = rest;
+    Ok(bytes)
+}
+
+fn read_len(data: &mut &[u8]) -> Result<usize, DecodeError> {
+    usize::try_from(read_varint(data)?).map_err(|_e| DecodeError::InvalidValue)
+}
+
+fn read_varint(data: &mut &[u8]) -> Result<u64, DecodeError> {
+    let mut value = 0u64;
+    let mut shift = 0u32;
+
+    loop {
+        let byte = read_u8(data)?;
+        let bits = u64::from(byte & 0x7F);
+
+        if shift > 63 || (shift == 63 && bits > 1) {
+            return Err(DecodeError::InvalidValue);
+        }
+
+        value |= bits << shift;
+
+        if byte & 0x80 == 0 {
+            return Ok(value);
+        }
+
+        shift += 7;
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn integers_should_round_trip() {
+        let mut encoder = BinaryEncoder::default();
+        for value in [0, 1, 127, 128, 300, u32::MAX] {
+            encoder.write_u32(value);
+        }
+        encoder.write_len(usize::MAX);
+        encoder.write_bool(true);
+
+        let data = BinaryData::new(encoder.into_bytes()).unwrap();
+        let mut decoder = data.decoder();
+
+        for value in [0, 1, 127, 128, 300, u32::MAX] {
+            assert_eq!(value, decoder.read_u32().unwrap());
+        }
+        assert_eq!(usize::MAX, decoder.read_len().unwrap());
+        assert!(decoder.read_bool().unwrap());
+        decoder.finish().unwrap();
+    }
+
+    #[test]
+    fn strings_should_round_trip_and_only_be_stored_once() {
+        let mut encoder = BinaryEncoder::default();
+        encoder.write_str("a string");
+        encoder.write_option_str(Some("a string"));
+        encoder.write_option_str(None);
+        encoder.write_str("another string");
+
+        let bytes = encoder.into_bytes();
+        assert_eq!(1, bytes.windows(8).filter(|w| *w == b"a string").count());
+
+        let data = BinaryData::new(bytes).unwrap();
+        let mut decoder = data.decoder();
+
+        assert_eq!("a string", decoder.read_str().unwrap());
+        assert_eq!(Some("a string"), decoder.read_option_str().unwrap());
+        assert_eq!(None, decoder.read_option_str().unwrap());
+        assert_eq!("another string", decoder.read_str().unwrap());
+        decoder.finish().unwrap();
+    }
+
+    #[test]
+    fn decoding_should_error_if_data_is_truncated() {
+        let mut encoder = BinaryEncoder::default();
+        encoder.write_str("a string");
+
+        let bytes = encoder.into_bytes();
+
+        assert_eq!(
+            DecodeError::UnexpectedEnd,
+            BinaryData::new(bytes.get(..4).unwrap().to_vec()).unwrap_err()
+        );
+    }
+
+    #[test]
+    fn decoding_should_error_if_a_string_index_is_out_of_range() {
+        let mut encoder = BinaryEncoder::default();
+        encoder.write_u32(5);
+
+        let data = BinaryData::new(encoder.into_bytes()).unwrap();
+        let mut decoder = data.decoder();
+
+        assert_eq!(
+            DecodeError::InvalidStringIndex,
+            decoder.read_str().unwrap_err()
+        );
+    }
+
+    #[test]
+    fn finish_should_error_if_there_is_unread_data() {
+        let mut encoder = BinaryEncoder::default();
+        encoder.write_u8(1);
+
+        let data = BinaryData::new(encoder.into_bytes()).unwrap();
+
+        assert_eq!(
+            DecodeError::TrailingData,
+            data.decoder().finish().unwrap_err()
+        );
+    }
+
+    #[test]
+    fn lazy_values_should_be_skipped_and_decoded_later() {
+        let mut encoder = BinaryEncoder::default();
+        encoder.write_lazy(&"a string".to_owned());
+        encoder.write_str("another string");
+
+        let data = BinaryData::new(encoder.into_bytes()).unwrap();
+        let mut decoder = data.decoder();
+
+        let value = decoder.read_lazy().unwrap();
+        assert_eq!("another string", decoder.read_str().unwrap());
+        decoder.finish().unwrap();
+
+        assert_eq!("a string", value.decode::<String>().unwrap());
+    }
+
+    #[test]
+    fn lazy_values_written_with_different_string_tables_should_have_the_same_content() {
+        let mut encoder = BinaryEncoder::default();
+        encoder.write_lazy(&"a string".to_owned());
+
+        let data = BinaryData::new(encoder.into_bytes()).unwrap();
+        let first = data.decoder().read_lazy().unwrap();
+
+        let mut encoder = BinaryEncoder::default();
+        encoder.write_str("another string");
+        encoder.write_lazy(&"a string".to_owned());
+        encoder.write_lazy(&"another string".to_owned());
+
+        let data = BinaryData::new(encoder.into_bytes()).unwrap();
+        let mut decoder = data.decoder();
+        assert_eq!("another string", decoder.read_str().unwrap());
+        let second = decoder.read_lazy().unwrap();
+        let third = decoder.read_lazy().unwrap();
+
+        assert!(first.has_same_content(&second));
+        assert!(!first.has_same_content(&third));
+    }
+
+    #[test]
+    fn read_shared_str_should_share_one_copy_of_each_string() {
+        let mut encoder = BinaryEncoder::default();
+        encoder.write_str("a string");
+        encoder.write_str("another string");
+        encoder.write_str("a string");
+
+        let data = BinaryData::new(encoder.into_bytes()).unwrap();
+        let mut decoder = data.decoder();
+
+        let first = decoder.read_shared_str().unwrap();
+        let second = decoder.read_shared_str().unwrap();
+        let third = decoder.read_shared_str().unwrap();
+
+        assert_eq!("a string", first.as_ref());
+        assert_eq!("another string", second.as_ref());
+        assert!(Arc::ptr_eq(&first, &third));
+        assert!(!Arc::ptr_eq(&first, &second));
+    }
+}
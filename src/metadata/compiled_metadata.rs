@@ -0,0 +1,268 @@
+use std::path::{Path, PathBuf};
+
+use crate::{escape_ascii, logging};
+
+use super::binary::{BinaryData, BinaryEncoder, DecodeBinary, DecodeError, EncodeBinary};
+
+const MAGIC: &[u8] = b"LOOTMDC\0";
+
+/// This must be incremented whenever the encoding of any metadata type
+/// changes.
+const FORMAT_VERSION: u32 = 3;
+
+const COMPILED_FILE_EXTENSION: &str = "bin";
+
+const CRC_LENGTH: usize = 4;
+
+/// Identifies the source text that compiled metadata was created from, so that
+/// compiled metadata is only used if the text it was created from hasn't
+/// changed.
+#[derive(Clone, Copy, Debug, Eq, PartialEq, Hash)]
+pub(super) struct SourceHashes {
+    masterlist: ContentHash,
+    prelude: Option<ContentHash>,
+}
+
+impl SourceHashes {
+    pub(super) fn new(masterlist: &str, prelude: Option<&str>) -> Self {
+        Self {
+            masterlist: ContentHash::new(masterlist.as_bytes()),
+            prelude: prelude.map(|p| ContentHash::new(p.as_bytes())),
+        }
+    }
+
+    /// The header identifies the file format, the version of libloot that
+    /// wrote it and the source text hashes, so a compiled file is stale if its
+    /// header doesn't exactly match the expected header.
+    fn header(&self) -> Vec<u8> {
+        let mut header = MAGIC.to_vec();
+        header.extend(FORMAT_VERSION.to_le_bytes());
+        header.extend(env!("CARGO_PKG_VERSION").as_bytes());
+        header.push(0);
+
+        self.masterlist.write_to(&mut header);
+        if let Some(prelude) = &self.prelude {
+            header.push(1);
+            prelude.write_to(&mut header);
+        } else {
+            header.push(0);
+        }
+
+        header
+    }
+}
+
+/// Identifies some content by its CRC-32 and length.
+#[derive(Clone, Copy, Debug, Eq, PartialEq, Hash)]
+pub(super) struct ContentHash {
+    pub(super) crc: u32,
+    pub(super) length: u64,
+}
+
+impl ContentHash {
+    pub(super) fn new(content: &[u8]) -> Self {
+        let mut hasher = crc32fast::Hasher::new();
+        hasher.update(content);
+
+        Self {
+            crc: hasher.finalize(),
+            length: u64::try_from(content.len()).unwrap_or(u64::MAX),
+        }
+    }
+
+    fn write_to(self, bytes: &mut Vec<u8>) {
+        bytes.extend(self.crc.to_le_bytes());
+        bytes.extend(self.length.to_le_bytes());
+    }
+}
+
+/// Get the path of the compiled metadata file for the given source file.
+pub(super) fn compiled_path(source_path: &Path) -> PathBuf {
+    let mut path = source_path.as_os_str().to_owned();
+    path.push(".");
+    path.push(COMPILED_FILE_EXTENSION);
+    PathBuf::from(path)
+}
+
+/// Read the compiled metadata for the given source file, returning None if it
+/// doesn't exist, is stale or can't be decoded.
+pub(super) fn read<T: DecodeBinary>(source_path: &Path, hashes: &SourceHashes) -> Option<T> {
+    let path = compiled_path(source_path);
+
+    let mut bytes = std::fs::read(&path).ok()?;
+
+    let header = hashes.header();
+    if !bytes.starts_with(&header) {
+        logging::debug!(
+            "The compiled metadata at \"{}\" is stale, ignoring it",
+            escape_ascii(&path)
+        );
+        return None;
+    }
+
+    let decode = || -> Result<T, DecodeError> {
+        // Values may be decoded lazily, long after the file was read, so check
+        // that the data hasn't been corrupted before using any of it.
+        let body_start = header.len() + CRC_LENGTH;
+        let crc = bytes
+            .get(header.len()..body_start)
+            .and_then(|b| <[u8; CRC_LENGTH]>::try_from(b).ok())
+            .map(u32::from_le_bytes)
+            .ok_or(DecodeError::UnexpectedEnd)?;
+
+        bytes.drain(..body_start);
+
+        if crc != crc32fast::hash(&bytes) {
+            return Err(DecodeError::ChecksumMismatch);
+        }
+
+        let data = BinaryData::new(bytes)?;
+        let mut decoder = data.decoder();
+        let value = T::decode_binary(&mut decoder)?;
+        decoder.finish()?;
+        Ok(value)
+    };
+
+    match decode() {
+        Ok(value) => {
+            logging::trace!("Loaded compiled metadata from \"{}\"", escape_ascii(&path));
+            Some(value)
+        }
+        Err(e) => {
+            logging::warn!(
+                "Failed to decode the compiled metadata at \"{}\", ignoring it: {}",
+                escape_ascii(&path),
+                e
+            );
+            None
+        }
+    }
+}
+
+/// Write compiled metadata for the given source file. Failing to write it only
+/// means that the source file will need to be parsed again next time, so
+/// errors are logged and otherwise ignored.
+pub(super) fn write<T: EncodeBinary>(source_path: &Path, hashes: &SourceHashes, value: &T) {
+    let path = compiled_path(source_path);
+
+    let mut encoder = BinaryEncoder::default();
+    value.encode_binary(&mut encoder);
+
+    let body = encoder.into_bytes();
+
+    let mut bytes = hashes.header();
+    bytes.extend(crc32fast::hash(&body).to_le_bytes());
+    bytes.extend(body);
+
+    // Write to a temporary file first so that a partially-written file is
+    // never read.
+    let mut temp_path = path.clone().into_os_string();
+    temp_path.push(".tmp");
+    let temp_path = PathBuf::from(temp_path);
+
+    let result =
+        std::fs::write(&temp_path, bytes).and_then(|()| std::fs::rename(&temp_path, &path));
+
+    if let Err(e) = result {
+        logging::warn!(
+            "Failed to write compiled metadata to \"{}\": {}",
+            escape_ascii(&path),
+            e
+        );
+
+        if let Err(e) = std::fs::remove_file(&temp_path)
+            && e.kind() != std::io::ErrorKind::NotFound
+        {
+            logging::warn!(
+                "Failed to remove the temporary file at \"{}\": {}",
+                escape_ascii(&temp_path),
+                e
+            );
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::metadata::binary::BinaryDecoder;
+
+    use super::*;
+
+    #[derive(Debug, PartialEq)]
+    struct Value(String);
+
+    impl EncodeBinary for Value {
+        fn encode_binary(&self, encoder: &mut BinaryEncoder) {
+            encoder.write_str(&self.0);
+        }
+    }
+
+    impl DecodeBinary for Value {
+        fn decode_binary(decoder: &mut BinaryDecoder<'_>) -> Result<Self, DecodeError> {
+            decoder.read_string().map(Value)
+        }
+    }
+
+    #[test]
+    fn compiled_path_should_append_the_extension_to_the_source_path() {
+        assert_eq!(
+            PathBuf::from("dir/masterlist.yaml.bin"),
+            compiled_path(Path::new("dir/masterlist.yaml"))
+        );
+    }
+
+    #[test]
+    fn read_should_return_a_written_value_if_the_hashes_match() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let source_path = tmp_dir.path().join("masterlist.yaml");
+        let hashes = SourceHashes::new("source", Some("prelude"));
+
+        write(&source_path, &hashes, &Value("value".into()));
+
+        assert_eq!(
+            Some(Value("value".into())),
+            read::<Value>(&source_path, &hashes)
+        );
+    }
+
+    #[test]
+    fn read_should_return_none_if_the_source_has_changed() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let source_path = tmp_dir.path().join("masterlist.yaml");
+
+        write(
+            &source_path,
+            &SourceHashes::new("source", None),
+            &Value("value".into()),
+        );
+
+        assert!(read::<Value>(&source_path, &SourceHashes::new("changed", None)).is_none());
+        assert!(read::<Value>(&source_path, &SourceHashes::new("source", Some(""))).is_none());
+    }
+
+    #[test]
+    fn read_should_return_none_if_the_compiled_file_is_corrupt() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let source_path = tmp_dir.path().join("masterlist.yaml");
+        let hashes = SourceHashes::new("source", None);
+
+        write(&source_path, &hashes, &Value("value".into()));
+
+        let path = compiled_path(&source_path);
+        let mut bytes = std::fs::read(&path).unwrap();
+        if let Some(byte) = bytes.last_mut() {
+            *byte ^= 0xFF;
+        }
+        std::fs::write(&path, bytes).unwrap();
+
+        assert!(read::<Value>(&source_path, &hashes).is_none());
+    }
+
+    #[test]
+    fn read_should_return_none_if_there_is_no_compiled_file() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let source_path = tmp_dir.path().join("masterlist.yaml");
+
+        assert!(read::<Value>(&source_path, &SourceHashes::new("source", None)).is_none());
+    }
+}
@@ -0,0 +1,166 @@
+use std::{
+    str::FromStr,
+    sync::{Arc, OnceLock},
+};
+
+use loot_condition_interpreter::{Error, Expression, State};
+
+/// A metadata condition string, stored with its parsed expression so that the
+/// string doesn't need to be parsed again every time the condition is
+/// evaluated.
+///
+/// Values are compared, ordered and hashed using only their strings. The
+/// string is reference-counted so that equal conditions can share it, which
+/// also lets comparisons between them skip comparing the strings' contents.
+#[derive(Clone)]
+pub(crate) struct Condition {
+    string: Arc<str>,
+    // This holds None if the string is not a valid condition. Conditions read
+    // from metadata files are validated when they're parsed, but conditions
+    // set through the API are not, so parsing is retried during evaluation to
+    // report the error there. It's uninitialised if the condition was already
+    // validated and hasn't been evaluated yet.
+    expression: OnceLock<Option<Arc<Expression>>>,
+}
+
+impl Condition {
+    pub(crate) fn new(string: String) -> Self {
+        let expression = Expression::from_str(&string).ok().map(Arc::new);
+
+        Self {
+            string: string.into(),
+            expression: OnceLock::from(expression),
+        }
+    }
+
+    pub(crate) fn parse(string: String) -> Result<Self, Error> {
+        let expression = Expression::from_str(&string)?;
+
+        Ok(Self {
+            string: string.into(),
+            expression: OnceLock::from(Some(Arc::new(expression))),
+        })
+    }
+
+    /// Create a condition from a string that has already been validated,
+    /// deferring parsing it until it's first evaluated.
+    pub(crate) fn validated(string: Arc<str>) -> Self {
+        Self {
+            string,
+            expression: OnceLock::new(),
+        }
+    }
+
+    pub(crate) fn as_str(&self) -> &str {
+        &self.string
+    }
+
+    pub(crate) fn shared_str(&self) -> Arc<str> {
+        Arc::clone(&self.string)
+    }
+
+    pub(crate) fn evaluate(&self, state: &State) -> Result<bool, Error> {
+        let expression = self
+            .expression
+            .get_or_init(|| Expression::from_str(&self.string).ok().map(Arc::new));
+
+        match expression {
+            Some(expression) => expression.eval(state),
+            None => Expression::from_str(&self.string).and_then(|e| e.eval(state)),
+        }
+    }
+}
+
+impl std::fmt::Debug for Condition {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        self.string.fmt(f)
+    }
+}
+
+impl std::fmt::Display for Condition {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        self.string.fmt(f)
+    }
+}
+
+impl PartialEq for Condition {
+    fn eq(&self, other: &Self) -> bool {
+        Arc::ptr_eq(&self.string, &other.string) || self.string == other.string
+    }
+}
+
+impl Eq for Condition {}
+
+impl PartialOrd for Condition {
+    fn partial_cmp(&self, other: &Self) -> Option<std::cmp::Ordering> {
+        Some(self.cmp(other))
+    }
+}
+
+impl Ord for Condition {
+    fn cmp(&self, other: &Self) -> std::cmp::Ordering {
+        self.string.cmp(&other.string)
+    }
+}
+
+impl std::hash::Hash for Condition {
+    fn hash<H: std::hash::Hasher>(&self, state: &mut H) {
+        self.string.hash(state);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::tests::source_plugins_path;
+
+    use super::*;
+
+    fn state() -> State {
+        State::new(
+            loot_condition_interpreter::GameType::Oblivion,
+            source_plugins_path(crate::GameType::Oblivion),
+        )
+    }
+
+    #[test]
+    fn new_should_store_the_parsed_expression_if_the_string_is_valid() {
+        let condition = Condition::new("file(\"Blank.esp\")".into());
+
+        assert!(condition.expression.get().unwrap().is_some());
+        assert!(condition.evaluate(&state()).unwrap());
+    }
+
+    #[test]
+    fn validated_should_parse_the_string_when_first_evaluated() {
+        let condition = Condition::validated("file(\"Blank.esp\")".into());
+
+        assert!(condition.expression.get().is_none());
+        assert!(condition.evaluate(&state()).unwrap());
+        assert!(condition.expression.get().unwrap().is_some());
+    }
+
+    #[test]
+    fn evaluate_should_error_if_the_string_is_not_a_valid_condition() {
+        let condition = Condition::new("invalid".into());
+
+        assert!(condition.expression.get().unwrap().is_none());
+        assert!(condition.evaluate(&state()).is_err());
+    }
+
+    #[test]
+    fn parse_should_error_if_the_string_is_not_a_valid_condition() {
+        assert!(Condition::parse("invalid".into()).is_err());
+    }
+
+    #[test]
+    fn conditions_should_be_equal_if_their_strings_are_equal() {
+        assert_eq!(
+            Condition::new("file(\"Blank.esp\")".into()),
+            Condition::parse("file(\"Blank.esp\")".into()).unwrap()
+        );
+        assert_ne!(
+            Condition::new("file(\"Blank.esp\")".into()),
+            Condition::new("file(\"Blank.esm\")".into())
+        );
+    }
+}
@@ -9,7 +9,10 @@ use crate::{
     metadata::{MessageContent, PreludeDiffSpan},
 };
 
-use super::yaml::{YamlObjectType, to_unmarked_yaml};
+use super::{
+    binary::DecodeError,
+    yaml::{YamlObjectType, to_unmarked_yaml},
+};
 
 /// Represents an error that occurred when validating a collection of
 /// [`MessageContent`] objects.
@@ -210,6 +213,7 @@ pub(super) enum MetadataParsingErrorReason {
     MissingSubstitution(String),
     NonU32Number(i64),
     DuplicateEntry(String, YamlObjectType),
+    UnknownJournalOperation(String),
     PreludeSubstitutionOverflow {
         new_prelude_count: usize,
         old_prelude_count: usize,
@@ -252,6 +256,9 @@ impl std::fmt::Display for MetadataParsingErrorReason {
                 f,
                 "more than one entry exists for {yaml_object_type} \"{id}\""
             ),
+            Self::UnknownJournalOperation(operation) => {
+                write!(f, "unknown userlist journal operation \"{operation}\"")
+            }
             Self::PreludeSubstitutionOverflow {
                 new_prelude_count,
                 old_prelude_count,
@@ -355,6 +362,7 @@ pub(super) enum MetadataDocumentParsingError {
     IoError(std::io::Error),
     MetadataParsingError(ParseMetadataError),
     YamlMergeKeyError(YamlMergeKeyError),
+    CompiledMetadataError(DecodeError),
 }
 
 impl std::fmt::Display for MetadataDocumentParsingError {
@@ -368,6 +376,9 @@ impl std::fmt::Display for MetadataDocumentParsingError {
             Self::YamlMergeKeyError(_) => {
                 write!(f, "an error occurred while resolving YAML merge keys")
             }
+            Self::CompiledMetadataError(_) => {
+                write!(f, "an error occurred while decoding compiled metadata")
+            }
         }
     }
 }
@@ -379,6 +390,7 @@ impl std::error::Error for MetadataDocumentParsingError {
             Self::IoError(e) => Some(e),
             Self::MetadataParsingError(e) => Some(e),
             Self::YamlMergeKeyError(e) => Some(e),
+            Self::CompiledMetadataError(e) => Some(e),
         }
     }
 }
@@ -1,10 +1,16 @@
+use std::sync::Arc;
+
 use saphyr::{MarkedYaml, Scalar, YamlData};
 use unicase::UniCase;
 
 use crate::metadata::yaml::YamlAnchors;
 
 use super::{
+    binary::{BinaryDecoder, BinaryEncoder, DecodeBinary, DecodeError, EncodeBinary},
+    condition::Condition,
     error::{ExpectedType, MultilingualMessageContentsError, ParseMetadataError},
+    interner::{InternStrings, StringInterner},
+    localise::SelectLanguage,
     message::{
         MessageContent, emit_message_contents, parse_message_contents_yaml,
         validate_message_contents,
@@ -20,10 +26,10 @@ use super::{
 #[derive(Clone, Debug, Default, Eq, PartialEq, Ord, PartialOrd, Hash)]
 pub struct File {
     name: Filename,
-    display_name: Option<Box<str>>,
+    display_name: Option<Arc<str>>,
     detail: Box<[MessageContent]>,
-    condition: Option<Box<str>>,
-    constraint: Option<Box<str>>,
+    condition: Option<Condition>,
+    constraint: Option<Condition>,
 }
 
 impl File {
@@ -43,14 +49,14 @@ impl File {
     /// CommonMark.
     #[must_use]
     pub fn with_display_name(mut self, display_name: String) -> Self {
-        self.display_name = Some(display_name.into_boxed_str());
+        self.display_name = Some(display_name.into());
         self
     }
 
     /// Set the condition string.
     #[must_use]
     pub fn with_condition(mut self, condition: String) -> Self {
-        self.condition = Some(condition.into_boxed_str());
+        self.condition = Some(Condition::new(condition));
         self
     }
 
@@ -69,7 +75,7 @@ impl File {
     /// Set the constraint string.
     #[must_use]
     pub fn with_constraint(mut self, constraint: String) -> Self {
-        self.constraint = Some(constraint.into_boxed_str());
+        self.constraint = Some(Condition::new(constraint));
         self
     }
 
@@ -94,18 +100,26 @@ impl File {
 
     /// Get the condition string.
     pub fn condition(&self) -> Option<&str> {
-        self.condition.as_deref()
+        self.condition.as_ref().map(Condition::as_str)
     }
 
     /// Get the constraint string.
     pub fn constraint(&self) -> Option<&str> {
-        self.constraint.as_deref()
+        self.constraint.as_ref().map(Condition::as_str)
+    }
+
+    pub(crate) fn parsed_condition(&self) -> Option<&Condition> {
+        self.condition.as_ref()
+    }
+
+    pub(crate) fn parsed_constraint(&self) -> Option<&Condition> {
+        self.constraint.as_ref()
     }
 }
 
 /// Represents a case-insensitive filename.
 #[derive(Clone, Debug, Default)]
-pub struct Filename(Box<str>);
+pub struct Filename(Arc<str>);
 
 impl Filename {
     /// Create a value using the given string.
@@ -122,7 +136,7 @@ impl Filename {
 
 impl PartialEq for Filename {
     fn eq(&self, other: &Self) -> bool {
-        unicase::eq(&self.0, &other.0)
+        Arc::ptr_eq(&self.0, &other.0) || unicase::eq(&self.0, &other.0)
     }
 }
 
@@ -242,12 +256,12 @@ impl EmitYaml for &File {
 
                     if let Some(condition) = &self.condition {
                         e.write_map_key("condition");
-                        e.write_condition(condition);
+                        e.write_condition(condition.as_str());
                     }
 
                     if let Some(constraint) = &self.constraint {
                         e.write_map_key("constraint");
-                        e.write_condition(constraint);
+                        e.write_condition(constraint.as_str());
                     }
 
                     e.end_map();
@@ -271,6 +285,48 @@ impl EmitYaml for File {
     }
 }
 
+impl EncodeBinary for File {
+    fn encode_binary(&self, encoder: &mut BinaryEncoder) {
+        encoder.write_str(self.name.as_str());
+        encoder.write_option_str(self.display_name.as_deref());
+        encoder.write_slice(&self.detail);
+        encoder.write_condition(self.condition.as_ref());
+        encoder.write_condition(self.constraint.as_ref());
+    }
+}
+
+impl DecodeBinary for File {
+    fn decode_binary(decoder: &mut BinaryDecoder<'_>) -> Result<Self, DecodeError> {
+        Ok(Self {
+            name: Filename(decoder.read_shared_str()?),
+            display_name: decoder.read_option_shared_str()?,
+            detail: decoder.read_vec()?.into_boxed_slice(),
+            condition: decoder.read_condition()?,
+            constraint: decoder.read_condition()?,
+        })
+    }
+}
+
+impl InternStrings for File {
+    fn intern_strings(&mut self, interner: &mut StringInterner) {
+        self.name.0.intern_strings(interner);
+        self.display_name.intern_strings(interner);
+        self.detail.intern_strings(interner);
+        self.condition.intern_strings(interner);
+        self.constraint.intern_strings(interner);
+    }
+}
+
+impl SelectLanguage for File {
+    fn select_language(&mut self, language: &str) {
+        self.detail.select_language(language);
+    }
+
+    fn is_multilingual(&self) -> bool {
+        self.detail.is_multilingual()
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -1,6 +1,7 @@
 use saphyr::MarkedYaml;
 
 use super::{
+    binary::{BinaryDecoder, BinaryEncoder, DecodeBinary, DecodeError, EncodeBinary},
     error::ParseMetadataError,
     yaml::{
         EmitYaml, TryFromYaml, YamlEmitter, YamlObjectType, as_mapping, get_required_string_value,
@@ -118,6 +119,24 @@ impl EmitYaml for Group {
     }
 }
 
+impl EncodeBinary for Group {
+    fn encode_binary(&self, encoder: &mut BinaryEncoder) {
+        encoder.write_str(&self.name);
+        encoder.write_option_str(self.description.as_deref());
+        encoder.write_slice(&self.after_groups);
+    }
+}
+
+impl DecodeBinary for Group {
+    fn decode_binary(decoder: &mut BinaryDecoder<'_>) -> Result<Self, DecodeError> {
+        Ok(Self {
+            name: decoder.read_str()?.into(),
+            description: decoder.read_option_str()?.map(Into::into),
+            after_groups: decoder.read_vec()?.into_boxed_slice(),
+        })
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
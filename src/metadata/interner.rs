@@ -0,0 +1,131 @@
+use std::{
+    collections::{HashMap, HashSet},
+    sync::Arc,
+};
+
+use super::condition::Condition;
+
+/// Deduplicates the strings in metadata that's parsed from a metadata file.
+///
+/// Masterlists repeat the same conditions, message text, filenames and URLs
+/// many times (often through YAML anchors and aliases, which are copied when
+/// they're resolved), so after parsing, each distinct string is stored once
+/// and shared by every value that uses it. This also means that most equality
+/// checks between those values only need to compare pointers.
+#[derive(Debug, Default)]
+pub(super) struct StringInterner {
+    strings: HashSet<Arc<str>>,
+    conditions: HashMap<Arc<str>, Condition>,
+}
+
+impl StringInterner {
+    fn intern(&mut self, string: &mut Arc<str>) {
+        if let Some(interned) = self.strings.get(&*string) {
+            *string = Arc::clone(interned);
+        } else {
+            self.strings.insert(Arc::clone(string));
+        }
+    }
+
+    /// Conditions are interned as a whole, so that equal conditions also share
+    /// their parsed expressions.
+    fn intern_condition(&mut self, condition: &mut Condition) {
+        if let Some(interned) = self.conditions.get(condition.as_str()) {
+            condition.clone_from(interned);
+        } else {
+            self.conditions
+                .insert(condition.shared_str(), condition.clone());
+        }
+    }
+}
+
+pub(super) trait InternStrings {
+    fn intern_strings(&mut self, interner: &mut StringInterner);
+}
+
+impl InternStrings for Arc<str> {
+    fn intern_strings(&mut self, interner: &mut StringInterner) {
+        interner.intern(self);
+    }
+}
+
+impl InternStrings for Condition {
+    fn intern_strings(&mut self, interner: &mut StringInterner) {
+        interner.intern_condition(self);
+    }
+}
+
+impl<T: InternStrings> InternStrings for Option<T> {
+    fn intern_strings(&mut self, interner: &mut StringInterner) {
+        if let Some(value) = self {
+            value.intern_strings(interner);
+        }
+    }
+}
+
+impl<T: InternStrings> InternStrings for [T] {
+    fn intern_strings(&mut self, interner: &mut StringInterner) {
+        for value in self {
+            value.intern_strings(interner);
+        }
+    }
+}
+
+impl<T: InternStrings> InternStrings for Arc<[T]> {
+    fn intern_strings(&mut self, interner: &mut StringInterner) {
+        // Values that are already shared don't need to be made unique just to
+        // share their strings.
+        if let Some(values) = Arc::get_mut(self) {
+            values.intern_strings(interner);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn intern_strings_should_share_equal_strings() {
+        let mut interner = StringInterner::default();
+
+        let mut strings: [Arc<str>; 3] = ["a".into(), "b".into(), "a".into()];
+        strings.intern_strings(&mut interner);
+
+        let [first, second, third] = strings;
+        assert!(Arc::ptr_eq(&first, &third));
+        assert!(!Arc::ptr_eq(&first, &second));
+    }
+
+    #[test]
+    fn intern_strings_should_share_equal_conditions() {
+        let mut interner = StringInterner::default();
+
+        let mut conditions = [
+            Condition::new("file(\"a\")".into()),
+            Condition::new("file(\"a\")".into()),
+        ];
+        conditions.intern_strings(&mut interner);
+
+        let [first, second] = conditions;
+        assert!(Arc::ptr_eq(&first.shared_str(), &second.shared_str()));
+    }
+
+    #[test]
+    fn intern_strings_should_not_modify_a_shared_slice() {
+        let mut interner = StringInterner::default();
+        let mut string: Arc<str> = "a".into();
+        string.intern_strings(&mut interner);
+
+        let mut slice: Arc<[Arc<str>]> = vec!["a".into()].into();
+        let shared = Arc::clone(&slice);
+        slice.intern_strings(&mut interner);
+
+        assert!(!Arc::ptr_eq(&string, &slice[0]));
+
+        drop(shared);
+        slice.intern_strings(&mut interner);
+
+        assert!(Arc::ptr_eq(&string, &slice[0]));
+    }
+}
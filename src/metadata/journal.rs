@@ -0,0 +1,677 @@
+use std::{
+    collections::BTreeSet,
+    io::{Read, Seek, SeekFrom, Write},
+    path::{Path, PathBuf},
+};
+
+use saphyr::{LoadableYamlNode, MarkedYaml};
+
+use crate::{escape_ascii, logging};
+
+use super::{
+    compiled_metadata::ContentHash,
+    error::{
+        LoadMetadataError, MetadataParsingErrorReason, ParseMetadataError, WriteMetadataError,
+    },
+    file::Filename,
+    group::Group,
+    message::Message,
+    metadata_document::MetadataDocument,
+    plugin_metadata::PluginMetadata,
+    yaml::{
+        EmitYaml, TryFromYaml, YamlAnchors, YamlEmitter, YamlObjectType, as_mapping,
+        get_required_string_value, get_slice_value, get_strings_vec_value,
+    },
+};
+
+const JOURNAL_FILE_EXTENSION: &str = "journal";
+
+const ENTRY_START: &str = "---\n";
+
+/// Each entry ends with a YAML document end marker, so an entry that was only
+/// partially written (e.g. because the process was killed) can be detected.
+const ENTRY_END: &str = "\n...\n";
+
+/// The first entry in a journal identifies the userlist content that the
+/// journal's changes were written against.
+const HEADER_OPERATION: &str = "userlist";
+
+/// The journal isn't compacted until it's at least this large, so that small
+/// userlists aren't rewritten every few changes.
+const MIN_COMPACTION_SIZE: u64 = 64 * 1024;
+
+/// Tracks which parts of a userlist have changed since it was last loaded or
+/// written, so that only those parts need to be written to its journal.
+///
+/// Changes are tracked by what they changed instead of being logged, so
+/// changing the same metadata many times before it's written only writes its
+/// latest value once.
+#[derive(Clone, Debug, Default, Eq, PartialEq)]
+pub(crate) struct UserlistChanges {
+    discarded_all: bool,
+    bash_tags: bool,
+    groups: bool,
+    messages: bool,
+    plugins: BTreeSet<Filename>,
+}
+
+impl UserlistChanges {
+    pub(crate) fn set_bash_tags(&mut self) {
+        self.bash_tags = true;
+    }
+
+    pub(crate) fn set_groups(&mut self) {
+        self.groups = true;
+    }
+
+    pub(crate) fn set_messages(&mut self) {
+        self.messages = true;
+    }
+
+    /// Record that the user metadata entries with the given plugin name have
+    /// been set or discarded.
+    pub(crate) fn set_plugin(&mut self, plugin_name: &str) {
+        self.plugins.insert(Filename::new(plugin_name.to_owned()));
+    }
+
+    /// Discarding all user metadata supersedes any earlier changes.
+    pub(crate) fn discard_all(&mut self) {
+        *self = Self {
+            discarded_all: true,
+            ..Self::default()
+        };
+    }
+
+    pub(crate) fn is_empty(&self) -> bool {
+        *self == Self::default()
+    }
+}
+
+/// Get the path of the journal file for the given userlist.
+fn journal_path(userlist_path: &Path) -> PathBuf {
+    let mut path = userlist_path.as_os_str().to_owned();
+    path.push(".");
+    path.push(JOURNAL_FILE_EXTENSION);
+    PathBuf::from(path)
+}
+
+/// Append entries for the given changes to the userlist's journal, taking the
+/// changed metadata from the given document. Returns the size of the journal
+/// after the entries have been written.
+pub(crate) fn append(
+    userlist_path: &Path,
+    document: &MetadataDocument,
+    changes: &UserlistChanges,
+) -> Result<u64, WriteMetadataError> {
+    let path = journal_path(userlist_path);
+
+    let mut entries = String::new();
+
+    if changes.discarded_all {
+        write_entry(&mut entries, "discard_all", |_| {});
+    }
+
+    if changes.bash_tags {
+        write_entry(&mut entries, "set_bash_tags", |e| {
+            if !document.bash_tags().is_empty() {
+                e.write_map_key("bash_tags");
+                e.begin_array();
+                for tag in document.bash_tags() {
+                    e.write_unquoted_str(tag);
+                }
+                e.end_array();
+            }
+        });
+    }
+
+    if changes.groups {
+        write_entry(&mut entries, "set_groups", |e| {
+            if !document.groups().is_empty() {
+                e.write_map_key("groups");
+                document.groups().emit_yaml(e);
+            }
+        });
+    }
+
+    if changes.messages {
+        write_entry(&mut entries, "set_messages", |e| {
+            if !document.messages().is_empty() {
+                e.write_map_key("globals");
+                document.messages().emit_yaml(e);
+            }
+        });
+    }
+
+    for name in &changes.plugins {
+        let plugins = document.plugin_entries_named(name.as_str());
+
+        write_entry(&mut entries, "replace_plugin", |e| {
+            e.write_map_key("name");
+            e.write_single_quoted_str(name.as_str());
+
+            if !plugins.is_empty() {
+                e.write_map_key("plugins");
+                plugins.emit_yaml(e);
+            }
+        });
+    }
+
+    let write = || -> std::io::Result<u64> {
+        let mut file = std::fs::OpenOptions::new()
+            .create(true)
+            .read(true)
+            .write(true)
+            .truncate(false)
+            .open(&path)?;
+
+        // If an earlier write was interrupted, the journal ends with an
+        // incomplete entry that must be removed, or the entries written now
+        // would be read as part of it.
+        let length = file.seek(SeekFrom::End(0))?;
+        let complete_length = complete_length(&mut file, length)?;
+        if complete_length < length {
+            logging::warn!(
+                "Removing an incomplete change from the end of the userlist journal at \"{}\"",
+                escape_ascii(&path)
+            );
+            file.set_len(complete_length)?;
+        }
+        file.seek(SeekFrom::Start(complete_length))?;
+
+        let mut content = String::new();
+        if complete_length == 0 {
+            content.push_str(&header(userlist_hash(userlist_path)?));
+        }
+        content.push_str(&entries);
+
+        // Write all the entries at once so that they're as unlikely as
+        // possible to be interleaved with a partial write.
+        file.write_all(content.as_bytes())?;
+
+        Ok(file.metadata()?.len())
+    };
+
+    write().map_err(|e| WriteMetadataError::new(path.clone(), e.into()))
+}
+
+/// Get the journal header entry for the given userlist content hash.
+fn header(userlist_hash: ContentHash) -> String {
+    let mut header = String::new();
+
+    write_entry(&mut header, HEADER_OPERATION, |e| {
+        e.write_map_key("crc");
+        e.write_unquoted_str(&format!("0x{:08X}", userlist_hash.crc));
+        e.write_map_key("length");
+        e.write_unquoted_str(&userlist_hash.length.to_string());
+    });
+
+    header
+}
+
+/// Hash the userlist's content, treating a userlist that doesn't exist as
+/// empty.
+fn userlist_hash(userlist_path: &Path) -> std::io::Result<ContentHash> {
+    match std::fs::read(userlist_path) {
+        Ok(bytes) => Ok(ContentHash::new(&bytes)),
+        Err(e) if e.kind() == std::io::ErrorKind::NotFound => Ok(ContentHash::new(&[])),
+        Err(e) => Err(e),
+    }
+}
+
+fn write_entry<F: FnOnce(&mut YamlEmitter)>(entries: &mut String, operation: &str, write: F) {
+    let mut emitter = YamlEmitter::new(YamlAnchors::new());
+
+    emitter.begin_map();
+    emitter.write_map_key("op");
+    emitter.write_unquoted_str(operation);
+    write(&mut emitter);
+    emitter.end_map();
+
+    entries.push_str(ENTRY_START);
+    entries.push_str(&emitter.into_string());
+    entries.push_str(ENTRY_END);
+}
+
+/// Check if the userlist's journal has grown large enough relative to the
+/// userlist that it should be compacted into the userlist. Compacting once the
+/// journal is as large as the userlist keeps the amortised cost of writing
+/// changes proportional to the size of the changes.
+///
+/// The journal is only replayed when loading its userlist, so if the userlist
+/// doesn't exist it must be written.
+pub(crate) fn should_compact(userlist_path: &Path, journal_size: u64) -> bool {
+    match std::fs::metadata(userlist_path) {
+        Ok(metadata) => journal_size >= metadata.len().max(MIN_COMPACTION_SIZE),
+        Err(_) => true,
+    }
+}
+
+/// Remove the userlist's journal, e.g. because its changes have been written
+/// to the userlist.
+pub(crate) fn remove(userlist_path: &Path) -> Result<(), WriteMetadataError> {
+    let path = journal_path(userlist_path);
+
+    match std::fs::remove_file(&path) {
+        Ok(()) => Ok(()),
+        Err(e) if e.kind() == std::io::ErrorKind::NotFound => Ok(()),
+        Err(e) => Err(WriteMetadataError::new(path, e.into())),
+    }
+}
+
+/// Apply the changes recorded in the userlist's journal, if it has one, to the
+/// given document.
+///
+/// If the journal wasn't written against the userlist's current content (e.g.
+/// because the userlist has since been replaced without using libloot), its
+/// changes are ignored and it's removed, so that later changes aren't
+/// appended to it.
+pub(crate) fn replay(
+    userlist_path: &Path,
+    document: &mut MetadataDocument,
+) -> Result<(), LoadMetadataError> {
+    let path = journal_path(userlist_path);
+
+    let content = match std::fs::read(&path) {
+        Ok(c) => c,
+        Err(e) if e.kind() == std::io::ErrorKind::NotFound => return Ok(()),
+        Err(e) => return Err(LoadMetadataError::from_io_error(path, e)),
+    };
+
+    let content = complete_entries(&content, &path);
+    if content.is_empty() {
+        return Ok(());
+    }
+
+    let userlist_hash = userlist_hash(userlist_path)
+        .map_err(|e| LoadMetadataError::from_io_error(userlist_path.into(), e))?;
+
+    let Some(content) = content.strip_prefix(header(userlist_hash).as_bytes()) else {
+        logging::warn!(
+            "The userlist journal at \"{}\" was not written for the current content of \"{}\", ignoring and removing it",
+            escape_ascii(&path),
+            escape_ascii(userlist_path)
+        );
+        if let Err(e) = remove(userlist_path) {
+            logging::error!("{e}");
+        }
+        return Ok(());
+    };
+
+    let content = std::str::from_utf8(content).map_err(|e| {
+        LoadMetadataError::from_io_error(
+            path.clone(),
+            std::io::Error::new(std::io::ErrorKind::InvalidData, e),
+        )
+    })?;
+
+    let entries = MarkedYaml::load_from_str(content)
+        .map_err(|e| LoadMetadataError::new(path.clone(), e.into()))?;
+
+    for entry in &entries {
+        apply_entry(entry, document).map_err(|e| LoadMetadataError::new(path.clone(), e.into()))?;
+    }
+
+    logging::debug!(
+        "Replayed {} userlist changes from \"{}\"",
+        entries.len(),
+        escape_ascii(&path)
+    );
+
+    Ok(())
+}
+
+/// Get the length of the given journal content's entries that were completely
+/// written.
+fn complete_entries_length(content: &[u8]) -> usize {
+    content
+        .windows(ENTRY_END.len())
+        .rposition(|window| window == ENTRY_END.as_bytes())
+        .map_or(0, |index| index + ENTRY_END.len())
+}
+
+/// Get the length of the entries in the given journal file that were
+/// completely written. Only the end of the file is read unless its last entry
+/// is incomplete.
+fn complete_length(file: &mut std::fs::File, length: u64) -> std::io::Result<u64> {
+    let mut tail = [0; ENTRY_END.len()];
+    let tail_length = u64::try_from(tail.len()).unwrap_or(u64::MAX);
+
+    if let Some(tail_start) = length.checked_sub(tail_length) {
+        file.seek(SeekFrom::Start(tail_start))?;
+        file.read_exact(&mut tail)?;
+
+        if tail.as_slice() == ENTRY_END.as_bytes() {
+            return Ok(length);
+        }
+    }
+
+    let mut content = Vec::new();
+    file.seek(SeekFrom::Start(0))?;
+    file.read_to_end(&mut content)?;
+
+    Ok(u64::try_from(complete_entries_length(&content)).unwrap_or(u64::MAX))
+}
+
+/// Get the entries in the given journal content that were completely written,
+/// logging a warning if there's an incomplete entry at the end.
+fn complete_entries<'a>(content: &'a [u8], path: &Path) -> &'a [u8] {
+    let (complete, rest) = content
+        .split_at_checked(complete_entries_length(content))
+        .unwrap_or((content, &[]));
+
+    if !rest.trim_ascii().is_empty() {
+        logging::warn!(
+            "Ignoring an incomplete change at the end of the userlist journal at \"{}\"",
+            escape_ascii(path)
+        );
+    }
+
+    complete
+}
+
+fn apply_entry(
+    entry: &MarkedYaml,
+    document: &mut MetadataDocument,
+) -> Result<(), ParseMetadataError> {
+    let mapping = as_mapping(entry, YamlObjectType::JournalEntry)?;
+
+    let operation = get_required_string_value(
+        entry.span.start,
+        mapping,
+        "op",
+        YamlObjectType::JournalEntry,
+    )?;
+
+    match operation {
+        "discard_all" => document.clear(),
+        "set_bash_tags" => {
+            let bash_tags =
+                get_strings_vec_value(mapping, "bash_tags", YamlObjectType::JournalEntry)?;
+            document.set_bash_tags(bash_tags.into_iter().map(ToOwned::to_owned).collect());
+        }
+        "set_groups" => {
+            let groups = get_slice_value(mapping, "groups", YamlObjectType::JournalEntry)?
+                .iter()
+                .map(Group::try_from_yaml)
+                .collect::<Result<Vec<_>, _>>()?;
+            document.set_groups(groups);
+        }
+        "set_messages" => {
+            let messages = get_slice_value(mapping, "globals", YamlObjectType::JournalEntry)?
+                .iter()
+                .map(Message::try_from_yaml)
+                .collect::<Result<Vec<_>, _>>()?;
+            document.set_messages(messages);
+        }
+        "replace_plugin" => {
+            let name = get_required_string_value(
+                entry.span.start,
+                mapping,
+                "name",
+                YamlObjectType::JournalEntry,
+            )?;
+            let plugins = get_slice_value(mapping, "plugins", YamlObjectType::JournalEntry)?
+                .iter()
+                .map(PluginMetadata::try_from_yaml)
+                .collect::<Result<Vec<_>, _>>()?;
+
+            document.remove_plugin_metadata(name);
+            for plugin in plugins {
+                document.set_plugin_metadata(plugin);
+            }
+        }
+        _ => {
+            return Err(ParseMetadataError::new(
+                entry.span.start,
+                MetadataParsingErrorReason::UnknownJournalOperation(operation.to_owned()),
+            ));
+        }
+    }
+
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use tempfile::tempdir;
+
+    use crate::metadata::MessageType;
+
+    use super::*;
+
+    fn plugin(name: &str, group: &str) -> PluginMetadata {
+        let mut plugin = PluginMetadata::new(name).unwrap();
+        plugin.set_group(group.into());
+        plugin
+    }
+
+    #[test]
+    fn replay_should_do_nothing_if_there_is_no_journal() {
+        let tmp_dir = tempdir().unwrap();
+        let userlist_path = tmp_dir.path().join("userlist.yaml");
+
+        let mut document = MetadataDocument::default();
+        replay(&userlist_path, &mut document).unwrap();
+
+        assert_eq!(MetadataDocument::default(), document);
+    }
+
+    #[test]
+    fn replay_should_apply_appended_changes() {
+        let tmp_dir = tempdir().unwrap();
+        let userlist_path = tmp_dir.path().join("userlist.yaml");
+
+        let mut document = MetadataDocument::default();
+        let mut changes = UserlistChanges::default();
+
+        document.set_bash_tags(vec!["Relev".into()]);
+        changes.set_bash_tags();
+        document.set_groups(vec![Group::new("group1".into())]);
+        changes.set_groups();
+        document.set_messages(vec![Message::new(MessageType::Say, "text".into())]);
+        changes.set_messages();
+        document.set_plugin_metadata(plugin("Blank.esp", "group1"));
+        changes.set_plugin("Blank.esp");
+        document.set_plugin_metadata(plugin("Blank\\.es(m|p)", "group1"));
+        document.set_plugin_metadata(plugin("Blank\\.es(m|p)", "default"));
+        changes.set_plugin("Blank\\.es(m|p)");
+
+        append(&userlist_path, &document, &changes).unwrap();
+
+        let mut replayed = MetadataDocument::default();
+        replay(&userlist_path, &mut replayed).unwrap();
+
+        assert_eq!(document, replayed);
+    }
+
+    #[test]
+    fn replay_should_apply_later_changes_over_earlier_changes() {
+        let tmp_dir = tempdir().unwrap();
+        let userlist_path = tmp_dir.path().join("userlist.yaml");
+
+        let mut document = MetadataDocument::default();
+        let mut changes = UserlistChanges::default();
+
+        document.set_plugin_metadata(plugin("Blank.esp", "group1"));
+        document.set_plugin_metadata(plugin("Blank.esm", "group1"));
+        changes.set_plugin("Blank.esp");
+        changes.set_plugin("Blank.esm");
+        append(&userlist_path, &document, &changes).unwrap();
+
+        let mut changes = UserlistChanges::default();
+        document.remove_plugin_metadata("Blank.esp");
+        document.set_plugin_metadata(plugin("Blank.esm", "group2"));
+        changes.set_plugin("blank.esp");
+        changes.set_plugin("Blank.esm");
+        append(&userlist_path, &document, &changes).unwrap();
+
+        let mut replayed = MetadataDocument::default();
+        replay(&userlist_path, &mut replayed).unwrap();
+
+        assert!(replayed.find_plugin("Blank.esp").unwrap().is_none());
+        assert_eq!(
+            Some("group2"),
+            replayed.find_plugin("Blank.esm").unwrap().unwrap().group()
+        );
+    }
+
+    #[test]
+    fn replay_should_apply_discard_all_before_later_changes() {
+        let tmp_dir = tempdir().unwrap();
+        let userlist_path = tmp_dir.path().join("userlist.yaml");
+
+        let mut document = MetadataDocument::default();
+        document.set_bash_tags(vec!["Relev".into()]);
+        document.set_plugin_metadata(plugin("Blank.esm", "group1"));
+
+        let mut changes = UserlistChanges::default();
+        changes.discard_all();
+        changes.set_plugin("Blank.esp");
+        let mut current = MetadataDocument::default();
+        current.set_plugin_metadata(plugin("Blank.esp", "group1"));
+        append(&userlist_path, &current, &changes).unwrap();
+
+        replay(&userlist_path, &mut document).unwrap();
+
+        assert!(document.bash_tags().is_empty());
+        assert!(document.find_plugin("Blank.esm").unwrap().is_none());
+        assert!(document.find_plugin("Blank.esp").unwrap().is_some());
+    }
+
+    #[test]
+    fn replay_should_ignore_an_incomplete_entry_at_the_end_of_the_journal() {
+        let tmp_dir = tempdir().unwrap();
+        let userlist_path = tmp_dir.path().join("userlist.yaml");
+
+        let mut document = MetadataDocument::default();
+        document.set_plugin_metadata(plugin("Blank.esp", "group1"));
+        let mut changes = UserlistChanges::default();
+        changes.set_plugin("Blank.esp");
+        append(&userlist_path, &document, &changes).unwrap();
+
+        let path = journal_path(&userlist_path);
+        let mut content = std::fs::read_to_string(&path).unwrap();
+        content.push_str("---\nop: replace_plugin\nname: 'Blank.esm'\nplugins:\n  - name: 'Bl");
+        std::fs::write(&path, content).unwrap();
+
+        let mut replayed = MetadataDocument::default();
+        replay(&userlist_path, &mut replayed).unwrap();
+
+        assert!(replayed.find_plugin("Blank.esp").unwrap().is_some());
+        assert!(replayed.find_plugin("Blank.esm").unwrap().is_none());
+    }
+
+    #[test]
+    fn append_should_remove_an_incomplete_entry_before_appending() {
+        let tmp_dir = tempdir().unwrap();
+        let userlist_path = tmp_dir.path().join("userlist.yaml");
+
+        let mut document = MetadataDocument::default();
+        document.set_plugin_metadata(plugin("Blank.esp", "group1"));
+        let mut changes = UserlistChanges::default();
+        changes.set_plugin("Blank.esp");
+        append(&userlist_path, &document, &changes).unwrap();
+
+        let path = journal_path(&userlist_path);
+        let mut content = std::fs::read_to_string(&path).unwrap();
+        content.push_str("---\nop: replace_plugin\nname: 'Blank.esm'\nplugins:\n  - name: 'Bl");
+        std::fs::write(&path, content).unwrap();
+
+        let mut replayed = MetadataDocument::default();
+        replay(&userlist_path, &mut replayed).unwrap();
+
+        replayed.set_plugin_metadata(plugin("Blank.esm", "group2"));
+        let mut changes = UserlistChanges::default();
+        changes.set_plugin("Blank.esm");
+        append(&userlist_path, &replayed, &changes).unwrap();
+
+        let mut replayed_again = MetadataDocument::default();
+        replay(&userlist_path, &mut replayed_again).unwrap();
+
+        assert_eq!(replayed, replayed_again);
+        assert!(replayed_again.find_plugin("Blank.esp").unwrap().is_some());
+        assert_eq!(
+            Some("group2"),
+            replayed_again
+                .find_plugin("Blank.esm")
+                .unwrap()
+                .unwrap()
+                .group()
+        );
+    }
+
+    #[test]
+    fn replay_should_ignore_and_remove_a_journal_written_for_different_userlist_content() {
+        let tmp_dir = tempdir().unwrap();
+        let userlist_path = tmp_dir.path().join("userlist.yaml");
+        std::fs::write(&userlist_path, "bash_tags: [Relev]").unwrap();
+
+        let mut document = MetadataDocument::default();
+        document.set_plugin_metadata(plugin("Blank.esp", "group1"));
+        let mut changes = UserlistChanges::default();
+        changes.set_plugin("Blank.esp");
+        append(&userlist_path, &document, &changes).unwrap();
+
+        std::fs::write(&userlist_path, "bash_tags: [Delev]").unwrap();
+
+        let mut replayed = MetadataDocument::default();
+        replay(&userlist_path, &mut replayed).unwrap();
+
+        assert!(replayed.find_plugin("Blank.esp").unwrap().is_none());
+        assert!(!journal_path(&userlist_path).exists());
+    }
+
+    #[test]
+    fn replay_should_error_if_an_entry_has_an_unknown_operation() {
+        let tmp_dir = tempdir().unwrap();
+        let userlist_path = tmp_dir.path().join("userlist.yaml");
+
+        let mut content = header(ContentHash::new(&[]));
+        content.push_str("---\nop: unknown\n...\n");
+        std::fs::write(journal_path(&userlist_path), content).unwrap();
+
+        let mut document = MetadataDocument::default();
+        assert!(replay(&userlist_path, &mut document).is_err());
+    }
+
+    #[test]
+    fn changes_should_be_empty_by_default() {
+        assert!(UserlistChanges::default().is_empty());
+
+        let mut changes = UserlistChanges::default();
+        changes.set_plugin("Blank.esp");
+        assert!(!changes.is_empty());
+    }
+
+    #[test]
+    fn should_compact_should_be_true_once_the_journal_is_as_large_as_the_userlist() {
+        let tmp_dir = tempdir().unwrap();
+        let userlist_path = tmp_dir.path().join("userlist.yaml");
+
+        std::fs::write(&userlist_path, "{}").unwrap();
+
+        assert!(!should_compact(&userlist_path, MIN_COMPACTION_SIZE - 1));
+        assert!(should_compact(&userlist_path, MIN_COMPACTION_SIZE));
+
+        std::fs::write(&userlist_path, vec![b' '; 100_000]).unwrap();
+
+        assert!(!should_compact(&userlist_path, 99_999));
+        assert!(should_compact(&userlist_path, 100_000));
+    }
+
+    #[test]
+    fn should_compact_should_be_true_if_the_userlist_does_not_exist() {
+        let tmp_dir = tempdir().unwrap();
+        let userlist_path = tmp_dir.path().join("userlist.yaml");
+
+        assert!(should_compact(&userlist_path, 0));
+    }
+
+    #[test]
+    fn remove_should_succeed_if_there_is_no_journal() {
+        let tmp_dir = tempdir().unwrap();
+        let userlist_path = tmp_dir.path().join("userlist.yaml");
+
+        remove(&userlist_path).unwrap();
+    }
+}
@@ -0,0 +1,137 @@
+use std::{
+    collections::HashMap,
+    path::{Path, PathBuf},
+    sync::{Arc, LazyLock, Mutex, Weak},
+};
+
+use crate::logging;
+
+use super::{compiled_metadata::SourceHashes, metadata_document::MetadataDocument};
+
+/// Masterlists that have been loaded and are still in use, keyed by their
+/// path and the hashes of their content, so that loading the same masterlist
+/// again (e.g. for another game handle) shares the metadata that's already
+/// loaded instead of holding another copy of it.
+///
+/// Only weak references are held, so a masterlist is freed once nothing else
+/// is using it.
+static LOADED_MASTERLISTS: LazyLock<Mutex<HashMap<MasterlistKey, Weak<MetadataDocument>>>> =
+    LazyLock::new(Mutex::default);
+
+#[derive(Clone, Debug, Eq, PartialEq, Hash)]
+struct MasterlistKey {
+    path: PathBuf,
+    hashes: SourceHashes,
+}
+
+impl MasterlistKey {
+    fn new(path: &Path, hashes: SourceHashes) -> Self {
+        // Canonicalise the path so that different paths to the same file share
+        // an entry, falling back to the given path if that fails.
+        let path = std::fs::canonicalize(path).unwrap_or_else(|_e| path.to_path_buf());
+
+        Self { path, hashes }
+    }
+}
+
+/// Get the masterlist that was loaded from the given path and content, if it's
+/// still in use, or otherwise load it using the given function and record it
+/// so that it can be shared.
+pub(super) fn get_or_load<E, F>(
+    path: &Path,
+    hashes: SourceHashes,
+    load: F,
+) -> Result<Arc<MetadataDocument>, E>
+where
+    F: FnOnce() -> Result<MetadataDocument, E>,
+{
+    let key = MasterlistKey::new(path, hashes);
+
+    if let Some(document) = get(&key) {
+        logging::trace!("Sharing an already-loaded masterlist");
+        return Ok(document);
+    }
+
+    let document = Arc::new(load()?);
+
+    // If the lock is poisoned, fall back to not sharing the masterlist.
+    if let Ok(mut masterlists) = LOADED_MASTERLISTS.lock() {
+        masterlists.retain(|_, d| d.strong_count() > 0);
+        masterlists.insert(key, Arc::downgrade(&document));
+    }
+
+    Ok(document)
+}
+
+fn get(key: &MasterlistKey) -> Option<Arc<MetadataDocument>> {
+    LOADED_MASTERLISTS
+        .lock()
+        .ok()
+        .and_then(|masterlists| masterlists.get(key).and_then(Weak::upgrade))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn load_document(bash_tag: &str) -> Result<MetadataDocument, ()> {
+        let mut document = MetadataDocument::default();
+        document.set_bash_tags(vec![bash_tag.to_owned()]);
+        Ok(document)
+    }
+
+    #[test]
+    fn get_or_load_should_share_a_masterlist_that_is_still_in_use() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let path = tmp_dir.path().join("masterlist.yaml");
+        let hashes = SourceHashes::new("content", None);
+
+        let first = get_or_load(&path, hashes, || load_document("first")).unwrap();
+        let second = get_or_load(&path, hashes, || load_document("second")).unwrap();
+
+        assert!(Arc::ptr_eq(&first, &second));
+        assert_eq!(&["first"], second.bash_tags());
+    }
+
+    #[test]
+    fn get_or_load_should_load_a_masterlist_if_its_content_is_different() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let path = tmp_dir.path().join("masterlist.yaml");
+
+        let first = get_or_load(&path, SourceHashes::new("content", None), || {
+            load_document("first")
+        })
+        .unwrap();
+        let second = get_or_load(&path, SourceHashes::new("changed", None), || {
+            load_document("second")
+        })
+        .unwrap();
+
+        assert!(!Arc::ptr_eq(&first, &second));
+        assert_eq!(&["second"], second.bash_tags());
+    }
+
+    #[test]
+    fn get_or_load_should_load_a_masterlist_if_it_is_no_longer_in_use() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let path = tmp_dir.path().join("masterlist.yaml");
+        let hashes = SourceHashes::new("content", None);
+
+        drop(get_or_load(&path, hashes, || load_document("first")).unwrap());
+        let second = get_or_load(&path, hashes, || load_document("second")).unwrap();
+
+        assert_eq!(&["second"], second.bash_tags());
+    }
+
+    #[test]
+    fn get_or_load_should_not_record_a_masterlist_that_failed_to_load() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let path = tmp_dir.path().join("masterlist.yaml");
+        let hashes = SourceHashes::new("content", None);
+
+        assert!(get_or_load(&path, hashes, || Err::<MetadataDocument, _>(())).is_err());
+        let document = get_or_load(&path, hashes, || load_document("loaded")).unwrap();
+
+        assert_eq!(&["loaded"], document.bash_tags());
+    }
+}
@@ -0,0 +1,124 @@
+use std::sync::Arc;
+
+use super::message::{MessageContent, select_message_content};
+
+/// Discards the localised content in metadata that isn't for a given
+/// language, so that callers that only display one language don't need to
+/// receive (and copy) every translation.
+pub(crate) trait SelectLanguage {
+    /// Replace any localised content with only the content that
+    /// [`select_message_content`] chooses for the given language.
+    fn select_language(&mut self, language: &str);
+
+    /// Check if there is any localised content in more than one language.
+    fn is_multilingual(&self) -> bool;
+}
+
+impl SelectLanguage for Box<[MessageContent]> {
+    fn select_language(&mut self, language: &str) {
+        if self.is_multilingual() {
+            *self = select_message_content(self, language)
+                .cloned()
+                .into_iter()
+                .collect();
+        }
+    }
+
+    fn is_multilingual(&self) -> bool {
+        self.len() > 1
+    }
+}
+
+impl<T: SelectLanguage> SelectLanguage for [T] {
+    fn select_language(&mut self, language: &str) {
+        for value in self {
+            value.select_language(language);
+        }
+    }
+
+    fn is_multilingual(&self) -> bool {
+        self.iter().any(T::is_multilingual)
+    }
+}
+
+impl<T: Clone + SelectLanguage> SelectLanguage for Arc<[T]> {
+    fn select_language(&mut self, language: &str) {
+        // Values are usually shared with the loaded metadata, so avoid copying
+        // them unless some of their content will be discarded.
+        if !self.is_multilingual() {
+            return;
+        }
+
+        if let Some(values) = Arc::get_mut(self) {
+            values.select_language(language);
+        } else {
+            *self = self
+                .iter()
+                .map(|value| {
+                    let mut value = value.clone();
+                    value.select_language(language);
+                    value
+                })
+                .collect();
+        }
+    }
+
+    fn is_multilingual(&self) -> bool {
+        self.iter().any(T::is_multilingual)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn multilingual_content() -> Box<[MessageContent]> {
+        Box::new([
+            MessageContent::new("english".into()),
+            MessageContent::new("french".into()).with_language("fr".into()),
+        ])
+    }
+
+    #[test]
+    fn select_language_should_keep_only_the_selected_content() {
+        let mut content = multilingual_content();
+
+        content.select_language("fr_FR");
+
+        assert_eq!(
+            [MessageContent::new("french".into()).with_language("fr".into())],
+            *content
+        );
+    }
+
+    #[test]
+    fn select_language_should_fall_back_to_the_default_language() {
+        let mut content = multilingual_content();
+
+        content.select_language("de");
+
+        assert_eq!([MessageContent::new("english".into())], *content);
+    }
+
+    #[test]
+    fn select_language_should_not_copy_shared_values_that_have_one_language() {
+        let mut values: Arc<[Box<[MessageContent]>]> =
+            vec![Box::from([MessageContent::new("english".into())])].into();
+        let shared = Arc::clone(&values);
+
+        values.select_language("fr");
+
+        assert!(Arc::ptr_eq(&shared, &values));
+    }
+
+    #[test]
+    fn select_language_should_copy_shared_values_that_have_many_languages() {
+        let mut values: Arc<[Box<[MessageContent]>]> = vec![multilingual_content()].into();
+        let shared = Arc::clone(&values);
+
+        values.select_language("fr");
+
+        assert_eq!(2, shared.first().unwrap().len());
+        assert_eq!(1, values.first().unwrap().len());
+    }
+}
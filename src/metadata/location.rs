@@ -1,15 +1,19 @@
+use std::sync::Arc;
+
 use saphyr::{MarkedYaml, Scalar, YamlData};
 
 use super::{
+    binary::{BinaryDecoder, BinaryEncoder, DecodeBinary, DecodeError, EncodeBinary},
     error::{ExpectedType, ParseMetadataError},
+    interner::{InternStrings, StringInterner},
     yaml::{EmitYaml, TryFromYaml, YamlEmitter, YamlObjectType, get_required_string_value},
 };
 
 /// Represents a URL at which the parent plugin can be found.
 #[derive(Clone, Debug, Default, Eq, PartialEq, Ord, PartialOrd, Hash)]
 pub struct Location {
-    url: Box<str>,
-    name: Option<Box<str>>,
+    url: Arc<str>,
+    name: Option<Arc<str>>,
 }
 
 impl Location {
@@ -17,7 +21,7 @@ impl Location {
     #[must_use]
     pub fn new(url: String) -> Self {
         Location {
-            url: url.into_boxed_str(),
+            url: url.into(),
             name: None,
         }
     }
@@ -25,7 +29,7 @@ impl Location {
     /// Set a name for the URL, eg. the page or site name.
     #[must_use]
     pub fn with_name(mut self, name: String) -> Self {
-        self.name = Some(name.into_boxed_str());
+        self.name = Some(name.into());
         self
     }
 
@@ -44,7 +48,7 @@ impl TryFromYaml for Location {
     fn try_from_yaml(value: &MarkedYaml) -> Result<Self, ParseMetadataError> {
         match &value.data {
             YamlData::Value(Scalar::String(s)) => Ok(Location {
-                url: s.to_string().into_boxed_str(),
+                url: s.as_ref().into(),
                 name: None,
             }),
             YamlData::Mapping(h) => {
@@ -97,6 +101,29 @@ impl EmitYaml for Location {
     }
 }
 
+impl EncodeBinary for Location {
+    fn encode_binary(&self, encoder: &mut BinaryEncoder) {
+        encoder.write_str(&self.url);
+        encoder.write_option_str(self.name.as_deref());
+    }
+}
+
+impl DecodeBinary for Location {
+    fn decode_binary(decoder: &mut BinaryDecoder<'_>) -> Result<Self, DecodeError> {
+        Ok(Self {
+            url: decoder.read_shared_str()?,
+            name: decoder.read_option_shared_str()?,
+        })
+    }
+}
+
+impl InternStrings for Location {
+    fn intern_strings(&mut self, interner: &mut StringInterner) {
+        self.url.intern_strings(interner);
+        self.name.intern_strings(interner);
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -1,14 +1,18 @@
-use std::collections::BTreeSet;
+use std::{collections::BTreeSet, sync::Arc};
 
 use saphyr::{MarkedYaml, Scalar, YamlData};
 
 use crate::metadata::yaml::YamlAnchors;
 
 use super::{
+    binary::{BinaryDecoder, BinaryEncoder, DecodeBinary, DecodeError, EncodeBinary},
+    condition::Condition,
     error::{
         ExpectedType, MetadataParsingErrorReason, MultilingualMessageContentsError,
         ParseMetadataError,
     },
+    interner::{InternStrings, StringInterner},
+    localise::SelectLanguage,
     yaml::{
         EmitYaml, TryFromYaml, YamlEmitter, YamlObjectType, as_mapping, get_required_string_value,
         get_strings_vec_value, get_value, parse_condition,
@@ -46,8 +50,8 @@ impl std::fmt::Display for MessageType {
 /// Represents a message's localised text content.
 #[derive(Clone, Debug, Eq, PartialEq, Ord, PartialOrd, Hash)]
 pub struct MessageContent {
-    text: Box<str>,
-    language: Box<str>,
+    text: Arc<str>,
+    language: Arc<str>,
 }
 
 impl MessageContent {
@@ -58,7 +62,7 @@ impl MessageContent {
     #[must_use]
     pub fn new(text: String) -> Self {
         MessageContent {
-            text: text.into_boxed_str(),
+            text: text.into(),
             language: MessageContent::DEFAULT_LANGUAGE.into(),
         }
     }
@@ -66,7 +70,7 @@ impl MessageContent {
     /// Set the language to the given value.
     #[must_use]
     pub fn with_language(mut self, language: String) -> Self {
-        self.language = language.into_boxed_str();
+        self.language = language.into();
         self
     }
 
@@ -85,7 +89,7 @@ impl std::default::Default for MessageContent {
     /// Create a value with an empty message string and the default language.
     fn default() -> Self {
         Self {
-            text: Box::default(),
+            text: Arc::default(),
             language: MessageContent::DEFAULT_LANGUAGE.into(),
         }
     }
@@ -159,7 +163,7 @@ pub fn select_message_content<'a>(
 pub struct Message {
     level: MessageType,
     content: Box<[MessageContent]>,
-    condition: Option<Box<str>>,
+    condition: Option<Condition>,
 }
 
 impl Message {
@@ -193,7 +197,7 @@ impl Message {
     /// Set the condition string.
     #[must_use]
     pub fn with_condition(mut self, condition: String) -> Self {
-        self.condition = Some(condition.into_boxed_str());
+        self.condition = Some(Condition::new(condition));
         self
     }
 
@@ -209,7 +213,11 @@ impl Message {
 
     /// Get the condition string.
     pub fn condition(&self) -> Option<&str> {
-        self.condition.as_deref()
+        self.condition.as_ref().map(Condition::as_str)
+    }
+
+    pub(crate) fn parsed_condition(&self) -> Option<&Condition> {
+        self.condition.as_ref()
     }
 }
 
@@ -319,7 +327,7 @@ impl TryFromYaml for Message {
     }
 }
 
-fn format(text: &str, subs: &[&str]) -> Result<Box<str>, MetadataParsingErrorReason> {
+fn format(text: &str, subs: &[&str]) -> Result<Arc<str>, MetadataParsingErrorReason> {
     let mut unused_sub_indexes = BTreeSet::new();
     for i in 0..subs.len() {
         unused_sub_indexes.insert(i);
@@ -384,7 +392,7 @@ fn format(text: &str, subs: &[&str]) -> Result<Box<str>, MetadataParsingErrorRea
             *sub_index,
         ))
     } else {
-        Ok(new_text.into_boxed_str())
+        Ok(new_text.into())
     }
 }
 
@@ -436,7 +444,7 @@ impl EmitYaml for &Message {
 
                 if let Some(condition) = &self.condition {
                     e.write_map_key("condition");
-                    e.write_condition(condition);
+                    e.write_condition(condition.as_str());
                 }
 
                 e.end_map();
@@ -459,6 +467,75 @@ impl EmitYaml for Message {
     }
 }
 
+impl EncodeBinary for MessageContent {
+    fn encode_binary(&self, encoder: &mut BinaryEncoder) {
+        encoder.write_str(&self.text);
+        encoder.write_str(&self.language);
+    }
+}
+
+impl DecodeBinary for MessageContent {
+    fn decode_binary(decoder: &mut BinaryDecoder<'_>) -> Result<Self, DecodeError> {
+        Ok(Self {
+            text: decoder.read_shared_str()?,
+            language: decoder.read_shared_str()?,
+        })
+    }
+}
+
+impl EncodeBinary for Message {
+    fn encode_binary(&self, encoder: &mut BinaryEncoder) {
+        encoder.write_u8(match self.level {
+            MessageType::Say => 0,
+            MessageType::Warn => 1,
+            MessageType::Error => 2,
+        });
+        encoder.write_slice(&self.content);
+        encoder.write_condition(self.condition.as_ref());
+    }
+}
+
+impl DecodeBinary for Message {
+    fn decode_binary(decoder: &mut BinaryDecoder<'_>) -> Result<Self, DecodeError> {
+        let level = match decoder.read_u8()? {
+            0 => MessageType::Say,
+            1 => MessageType::Warn,
+            2 => MessageType::Error,
+            _ => return Err(DecodeError::InvalidValue),
+        };
+
+        Ok(Self {
+            level,
+            content: decoder.read_vec()?.into_boxed_slice(),
+            condition: decoder.read_condition()?,
+        })
+    }
+}
+
+impl InternStrings for MessageContent {
+    fn intern_strings(&mut self, interner: &mut StringInterner) {
+        self.text.intern_strings(interner);
+        self.language.intern_strings(interner);
+    }
+}
+
+impl InternStrings for Message {
+    fn intern_strings(&mut self, interner: &mut StringInterner) {
+        self.content.intern_strings(interner);
+        self.condition.intern_strings(interner);
+    }
+}
+
+impl SelectLanguage for Message {
+    fn select_language(&mut self, language: &str) {
+        self.content.select_language(language);
+    }
+
+    fn is_multilingual(&self) -> bool {
+        self.content.is_multilingual()
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use crate::metadata::emit;
@@ -1,9 +1,10 @@
 use std::{
     collections::{HashMap, HashSet},
-    path::Path,
+    path::{Path, PathBuf},
     sync::Arc,
 };
 
+use rayon::iter::{IntoParallelRefIterator, ParallelIterator};
 use saphyr::{LoadableYamlNode, MarkedYaml, YamlData};
 
 use crate::{
@@ -15,14 +16,21 @@ use crate::{
 };
 
 use super::{
+    binary::{BinaryDecoder, BinaryEncoder, DecodeBinary, DecodeError, EncodeBinary},
+    compiled_metadata::{self, SourceHashes},
     error::{
         ExpectedType, LoadMetadataError, MetadataDocumentParsingError, ParseMetadataError,
         RegexError, WriteMetadataError,
     },
     file::Filename,
     group::Group,
+    interner::{InternStrings, StringInterner},
+    journal, loaded_masterlists,
     message::Message,
+    plugin_entry::PluginEntry,
     plugin_metadata::PluginMetadata,
+    regex_plugins::RegexPlugins,
+    reverse_index::{LazyReverseIndex, ReverseIndex},
     yaml::{
         EmitYaml, TryFromYaml, YamlEmitter, YamlObjectType, get_slice_value, process_merge_keys,
     },
@@ -130,37 +138,217 @@ impl MetadataWriteOptions {
     }
 }
 
+/// Metadata that has been loaded from a masterlist or userlist, but that
+/// hasn't yet been given to a [`Database`](crate::Database).
+///
+/// Loading metadata doesn't need access to a database, so it can be done
+/// without blocking other users of the database, and then the loaded metadata
+/// can be given to the database using
+/// [`Database::set_masterlist`](crate::Database::set_masterlist) or
+/// [`Database::set_userlist`](crate::Database::set_userlist).
+///
+/// The loaded metadata is reference-counted, so cloning a value and giving
+/// the clones to multiple databases shares the metadata between them.
+#[derive(Clone, Debug)]
+pub struct LoadedMetadata {
+    document: Arc<MetadataDocument>,
+    path: PathBuf,
+}
+
+impl LoadedMetadata {
+    /// Loads metadata from the given path.
+    ///
+    /// Unlike [`LoadedMetadata::load_masterlist`], this always parses the
+    /// file's YAML, so it's suitable for loading userlists. If the file has a
+    /// journal of changes that were written using
+    /// [`Database::write_user_metadata_changes`](crate::Database::write_user_metadata_changes),
+    /// those changes are applied after the file is loaded.
+    pub fn load(path: &Path) -> Result<Self, LoadMetadataError> {
+        let mut document = MetadataDocument::default();
+        document.load(path)?;
+        journal::replay(path, &mut document)?;
+        Ok(Self::new(Arc::new(document), path))
+    }
+
+    /// Loads metadata from the given masterlist path.
+    ///
+    /// Masterlists are large, so after a masterlist's YAML has been parsed a
+    /// compiled copy of its metadata is written alongside it, with `.bin`
+    /// appended to its filename. If the compiled copy exists and was written
+    /// from the same masterlist content by the same version of libloot, it's
+    /// loaded instead of parsing the YAML again.
+    ///
+    /// If a masterlist with the same content has already been loaded from the
+    /// same path and is still in use (e.g. by another
+    /// [`Database`](crate::Database)), its metadata is shared instead of being
+    /// loaded again.
+    ///
+    /// When metadata is loaded from a compiled copy, the metadata for each
+    /// specific (i.e. non-regex) plugin entry is only decoded when it's first
+    /// needed. Use [`LoadedMetadata::validate`] to decode all of it upfront.
+    pub fn load_masterlist(path: &Path) -> Result<Self, LoadMetadataError> {
+        let document = MetadataDocument::load_masterlist(path)?;
+        Ok(Self::new(document, path))
+    }
+
+    /// Loads metadata from the given masterlist path, using the prelude at the
+    /// given path.
+    ///
+    /// Like [`LoadedMetadata::load_masterlist`], this shares a masterlist
+    /// that's already loaded or uses a compiled copy of the metadata if either
+    /// has the same masterlist and prelude content.
+    pub fn load_masterlist_with_prelude(
+        masterlist_path: &Path,
+        prelude_path: &Path,
+    ) -> Result<Self, LoadMetadataError> {
+        let document =
+            MetadataDocument::load_masterlist_with_prelude(masterlist_path, prelude_path)?;
+        Ok(Self::new(document, masterlist_path))
+    }
+
+    /// Decodes any plugin metadata that hasn't yet been decoded from compiled
+    /// metadata, returning an error if any of it is invalid.
+    ///
+    /// Invalid plugin metadata that is decoded when it's first needed is
+    /// logged and otherwise treated as if the plugin has no metadata.
+    pub fn validate(&self) -> Result<(), LoadMetadataError> {
+        self.document.validate().map_err(|e| {
+            LoadMetadataError::new(
+                self.path.clone(),
+                MetadataDocumentParsingError::CompiledMetadataError(e),
+            )
+        })
+    }
+
+    /// Loads metadata from the given masterlist path to replace the given
+    /// previously-loaded masterlist, and returns the differences between them.
+    ///
+    /// This is the same as
+    /// [`Database::reload_masterlist`](crate::Database::reload_masterlist),
+    /// but doesn't need access to a database, so it can be done without
+    /// blocking other users of the database: get the previously-loaded
+    /// masterlist using
+    /// [`Database::loaded_masterlist`](crate::Database::loaded_masterlist),
+    /// and then give the result to the database using
+    /// [`Database::replace_masterlist`](crate::Database::replace_masterlist).
+    pub fn reload_masterlist(
+        path: &Path,
+        previous: &LoadedMetadata,
+    ) -> Result<(Self, MetadataChanges), LoadMetadataError> {
+        let (document, changes) = MetadataDocument::reload_masterlist(path, &previous.document)?;
+        Ok((Self::new(document, path), changes))
+    }
+
+    /// Loads metadata from the given masterlist path, using the prelude at the
+    /// given path, to replace the given previously-loaded masterlist, and
+    /// returns the differences between them.
+    ///
+    /// See [`LoadedMetadata::reload_masterlist`] for details.
+    pub fn reload_masterlist_with_prelude(
+        masterlist_path: &Path,
+        prelude_path: &Path,
+        previous: &LoadedMetadata,
+    ) -> Result<(Self, MetadataChanges), LoadMetadataError> {
+        let (document, changes) = MetadataDocument::reload_masterlist_with_prelude(
+            masterlist_path,
+            prelude_path,
+            &previous.document,
+        )?;
+        Ok((Self::new(document, masterlist_path), changes))
+    }
+
+    pub(crate) fn new(document: Arc<MetadataDocument>, path: &Path) -> Self {
+        Self {
+            document,
+            path: path.to_path_buf(),
+        }
+    }
+
+    pub(crate) fn into_document(self) -> Arc<MetadataDocument> {
+        self.document
+    }
+
+    pub(crate) fn into_parts(self) -> (Arc<MetadataDocument>, PathBuf) {
+        (self.document, self.path)
+    }
+
+    pub(crate) fn is_document(&self, document: &Arc<MetadataDocument>) -> bool {
+        Arc::ptr_eq(&self.document, document)
+    }
+}
+
+/// The differences between a newly-loaded masterlist and the masterlist that
+/// it replaced, as returned by
+/// [`Database::reload_masterlist`](crate::Database::reload_masterlist).
+#[derive(Clone, Debug, Default, Eq, PartialEq)]
+pub struct MetadataChanges {
+    bash_tags_changed: bool,
+    groups_changed: bool,
+    messages_changed: bool,
+    changed_plugins: Vec<String>,
+}
+
+impl MetadataChanges {
+    /// Check if the known Bash Tags are different.
+    pub fn bash_tags_changed(&self) -> bool {
+        self.bash_tags_changed
+    }
+
+    /// Check if the groups are different.
+    pub fn groups_changed(&self) -> bool {
+        self.groups_changed
+    }
+
+    /// Check if the general messages are different.
+    pub fn messages_changed(&self) -> bool {
+        self.messages_changed
+    }
+
+    /// Get the names of the plugin metadata entries that were added, removed
+    /// or changed. Entries with regex names are listed by their regex, so
+    /// their changes may affect any plugins that the regex matches.
+    pub fn changed_plugins(&self) -> &[String] {
+        &self.changed_plugins
+    }
+
+    /// Check if there are no differences.
+    pub fn is_empty(&self) -> bool {
+        !self.bash_tags_changed
+            && !self.groups_changed
+            && !self.messages_changed
+            && self.changed_plugins.is_empty()
+    }
+
+    fn add_changed_plugin(&mut self, name: &str) {
+        if !self
+            .changed_plugins
+            .iter()
+            .any(|n| unicase::eq(n.as_str(), name))
+        {
+            self.changed_plugins.push(name.to_owned());
+        }
+    }
+}
+
 #[derive(Clone, Debug, Eq, PartialEq)]
 pub(crate) struct MetadataDocument {
     bash_tags: Vec<String>,
     groups: Vec<Group>,
     messages: Vec<Message>,
-    plugins: HashMap<Arc<Filename>, PluginMetadata>,
-    regex_plugins: Vec<PluginMetadata>,
+    plugins: HashMap<Arc<Filename>, PluginEntry>,
+    regex_plugins: RegexPlugins,
     ordered_plugin_names: Vec<Arc<Filename>>,
+    reverse_index: LazyReverseIndex,
 }
 
 impl MetadataDocument {
     pub(crate) fn load(&mut self, file_path: &Path) -> Result<(), LoadMetadataError> {
-        if !file_path.exists() {
-            return Err(LoadMetadataError::new(
-                file_path.into(),
-                MetadataDocumentParsingError::PathNotFound,
-            ));
-        }
-
-        logging::trace!("Loading file at \"{}\"", escape_ascii(file_path));
-
-        let content = std::fs::read_to_string(file_path)
-            .map_err(|e| LoadMetadataError::from_io_error(file_path.into(), e))?;
+        let content = read_metadata_file(file_path)?;
 
         self.load_from_str(&content)
             .map_err(|e| LoadMetadataError::new(file_path.into(), e))?;
 
-        logging::trace!(
-            "Successfully loaded metadata from file at \"{}\".",
-            escape_ascii(file_path)
-        );
+        log_loaded(file_path);
 
         Ok(())
     }
@@ -170,65 +358,151 @@ impl MetadataDocument {
         masterlist_path: &Path,
         prelude_path: &Path,
     ) -> Result<(), LoadMetadataError> {
-        if !masterlist_path.exists() {
-            return Err(LoadMetadataError::new(
-                masterlist_path.into(),
-                MetadataDocumentParsingError::PathNotFound,
-            ));
-        }
+        let (masterlist, prelude) = read_masterlist_and_prelude(masterlist_path, prelude_path)?;
 
-        if !prelude_path.exists() {
-            return Err(LoadMetadataError::new(
-                prelude_path.into(),
-                MetadataDocumentParsingError::PathNotFound,
-            ));
-        }
+        self.load_from_str_with_prelude(masterlist_path, masterlist, &prelude)?;
+
+        log_loaded(masterlist_path);
+
+        Ok(())
+    }
+
+    /// Load a masterlist, sharing it if the same masterlist is already loaded,
+    /// and otherwise using its compiled metadata if it's up to date or parsing
+    /// its YAML and writing compiled metadata.
+    pub(crate) fn load_masterlist(file_path: &Path) -> Result<Arc<Self>, LoadMetadataError> {
+        let content = read_metadata_file(file_path)?;
+
+        let hashes = SourceHashes::new(&content, None);
+        let document = loaded_masterlists::get_or_load(file_path, hashes, || {
+            load_compiled_or(file_path, &hashes, |document| {
+                document
+                    .load_from_str(&content)
+                    .map_err(|e| LoadMetadataError::new(file_path.into(), e))
+            })
+        })?;
+
+        log_loaded(file_path);
+
+        Ok(document)
+    }
 
-        let masterlist = std::fs::read_to_string(masterlist_path)
-            .map_err(|e| LoadMetadataError::from_io_error(masterlist_path.into(), e))?;
+    /// Load a masterlist with a prelude, sharing it if the same masterlist and
+    /// prelude are already loaded, and otherwise using its compiled metadata if
+    /// it's up to date or parsing its YAML and writing compiled metadata.
+    pub(crate) fn load_masterlist_with_prelude(
+        masterlist_path: &Path,
+        prelude_path: &Path,
+    ) -> Result<Arc<Self>, LoadMetadataError> {
+        let (masterlist, prelude) = read_masterlist_and_prelude(masterlist_path, prelude_path)?;
 
-        let prelude = std::fs::read_to_string(prelude_path)
-            .map_err(|e| LoadMetadataError::from_io_error(masterlist_path.into(), e))?;
+        let hashes = SourceHashes::new(&masterlist, Some(&prelude));
+        let document = loaded_masterlists::get_or_load(masterlist_path, hashes, || {
+            load_compiled_or(masterlist_path, &hashes, |document| {
+                document.load_from_str_with_prelude(masterlist_path, masterlist, &prelude)
+            })
+        })?;
+
+        log_loaded(masterlist_path);
 
-        let masterlist = replace_prelude(masterlist, &prelude).map_err(|e| {
+        Ok(document)
+    }
+
+    /// Load a masterlist to replace the given previously-loaded masterlist,
+    /// reusing the previous masterlist's metadata where it hasn't changed.
+    ///
+    /// Reused metadata keeps any plugin metadata that has already been
+    /// decoded, conditions that have already been parsed and regexes that
+    /// have already been compiled.
+    pub(crate) fn reload_masterlist(
+        file_path: &Path,
+        previous: &Self,
+    ) -> Result<(Arc<Self>, MetadataChanges), LoadMetadataError> {
+        let content = read_metadata_file(file_path)?;
+
+        let hashes = SourceHashes::new(&content, None);
+        let mut changes = None;
+        let document = loaded_masterlists::get_or_load(file_path, hashes, || {
+            let mut document = load_compiled_or(file_path, &hashes, |document| {
+                document
+                    .load_from_str(&content)
+                    .map_err(|e| LoadMetadataError::new(file_path.into(), e))
+            })?;
+            changes = Some(document.reuse_unchanged(previous));
+            Ok(document)
+        })?;
+
+        log_loaded(file_path);
+
+        let changes = changes.unwrap_or_else(|| document.changes_from(previous));
+
+        Ok((document, changes))
+    }
+
+    /// Load a masterlist with a prelude to replace the given previously-loaded
+    /// masterlist, reusing the previous masterlist's metadata where it hasn't
+    /// changed.
+    pub(crate) fn reload_masterlist_with_prelude(
+        masterlist_path: &Path,
+        prelude_path: &Path,
+        previous: &Self,
+    ) -> Result<(Arc<Self>, MetadataChanges), LoadMetadataError> {
+        let (masterlist, prelude) = read_masterlist_and_prelude(masterlist_path, prelude_path)?;
+
+        let hashes = SourceHashes::new(&masterlist, Some(&prelude));
+        let mut changes = None;
+        let document = loaded_masterlists::get_or_load(masterlist_path, hashes, || {
+            let mut document = load_compiled_or(masterlist_path, &hashes, |document| {
+                document.load_from_str_with_prelude(masterlist_path, masterlist, &prelude)
+            })?;
+            changes = Some(document.reuse_unchanged(previous));
+            Ok(document)
+        })?;
+
+        log_loaded(masterlist_path);
+
+        let changes = changes.unwrap_or_else(|| document.changes_from(previous));
+
+        Ok((document, changes))
+    }
+
+    fn load_from_str_with_prelude(
+        &mut self,
+        masterlist_path: &Path,
+        masterlist: String,
+        prelude: &str,
+    ) -> Result<(), LoadMetadataError> {
+        let masterlist = replace_prelude(masterlist, prelude).map_err(|e| {
             LoadMetadataError::new(
                 masterlist_path.into(),
                 MetadataDocumentParsingError::MetadataParsingError(e),
             )
         })?;
 
-        self.load_from_str(&masterlist.masterlist)
-            .map_err(|mut e| {
-                match &mut e {
-                    MetadataDocumentParsingError::MetadataParsingError(err) => {
-                        if let Some(meta) = masterlist.meta {
-                            err.adjust_location(&meta);
-                        }
-                    }
-                    MetadataDocumentParsingError::YamlMergeKeyError(err) => {
-                        if let Some(meta) = masterlist.meta {
-                            err.adjust_location(&meta);
-                        }
+        self.load_from_str(&masterlist.masterlist).map_err(|mut e| {
+            match &mut e {
+                MetadataDocumentParsingError::MetadataParsingError(err) => {
+                    if let Some(meta) = masterlist.meta {
+                        err.adjust_location(&meta);
                     }
-                    _ => {
-                        // No location to adjust.
+                }
+                MetadataDocumentParsingError::YamlMergeKeyError(err) => {
+                    if let Some(meta) = masterlist.meta {
+                        err.adjust_location(&meta);
                     }
                 }
-                LoadMetadataError::new(masterlist_path.into(), e)
-            })?;
-
-        logging::trace!(
-            "Successfully loaded metadata from file at \"{}\".",
-            escape_ascii(masterlist_path)
-        );
-
-        Ok(())
+                _ => {
+                    // No location to adjust.
+                }
+            }
+            LoadMetadataError::new(masterlist_path.into(), e)
+        })
     }
 
     fn load_from_str(&mut self, string: &str) -> Result<(), MetadataDocumentParsingError> {
         let mut docs = MarkedYaml::load_from_str(string)?;
 
-        let doc = docs
+        let mut doc = docs
             .pop()
             .ok_or_else(|| MetadataDocumentParsingError::NoDocuments)?;
 
@@ -238,7 +512,7 @@ impl MetadataDocument {
             ));
         }
 
-        let doc = process_merge_keys(doc)?;
+        process_merge_keys(&mut doc)?;
 
         let YamlData::Mapping(doc) = doc.data else {
             return Err(ParseMetadataError::unexpected_type(
@@ -249,16 +523,32 @@ impl MetadataDocument {
             .into());
         };
 
+        // Converting plugin entries includes compiling their regexes, and the
+        // entries are independent, so they're converted in parallel. The
+        // results are then checked in order so that the first error in the
+        // document is the one that's returned.
+        let plugin_yamls = get_slice_value(&doc, "plugins", YamlObjectType::MetadataDocument)?;
+        let converted_plugins: Vec<_> = plugin_yamls
+            .par_iter()
+            .map(PluginMetadata::try_from_yaml)
+            .collect();
+
         let mut plugins = HashMap::new();
-        let mut regex_plugins = Vec::new();
-        let mut ordered_plugin_names = Vec::new();
-        for plugin_yaml in get_slice_value(&doc, "plugins", YamlObjectType::MetadataDocument)? {
-            let plugin = PluginMetadata::try_from_yaml(plugin_yaml)?;
+        let mut regex_plugins = RegexPlugins::default();
+        let mut ordered_plugin_names = Vec::with_capacity(plugin_yamls.len());
+        // Plugin entries are converted independently, so their strings are
+        // deduplicated afterwards.
+        let mut interner = StringInterner::default();
+        for (plugin_yaml, plugin) in plugin_yamls.iter().zip(converted_plugins) {
+            let mut plugin = plugin?;
+            plugin.intern_strings(&mut interner);
             let filename = Arc::new(Filename::new(plugin.name().to_owned()));
 
             if plugin.is_regex_plugin() {
                 regex_plugins.push(plugin);
-            } else if let Some(old) = plugins.insert(Arc::clone(&filename), plugin) {
+            } else if let Some(old) =
+                plugins.insert(Arc::clone(&filename), PluginEntry::new(plugin))
+            {
                 return Err(ParseMetadataError::duplicate_entry(
                     plugin_yaml.span.start,
                     old.name().to_owned(),
@@ -270,10 +560,11 @@ impl MetadataDocument {
             ordered_plugin_names.push(filename);
         }
 
-        let messages = get_slice_value(&doc, "globals", YamlObjectType::MetadataDocument)?
+        let mut messages = get_slice_value(&doc, "globals", YamlObjectType::MetadataDocument)?
             .iter()
             .map(Message::try_from_yaml)
             .collect::<Result<Vec<_>, _>>()?;
+        messages.intern_strings(&mut interner);
 
         let mut bash_tags = Vec::new();
         for bash_tag_yaml in get_slice_value(&doc, "bash_tags", YamlObjectType::MetadataDocument)? {
@@ -318,6 +609,7 @@ impl MetadataDocument {
         self.plugins = plugins;
         self.regex_plugins = regex_plugins;
         self.ordered_plugin_names = ordered_plugin_names;
+        self.reverse_index.reset();
         self.messages = messages;
         self.bash_tags = bash_tags;
         self.groups = groups;
@@ -410,7 +702,7 @@ impl MetadataDocument {
 
     pub(crate) fn ordered_plugins_iter(&self) -> impl Iterator<Item = &PluginMetadata> {
         self.ordered_plugin_names.iter().filter_map(|f| {
-            self.plugins.get(f).or_else(|| {
+            self.plugins.get(f).map(PluginEntry::get).or_else(|| {
                 self.regex_plugins
                     .iter()
                     .find(|r| r.name() == f.as_ref().as_str())
@@ -423,15 +715,13 @@ impl MetadataDocument {
         plugin_name: &str,
     ) -> Result<Option<PluginMetadata>, RegexError> {
         let mut metadata = match self.plugins.get(&Filename::new(plugin_name.to_owned())) {
-            Some(m) => m.clone(),
+            Some(m) => m.get().clone(),
             None => PluginMetadata::new(plugin_name)?,
         };
 
         // Now we want to also match possibly multiple regex entries.
-        for regex_plugin in &self.regex_plugins {
-            if regex_plugin.name_matches(plugin_name) {
-                metadata.merge_metadata(regex_plugin);
-            }
+        for regex_plugin in self.regex_plugins.matching(plugin_name) {
+            metadata.merge_metadata(regex_plugin);
         }
 
         if metadata.has_name_only() {
@@ -468,12 +758,72 @@ impl MetadataDocument {
         if plugin_metadata.is_regex_plugin() {
             self.regex_plugins.push(plugin_metadata);
             self.ordered_plugin_names.push(filename);
+            self.reverse_index.reset();
         } else {
-            let old_value = self.plugins.insert(Arc::clone(&filename), plugin_metadata);
-            if old_value.is_none() {
-                self.ordered_plugin_names.push(filename);
-            }
+            self.insert_plugin_entry(filename, PluginEntry::new(plugin_metadata));
+        }
+    }
+
+    /// Get the names of the plugin metadata entries that reference the given
+    /// file in their load after, requirement or incompatibility metadata,
+    /// ignoring conditions.
+    pub(crate) fn plugins_referencing(&self, filename: &str) -> &[Arc<str>] {
+        self.reverse_index().referencing_entries(filename)
+    }
+
+    /// Get the names of the plugin metadata entries that are in the given
+    /// group.
+    pub(crate) fn plugins_in_group(&self, group_name: &str) -> &[Arc<str>] {
+        self.reverse_index().group_members(group_name)
+    }
+
+    /// Get the group of the plugin metadata entry with the given name, which
+    /// is compared case-insensitively and not treated as a regex.
+    pub(crate) fn plugin_entry_group(&self, plugin_name: &str) -> Option<&str> {
+        self.reverse_index().entry_group(plugin_name)
+    }
+
+    /// The index is built from all the plugin entries when it's first used,
+    /// which decodes any that were loaded from compiled metadata.
+    fn reverse_index(&self) -> &ReverseIndex {
+        self.reverse_index.get_or_build(|| {
+            self.ordered_plugin_names
+                .iter()
+                .filter_map(|f| self.plugins.get(f).map(PluginEntry::get))
+                .chain(self.regex_plugins.iter())
+        })
+    }
+
+    /// Get the plugin metadata entries that have the given name, which is
+    /// compared case-insensitively and not treated as a regex.
+    pub(crate) fn plugin_entries_named(&self, plugin_name: &str) -> Vec<PluginMetadata> {
+        let filename = Filename::new(plugin_name.to_owned());
+        if let Some(entry) = self.plugins.get(&filename) {
+            return vec![entry.get().clone()];
+        }
+
+        self.regex_plugins
+            .iter()
+            .filter(|p| unicase::eq(p.name(), plugin_name))
+            .cloned()
+            .collect()
+    }
+
+    fn insert_plugin_entry(&mut self, filename: Arc<Filename>, entry: PluginEntry) {
+        let old_value = self.plugins.insert(Arc::clone(&filename), entry);
+        if old_value.is_none() {
+            self.ordered_plugin_names.push(filename);
         }
+        self.reverse_index.reset();
+    }
+
+    /// Decode any plugin metadata that was loaded from compiled metadata and
+    /// hasn't yet been decoded, returning an error if any of it is invalid.
+    pub(crate) fn validate(&self) -> Result<(), DecodeError> {
+        self.ordered_plugin_names
+            .iter()
+            .filter_map(|f| self.plugins.get(f))
+            .try_for_each(PluginEntry::validate)
     }
 
     pub(crate) fn remove_plugin_metadata(&mut self, plugin_name: &str) {
@@ -495,6 +845,121 @@ impl MetadataDocument {
         if was_removed {
             self.ordered_plugin_names
                 .retain(|f| f.as_ref() != &filename);
+            self.reverse_index.reset();
+        }
+    }
+
+    /// Get the differences between this document and the given previous
+    /// document.
+    ///
+    /// Plugin metadata that was loaded from compiled metadata is only decoded
+    /// to compare it if the metadata it's compared with has been decoded.
+    pub(crate) fn changes_from(&self, previous: &Self) -> MetadataChanges {
+        if std::ptr::eq(self, previous) {
+            return MetadataChanges::default();
+        }
+
+        let mut changes = MetadataChanges {
+            bash_tags_changed: self.bash_tags != previous.bash_tags,
+            groups_changed: self.groups != previous.groups,
+            messages_changed: self.messages != previous.messages,
+            changed_plugins: Vec::new(),
+        };
+
+        for filename in &self.ordered_plugin_names {
+            if let Some(entry) = self.plugins.get(filename)
+                && previous.plugins.get(filename) != Some(entry)
+            {
+                changes.add_changed_plugin(entry.name());
+            }
+        }
+
+        self.add_removed_plugins(previous, &mut changes);
+        self.add_changed_regex_plugins(previous, &mut changes);
+
+        changes
+    }
+
+    /// Replace metadata in this document that's equal to metadata in the
+    /// given previous document with the previous document's metadata, and
+    /// get the differences between the two documents.
+    ///
+    /// This means that any work that has been done to decode plugin metadata,
+    /// parse conditions or compile regexes in the previous document doesn't
+    /// need to be done again for metadata that hasn't changed. Like
+    /// [`MetadataDocument::changes_from`], plugin metadata that was loaded
+    /// from compiled metadata is only decoded to compare it if the metadata
+    /// it's compared with has been decoded.
+    fn reuse_unchanged(&mut self, previous: &Self) -> MetadataChanges {
+        let mut changes = MetadataChanges {
+            bash_tags_changed: self.bash_tags != previous.bash_tags,
+            groups_changed: reuse_equal_elements(&mut self.groups, &previous.groups),
+            messages_changed: reuse_equal_elements(&mut self.messages, &previous.messages),
+            changed_plugins: Vec::new(),
+        };
+
+        for filename in &self.ordered_plugin_names {
+            let Some(entry) = self.plugins.get_mut(filename) else {
+                continue;
+            };
+
+            match previous.plugins.get(filename) {
+                Some(previous_entry) if previous_entry == entry => {
+                    entry.clone_from(previous_entry);
+                }
+                _ => changes.add_changed_plugin(entry.name()),
+            }
+        }
+
+        self.add_removed_plugins(previous, &mut changes);
+        self.add_changed_regex_plugins(previous, &mut changes);
+
+        if self.regex_plugins.iter().eq(previous.regex_plugins.iter()) {
+            // The entries are the same, so their cached matches are still
+            // valid.
+            self.regex_plugins
+                .clone_from_with_matches(&previous.regex_plugins);
+        } else if !previous.regex_plugins.is_empty() {
+            self.regex_plugins = self
+                .regex_plugins
+                .iter()
+                .map(|plugin| {
+                    previous
+                        .regex_plugins
+                        .iter()
+                        .find(|p| *p == plugin)
+                        .unwrap_or(plugin)
+                        .clone()
+                })
+                .collect();
+        }
+
+        changes
+    }
+
+    fn add_removed_plugins(&self, previous: &Self, changes: &mut MetadataChanges) {
+        for filename in &previous.ordered_plugin_names {
+            if let Some(entry) = previous.plugins.get(filename)
+                && !self.plugins.contains_key(filename)
+            {
+                changes.add_changed_plugin(entry.name());
+            }
+        }
+    }
+
+    /// Regex entries aren't identified by their names, so any entry that
+    /// doesn't have an equal entry in the other document has changed.
+    fn add_changed_regex_plugins(&self, previous: &Self, changes: &mut MetadataChanges) {
+        for plugin in &self.regex_plugins {
+            if !previous.regex_plugins.iter().any(|p| p == plugin) {
+                changes.add_changed_plugin(plugin.name());
+            }
+        }
+
+        for plugin in &previous.regex_plugins {
+            if !self.regex_plugins.iter().any(|p| p == plugin) {
+                changes.add_changed_plugin(plugin.name());
+            }
         }
     }
 
@@ -505,6 +970,7 @@ impl MetadataDocument {
         self.plugins.clear();
         self.regex_plugins.clear();
         self.ordered_plugin_names.clear();
+        self.reverse_index.reset();
     }
 }
 
@@ -515,12 +981,73 @@ impl std::default::Default for MetadataDocument {
             groups: vec![Group::default()],
             messages: Vec::default(),
             plugins: HashMap::default(),
-            regex_plugins: Vec::default(),
+            regex_plugins: RegexPlugins::default(),
             ordered_plugin_names: Vec::default(),
+            reverse_index: LazyReverseIndex::default(),
+        }
+    }
+}
+
+impl EncodeBinary for MetadataDocument {
+    fn encode_binary(&self, encoder: &mut BinaryEncoder) {
+        encoder.write_slice(&self.bash_tags);
+        encoder.write_slice(&self.groups);
+        encoder.write_slice(&self.messages);
+
+        // Regex plugins are stored in the same order as their names appear in
+        // the ordered names, so they can be taken in turn.
+        let mut regex_plugins = self.regex_plugins.iter();
+        let plugins: Vec<_> = self
+            .ordered_plugin_names
+            .iter()
+            .filter_map(|f| {
+                self.plugins
+                    .get(f)
+                    .map(PluginEntry::get)
+                    .or_else(|| regex_plugins.next())
+            })
+            .collect();
+
+        // Plugin entries are written so that specific plugin entries can be
+        // decoded lazily, as only a fraction of them are usually needed.
+        encoder.write_len(plugins.len());
+        for plugin in plugins {
+            encoder.write_bool(plugin.is_regex_plugin());
+            encoder.write_str(plugin.name());
+            encoder.write_lazy(plugin);
         }
     }
 }
 
+impl DecodeBinary for MetadataDocument {
+    fn decode_binary(decoder: &mut BinaryDecoder<'_>) -> Result<Self, DecodeError> {
+        let mut document = MetadataDocument {
+            bash_tags: decoder.read_vec()?,
+            groups: decoder.read_vec()?,
+            messages: decoder.read_vec()?,
+            ..Default::default()
+        };
+
+        let plugins_count = decoder.read_len()?;
+        for _ in 0..plugins_count {
+            let is_regex = decoder.read_bool()?;
+            let name = decoder.read_str()?;
+            let encoded = decoder.read_lazy()?;
+
+            // Regex entries are decoded immediately because they're all needed
+            // to build the regex plugins index.
+            if is_regex {
+                document.set_plugin_metadata(encoded.decode()?);
+            } else {
+                let filename = Arc::new(Filename::new(name.to_owned()));
+                document.insert_plugin_entry(filename, PluginEntry::lazy(name, encoded));
+            }
+        }
+
+        Ok(document)
+    }
+}
+
 #[derive(Debug, Clone)]
 struct OrderedCounts<T> {
     order: Vec<T>,
@@ -794,6 +1321,94 @@ where
     emitter.end_array();
 }
 
+/// Replace each of the given values that's equal to the previous value at the
+/// same index with a clone of the previous value, returning true if any values
+/// are different.
+fn reuse_equal_elements<T: Clone + PartialEq>(values: &mut [T], previous: &[T]) -> bool {
+    let mut changed = values.len() != previous.len();
+
+    for (value, previous_value) in values.iter_mut().zip(previous) {
+        if value == previous_value {
+            value.clone_from(previous_value);
+        } else {
+            changed = true;
+        }
+    }
+
+    changed
+}
+
+/// Load the compiled metadata for the given masterlist if it's up to date, and
+/// otherwise load the masterlist using the given function and write its
+/// compiled metadata.
+fn load_compiled_or<F>(
+    masterlist_path: &Path,
+    hashes: &SourceHashes,
+    load: F,
+) -> Result<MetadataDocument, LoadMetadataError>
+where
+    F: FnOnce(&mut MetadataDocument) -> Result<(), LoadMetadataError>,
+{
+    if let Some(document) = compiled_metadata::read(masterlist_path, hashes) {
+        return Ok(document);
+    }
+
+    let mut document = MetadataDocument::default();
+    load(&mut document)?;
+
+    compiled_metadata::write(masterlist_path, hashes, &document);
+
+    Ok(document)
+}
+
+fn read_metadata_file(file_path: &Path) -> Result<String, LoadMetadataError> {
+    if !file_path.exists() {
+        return Err(LoadMetadataError::new(
+            file_path.into(),
+            MetadataDocumentParsingError::PathNotFound,
+        ));
+    }
+
+    logging::trace!("Loading file at \"{}\"", escape_ascii(file_path));
+
+    std::fs::read_to_string(file_path)
+        .map_err(|e| LoadMetadataError::from_io_error(file_path.into(), e))
+}
+
+fn read_masterlist_and_prelude(
+    masterlist_path: &Path,
+    prelude_path: &Path,
+) -> Result<(String, String), LoadMetadataError> {
+    if !masterlist_path.exists() {
+        return Err(LoadMetadataError::new(
+            masterlist_path.into(),
+            MetadataDocumentParsingError::PathNotFound,
+        ));
+    }
+
+    if !prelude_path.exists() {
+        return Err(LoadMetadataError::new(
+            prelude_path.into(),
+            MetadataDocumentParsingError::PathNotFound,
+        ));
+    }
+
+    let masterlist = std::fs::read_to_string(masterlist_path)
+        .map_err(|e| LoadMetadataError::from_io_error(masterlist_path.into(), e))?;
+
+    let prelude = std::fs::read_to_string(prelude_path)
+        .map_err(|e| LoadMetadataError::from_io_error(masterlist_path.into(), e))?;
+
+    Ok((masterlist, prelude))
+}
+
+fn log_loaded(file_path: &Path) {
+    logging::trace!(
+        "Successfully loaded metadata from file at \"{}\".",
+        escape_ascii(file_path)
+    );
+}
+
 struct MasterlistWithReplacedPrelude {
     masterlist: String,
     meta: Option<PreludeDiffSpan>,
@@ -1059,6 +1674,66 @@ plugins:
             assert!(metadata_list.load_from_str(yaml).is_err());
         }
 
+        #[test]
+        fn load_from_str_should_return_the_first_plugin_entry_error() {
+            let yaml = "
+plugins:
+  - name: 'Blank(.esm'
+  - name: 'Blank.esp'
+  - name: 'Blank(.esp'
+        ";
+
+            let mut metadata_list = MetadataDocument::default();
+            let err_message = metadata_list
+                .load_from_str(yaml)
+                .unwrap_err()
+                .source()
+                .unwrap()
+                .to_string();
+
+            assert_eq!(
+                "encountered a YAML parsing error at line 3 column 5: invalid regex in \"name\" key with value \"Blank(.esm\"",
+                err_message
+            );
+        }
+
+        #[test]
+        fn load_from_str_should_share_equal_strings_between_plugin_entries() {
+            let yaml = "
+plugins:
+  - name: 'Blank.esm'
+    msg:
+      - type: say
+        content: 'text'
+        condition: 'file(\"Blank.esp\")'
+  - name: 'Blank.esp'
+    req:
+      - name: 'Blank.esm'
+        condition: 'file(\"Blank.esp\")'
+globals:
+  - type: say
+    content: 'text'
+        ";
+
+            let mut metadata_list = MetadataDocument::default();
+            metadata_list.load_from_str(yaml).unwrap();
+
+            let esm = metadata_list.find_plugin("Blank.esm").unwrap().unwrap();
+            let esp = metadata_list.find_plugin("Blank.esp").unwrap().unwrap();
+            let message = &esm.messages()[0];
+            let file = &esp.requirements()[0];
+            let global = &metadata_list.messages()[0];
+
+            assert!(std::ptr::eq(
+                message.condition().unwrap(),
+                file.condition().unwrap()
+            ));
+            assert!(std::ptr::eq(
+                message.content()[0].text(),
+                global.content()[0].text()
+            ));
+        }
+
         #[test]
         fn load_should_deserialise_masterlist() {
             let tmp_dir = tempdir().unwrap();
@@ -1401,6 +2076,340 @@ plugins:
             );
         }
 
+        const COMPILED_METADATA_YAML: &str = r#"bash_tags:
+  - 'C.Climate'
+
+groups:
+  - name: group1
+    description: A group
+    after:
+      - default
+
+globals:
+  - type: error
+    content:
+      - lang: en
+        text: 'An English message.'
+      - lang: de
+        text: 'A German message.'
+    condition: 'file("Blank.esp")'
+
+plugins:
+  - name: 'Blank.esm'
+    group: group1
+    after:
+      - name: 'Blank.esp'
+        display: 'Blank'
+        detail: 'Some detail.'
+        condition: 'active("Blank.esp")'
+        constraint: 'file("Blank.esm")'
+    req:
+      - 'Blank - Different.esm'
+    tag:
+      - Relev
+      - -Delev
+      - name: C.Climate
+        condition: 'not active("Blank.esp")'
+    url:
+      - 'https://www.example.com'
+      - link: 'https://www.example.org'
+        name: Example
+
+  - name: 'Blank.+\.esp'
+    inc:
+      - 'Blank.esm'
+
+  - name: 'Blank.esp'
+    dirty:
+      - crc: 0xDEADBEEF
+        util: utility
+        itm: 2
+        udr: 3
+        nav: 4
+        detail: 'Dirty.'
+    clean:
+      - crc: 0x12345678
+        util: utility
+"#;
+
+        #[test]
+        fn load_masterlist_should_write_compiled_metadata_that_matches_the_yaml() {
+            let tmp_dir = tempdir().unwrap();
+
+            let path = tmp_dir.path().join("masterlist.yaml");
+            std::fs::write(&path, COMPILED_METADATA_YAML).unwrap();
+
+            let mut expected = MetadataDocument::default();
+            expected.load(&path).unwrap();
+
+            let metadata = MetadataDocument::load_masterlist(&path).unwrap();
+            assert_eq!(expected, *metadata);
+
+            assert!(compiled_metadata::compiled_path(&path).exists());
+
+            // Once the loaded masterlist is no longer in use, loading it again
+            // loads the compiled metadata.
+            drop(metadata);
+            let compiled = MetadataDocument::load_masterlist(&path).unwrap();
+            assert_eq!(expected, *compiled);
+            assert_eq!(
+                expected.ordered_plugins_iter().collect::<Vec<_>>(),
+                compiled.ordered_plugins_iter().collect::<Vec<_>>()
+            );
+        }
+
+        #[test]
+        fn validate_should_decode_lazily_loaded_plugin_metadata() {
+            let tmp_dir = tempdir().unwrap();
+
+            let path = tmp_dir.path().join("masterlist.yaml");
+            std::fs::write(&path, COMPILED_METADATA_YAML).unwrap();
+
+            let mut expected = MetadataDocument::default();
+            expected.load(&path).unwrap();
+
+            // Load the masterlist once to write its compiled metadata.
+            drop(MetadataDocument::load_masterlist(&path).unwrap());
+
+            let loaded = LoadedMetadata::load_masterlist(&path).unwrap();
+            loaded.validate().unwrap();
+
+            let metadata = loaded.into_document();
+            assert_eq!(
+                expected.find_plugin("Blank.esp").unwrap(),
+                metadata.find_plugin("Blank.esp").unwrap()
+            );
+            assert_eq!(expected, *metadata);
+        }
+
+        #[test]
+        fn load_masterlist_should_use_compiled_metadata_if_it_is_up_to_date() {
+            let tmp_dir = tempdir().unwrap();
+
+            let path = tmp_dir.path().join("masterlist.yaml");
+            std::fs::write(&path, COMPILED_METADATA_YAML).unwrap();
+
+            let hashes = SourceHashes::new(COMPILED_METADATA_YAML, None);
+            let mut document = MetadataDocument::default();
+            document.set_bash_tags(vec!["Compiled".into()]);
+            compiled_metadata::write(&path, &hashes, &document);
+
+            let metadata = MetadataDocument::load_masterlist(&path).unwrap();
+
+            assert_eq!(&["Compiled"], metadata.bash_tags());
+        }
+
+        #[test]
+        fn load_masterlist_should_not_use_compiled_metadata_if_the_masterlist_has_changed() {
+            let tmp_dir = tempdir().unwrap();
+
+            let path = tmp_dir.path().join("masterlist.yaml");
+            std::fs::write(&path, COMPILED_METADATA_YAML).unwrap();
+
+            drop(MetadataDocument::load_masterlist(&path).unwrap());
+
+            std::fs::write(&path, METADATA_LIST_YAML).unwrap();
+
+            let mut expected = MetadataDocument::default();
+            expected.load(&path).unwrap();
+
+            let metadata = MetadataDocument::load_masterlist(&path).unwrap();
+            assert_eq!(expected, *metadata);
+        }
+
+        #[test]
+        fn load_masterlist_should_parse_the_yaml_if_the_compiled_metadata_is_corrupt() {
+            let tmp_dir = tempdir().unwrap();
+
+            let path = tmp_dir.path().join("masterlist.yaml");
+            std::fs::write(&path, COMPILED_METADATA_YAML).unwrap();
+
+            drop(MetadataDocument::load_masterlist(&path).unwrap());
+
+            let compiled_path = compiled_metadata::compiled_path(&path);
+            let mut bytes = std::fs::read(&compiled_path).unwrap();
+            bytes.truncate(bytes.len() - 10);
+            std::fs::write(&compiled_path, bytes).unwrap();
+
+            let mut expected = MetadataDocument::default();
+            expected.load(&path).unwrap();
+
+            let metadata = MetadataDocument::load_masterlist(&path).unwrap();
+            assert_eq!(expected, *metadata);
+        }
+
+        #[test]
+        fn load_masterlist_should_share_a_masterlist_that_is_still_loaded() {
+            let tmp_dir = tempdir().unwrap();
+
+            let path = tmp_dir.path().join("masterlist.yaml");
+            std::fs::write(&path, COMPILED_METADATA_YAML).unwrap();
+
+            let first = LoadedMetadata::load_masterlist(&path).unwrap();
+            let second = LoadedMetadata::load_masterlist(&path).unwrap();
+
+            assert!(Arc::ptr_eq(&first.into_document(), &second.into_document()));
+        }
+
+        #[test]
+        fn reload_masterlist_should_return_no_changes_if_the_masterlist_is_unchanged() {
+            let tmp_dir = tempdir().unwrap();
+
+            let path = tmp_dir.path().join("masterlist.yaml");
+            std::fs::write(&path, METADATA_LIST_YAML).unwrap();
+
+            let previous = MetadataDocument::load_masterlist(&path).unwrap();
+            let (document, changes) =
+                MetadataDocument::reload_masterlist(&path, &previous).unwrap();
+
+            assert!(Arc::ptr_eq(&previous, &document));
+            assert!(changes.is_empty());
+        }
+
+        #[test]
+        fn reload_masterlist_should_return_changes_and_reuse_unchanged_metadata() {
+            let tmp_dir = tempdir().unwrap();
+
+            let path = tmp_dir.path().join("masterlist.yaml");
+            std::fs::write(
+                &path,
+                "bash_tags: [Relev]
+globals:
+  - type: say
+    content: 'A global message.'
+plugins:
+  - name: A.esp
+    group: group1
+  - name: B.esp
+    group: group2
+  - name: 'C.*\\.esp'
+    tag: [Relev]
+  - name: E.esp
+    group: group1",
+            )
+            .unwrap();
+
+            let previous = MetadataDocument::load_masterlist(&path).unwrap();
+
+            std::fs::write(
+                &path,
+                "bash_tags: [Delev]
+globals:
+  - type: say
+    content: 'A global message.'
+plugins:
+  - name: A.esp
+    group: group1
+  - name: B.esp
+    group: group3
+  - name: 'C.*\\.esp'
+    tag: [Relev]
+  - name: D.esp
+    group: group1",
+            )
+            .unwrap();
+
+            let (document, changes) =
+                MetadataDocument::reload_masterlist(&path, &previous).unwrap();
+
+            assert!(changes.bash_tags_changed());
+            assert!(!changes.groups_changed());
+            assert!(!changes.messages_changed());
+            assert_eq!(&["B.esp", "D.esp", "E.esp"], changes.changed_plugins());
+
+            let previous_plugin = previous.find_plugin("A.esp").unwrap().unwrap();
+            let plugin = document.find_plugin("A.esp").unwrap().unwrap();
+            assert!(std::ptr::eq(
+                previous_plugin.group().unwrap(),
+                plugin.group().unwrap()
+            ));
+
+            let previous_message = previous.messages().first().unwrap();
+            let message = document.messages().first().unwrap();
+            assert!(std::ptr::eq(
+                previous_message.content().first().unwrap().text(),
+                message.content().first().unwrap().text()
+            ));
+
+            assert_eq!(&["Delev"], document.bash_tags());
+            assert_eq!(
+                Some("group3"),
+                document.find_plugin("B.esp").unwrap().unwrap().group()
+            );
+        }
+
+        #[test]
+        fn reload_masterlist_should_return_the_names_of_changed_regex_entries() {
+            let tmp_dir = tempdir().unwrap();
+
+            let path = tmp_dir.path().join("masterlist.yaml");
+            std::fs::write(
+                &path,
+                "plugins:\n  - name: 'A.*\\.esp'\n    group: group1\n  - name: 'B.*\\.esp'\n    group: group1",
+            )
+            .unwrap();
+
+            let previous = MetadataDocument::load_masterlist(&path).unwrap();
+
+            std::fs::write(
+                &path,
+                "plugins:\n  - name: 'A.*\\.esp'\n    group: group2\n  - name: 'B.*\\.esp'\n    group: group1",
+            )
+            .unwrap();
+
+            let (document, changes) =
+                MetadataDocument::reload_masterlist(&path, &previous).unwrap();
+
+            assert_eq!(&["A.*\\.esp"], changes.changed_plugins());
+            assert_eq!(
+                Some("group2"),
+                document.find_plugin("A.esp").unwrap().unwrap().group()
+            );
+        }
+
+        #[test]
+        fn load_masterlist_with_prelude_should_not_use_compiled_metadata_if_the_prelude_has_changed()
+         {
+            let tmp_dir = tempdir().unwrap();
+
+            let masterlist_path = tmp_dir.path().join("masterlist.yaml");
+            std::fs::write(&masterlist_path, "prelude:\n  - &ref\n    type: say\n    content: Loaded from same file\nglobals:\n  - *ref").unwrap();
+
+            let prelude_path = tmp_dir.path().join("prelude.yaml");
+            std::fs::write(
+                &prelude_path,
+                "common:\n  - &ref\n    type: say\n    content: Loaded from prelude",
+            )
+            .unwrap();
+
+            let metadata =
+                MetadataDocument::load_masterlist_with_prelude(&masterlist_path, &prelude_path)
+                    .unwrap();
+
+            assert_eq!(
+                [Message::new(
+                    MessageType::Say,
+                    "Loaded from prelude".to_owned()
+                )],
+                metadata.messages()
+            );
+
+            std::fs::write(
+                &prelude_path,
+                "common:\n  - &ref\n    type: say\n    content: Changed prelude",
+            )
+            .unwrap();
+
+            let metadata =
+                MetadataDocument::load_masterlist_with_prelude(&masterlist_path, &prelude_path)
+                    .unwrap();
+
+            assert_eq!(
+                [Message::new(MessageType::Say, "Changed prelude".to_owned())],
+                metadata.messages()
+            );
+        }
+
         #[test]
         fn save_should_write_the_loaded_metadata() {
             let tmp_dir = tempdir().unwrap();
@@ -1862,6 +2871,33 @@ plugins:
             assert!(metadata.find_plugin("Blank.esp").unwrap().is_none());
         }
 
+        #[test]
+        fn find_plugin_should_share_the_metadata_lists_of_the_stored_entry() {
+            let mut metadata = MetadataDocument::default();
+            metadata.load_from_str(METADATA_LIST_YAML).unwrap();
+
+            let name = "Blank - Different.esp";
+            let plugin1 = metadata.find_plugin(name).unwrap().unwrap();
+            let plugin2 = metadata.find_plugin(name).unwrap().unwrap();
+
+            assert!(std::ptr::eq(
+                plugin1.load_after_files().as_ptr(),
+                plugin2.load_after_files().as_ptr()
+            ));
+            assert!(std::ptr::eq(
+                plugin1.incompatibilities().as_ptr(),
+                plugin2.incompatibilities().as_ptr()
+            ));
+
+            let plugin1 = metadata.find_plugin("Blank.esp").unwrap().unwrap();
+            let plugin2 = metadata.find_plugin("Blank.esp").unwrap().unwrap();
+
+            assert!(std::ptr::eq(
+                plugin1.dirty_info().as_ptr(),
+                plugin2.dirty_info().as_ptr()
+            ));
+        }
+
         #[test]
         fn find_plugin_should_return_the_metadata_object_if_one_exists() {
             let mut metadata = MetadataDocument::default();
@@ -1,15 +1,26 @@
 //! Holds all types related to LOOT metadata.
+mod binary;
+mod compiled_metadata;
+mod condition;
 pub mod error;
 mod file;
 mod group;
+mod interner;
+pub(crate) mod journal;
+mod loaded_masterlists;
+pub(crate) mod localise;
 mod location;
 mod message;
 pub(crate) mod metadata_document;
 mod plugin_cleaning_data;
+mod plugin_entry;
 pub(crate) mod plugin_metadata;
+mod regex_plugins;
+mod reverse_index;
 mod tag;
 mod yaml;
 
+pub(crate) use condition::Condition;
 pub use file::{File, Filename};
 pub use group::Group;
 pub use location::Location;
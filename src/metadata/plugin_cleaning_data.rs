@@ -1,9 +1,15 @@
+use std::sync::Arc;
+
 use saphyr::MarkedYaml;
 
 use crate::metadata::yaml::parse_condition;
 
 use super::{
+    binary::{BinaryDecoder, BinaryEncoder, DecodeBinary, DecodeError, EncodeBinary},
+    condition::Condition,
     error::{MultilingualMessageContentsError, ParseMetadataError},
+    interner::{InternStrings, StringInterner},
+    localise::SelectLanguage,
     message::{
         MessageContent, emit_message_contents, parse_message_contents_yaml,
         validate_message_contents,
@@ -22,9 +28,9 @@ pub struct PluginCleaningData {
     itm_count: u32,
     deleted_reference_count: u32,
     deleted_navmesh_count: u32,
-    cleaning_utility: Box<str>,
+    cleaning_utility: Arc<str>,
     detail: Box<[MessageContent]>,
-    condition: Option<Box<str>>,
+    condition: Option<Condition>,
 }
 
 impl PluginCleaningData {
@@ -37,7 +43,7 @@ impl PluginCleaningData {
             itm_count: 0,
             deleted_reference_count: 0,
             deleted_navmesh_count: 0,
-            cleaning_utility: cleaning_utility.into_boxed_str(),
+            cleaning_utility: cleaning_utility.into(),
             detail: Box::default(),
             condition: None,
         }
@@ -79,7 +85,7 @@ impl PluginCleaningData {
     /// Set the condition string.
     #[must_use]
     pub fn with_condition(mut self, condition: String) -> Self {
-        self.condition = Some(condition.into_boxed_str());
+        self.condition = Some(Condition::new(condition));
         self
     }
 
@@ -121,7 +127,11 @@ impl PluginCleaningData {
 
     /// Get the condition string.
     pub fn condition(&self) -> Option<&str> {
-        self.condition.as_deref()
+        self.condition.as_ref().map(Condition::as_str)
+    }
+
+    pub(crate) fn parsed_condition(&self) -> Option<&Condition> {
+        self.condition.as_ref()
     }
 }
 
@@ -201,13 +211,57 @@ impl EmitYaml for PluginCleaningData {
 
         if let Some(condition) = &self.condition {
             emitter.write_map_key("condition");
-            emitter.write_condition(condition);
+            emitter.write_condition(condition.as_str());
         }
 
         emitter.end_map();
     }
 }
 
+impl EncodeBinary for PluginCleaningData {
+    fn encode_binary(&self, encoder: &mut BinaryEncoder) {
+        encoder.write_u32(self.crc);
+        encoder.write_u32(self.itm_count);
+        encoder.write_u32(self.deleted_reference_count);
+        encoder.write_u32(self.deleted_navmesh_count);
+        encoder.write_str(&self.cleaning_utility);
+        encoder.write_slice(&self.detail);
+        encoder.write_condition(self.condition.as_ref());
+    }
+}
+
+impl DecodeBinary for PluginCleaningData {
+    fn decode_binary(decoder: &mut BinaryDecoder<'_>) -> Result<Self, DecodeError> {
+        Ok(Self {
+            crc: decoder.read_u32()?,
+            itm_count: decoder.read_u32()?,
+            deleted_reference_count: decoder.read_u32()?,
+            deleted_navmesh_count: decoder.read_u32()?,
+            cleaning_utility: decoder.read_shared_str()?,
+            detail: decoder.read_vec()?.into_boxed_slice(),
+            condition: decoder.read_condition()?,
+        })
+    }
+}
+
+impl InternStrings for PluginCleaningData {
+    fn intern_strings(&mut self, interner: &mut StringInterner) {
+        self.cleaning_utility.intern_strings(interner);
+        self.detail.intern_strings(interner);
+        self.condition.intern_strings(interner);
+    }
+}
+
+impl SelectLanguage for PluginCleaningData {
+    fn select_language(&mut self, language: &str) {
+        self.detail.select_language(language);
+    }
+
+    fn is_multilingual(&self) -> bool {
+        self.detail.is_multilingual()
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
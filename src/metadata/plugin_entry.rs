@@ -0,0 +1,194 @@
+use std::sync::OnceLock;
+
+use crate::logging;
+
+use super::{
+    binary::{DecodeError, LazyValue},
+    plugin_metadata::PluginMetadata,
+};
+
+/// Holds a specific plugin's metadata, which may have been loaded from
+/// compiled metadata without being decoded.
+///
+/// Most of a masterlist's entries are for plugins that aren't installed, so
+/// when a masterlist is loaded from compiled metadata its specific plugin
+/// entries are only decoded when they're first looked up.
+#[derive(Clone, Debug)]
+pub(super) struct PluginEntry {
+    name: Box<str>,
+    metadata: OnceLock<PluginMetadata>,
+    encoded: Option<LazyValue>,
+}
+
+impl PluginEntry {
+    pub(super) fn new(metadata: PluginMetadata) -> Self {
+        Self {
+            name: metadata.name().into(),
+            metadata: OnceLock::from(metadata),
+            encoded: None,
+        }
+    }
+
+    pub(super) fn lazy(name: &str, encoded: LazyValue) -> Self {
+        Self {
+            name: name.into(),
+            metadata: OnceLock::new(),
+            encoded: Some(encoded),
+        }
+    }
+
+    pub(super) fn name(&self) -> &str {
+        &self.name
+    }
+
+    /// Get the entry's metadata, decoding it if necessary.
+    ///
+    /// Compiled metadata is checksummed when it's loaded, so decoding should
+    /// never fail, but if it does the error is logged and the plugin is
+    /// treated as having no metadata. Use [`PluginEntry::validate`] to check
+    /// for errors.
+    pub(super) fn get(&self) -> &PluginMetadata {
+        self.metadata.get_or_init(|| match self.decode() {
+            Ok(metadata) => metadata,
+            Err(e) => {
+                logging::error!(
+                    "Failed to decode the compiled metadata for \"{}\": {}",
+                    self.name,
+                    e
+                );
+                PluginMetadata::new(&self.name).unwrap_or_default()
+            }
+        })
+    }
+
+    /// Decode the entry's metadata if it hasn't already been decoded,
+    /// returning an error if it can't be decoded.
+    pub(super) fn validate(&self) -> Result<(), DecodeError> {
+        if self.metadata.get().is_some() {
+            return Ok(());
+        }
+
+        let metadata = self.decode()?;
+        // If another thread has decoded the metadata in the meantime, it'll
+        // be identical.
+        self.metadata.get_or_init(|| metadata);
+
+        Ok(())
+    }
+
+    fn decode(&self) -> Result<PluginMetadata, DecodeError> {
+        match &self.encoded {
+            Some(encoded) => {
+                let metadata: PluginMetadata = encoded.decode()?;
+                if unicase::eq(metadata.name(), self.name.as_ref()) {
+                    Ok(metadata)
+                } else {
+                    Err(DecodeError::InvalidValue)
+                }
+            }
+            None => PluginMetadata::new(&self.name).map_err(|_e| DecodeError::InvalidValue),
+        }
+    }
+}
+
+impl PartialEq for PluginEntry {
+    /// Entries that haven't been decoded are compared without decoding them.
+    fn eq(&self, other: &Self) -> bool {
+        match (&self.encoded, &other.encoded) {
+            (Some(encoded), Some(other_encoded))
+                if self.metadata.get().is_none() && other.metadata.get().is_none() =>
+            {
+                encoded.has_same_content(other_encoded)
+            }
+            _ => self.get() == other.get(),
+        }
+    }
+}
+
+impl Eq for PluginEntry {}
+
+#[cfg(test)]
+mod tests {
+    use crate::metadata::binary::{BinaryData, BinaryEncoder};
+
+    use super::*;
+
+    fn lazy_value(metadata: &PluginMetadata) -> LazyValue {
+        let mut encoder = BinaryEncoder::default();
+        encoder.write_lazy(metadata);
+
+        let data = BinaryData::new(encoder.into_bytes()).unwrap();
+        data.decoder().read_lazy().unwrap()
+    }
+
+    #[test]
+    fn get_should_decode_a_lazy_entry() {
+        let mut metadata = PluginMetadata::new("Blank.esp").unwrap();
+        metadata.set_group("group".into());
+
+        let entry = PluginEntry::lazy("Blank.esp", lazy_value(&metadata));
+
+        assert!(entry.metadata.get().is_none());
+        assert_eq!(&metadata, entry.get());
+        assert!(entry.metadata.get().is_some());
+    }
+
+    #[test]
+    fn get_should_return_no_metadata_if_the_entry_cannot_be_decoded() {
+        let metadata = PluginMetadata::new("Blank.esm").unwrap();
+
+        let entry = PluginEntry::lazy("Blank.esp", lazy_value(&metadata));
+
+        assert_eq!(&PluginMetadata::new("Blank.esp").unwrap(), entry.get());
+    }
+
+    #[test]
+    fn eq_should_not_decode_entries_that_have_not_been_decoded() {
+        let mut metadata = PluginMetadata::new("Blank.esp").unwrap();
+        metadata.set_group("group".into());
+
+        let entry1 = PluginEntry::lazy("Blank.esp", lazy_value(&metadata));
+        let entry2 = PluginEntry::lazy("Blank.esp", lazy_value(&metadata));
+
+        assert!(entry1 == entry2);
+        assert!(entry1.metadata.get().is_none());
+        assert!(entry2.metadata.get().is_none());
+
+        metadata.set_group("other".into());
+        let entry3 = PluginEntry::lazy("Blank.esp", lazy_value(&metadata));
+
+        assert!(entry1 != entry3);
+        assert!(entry3.metadata.get().is_none());
+    }
+
+    #[test]
+    fn eq_should_compare_metadata_if_an_entry_has_been_decoded() {
+        let metadata = PluginMetadata::new("Blank.esp").unwrap();
+
+        let entry1 = PluginEntry::lazy("Blank.esp", lazy_value(&metadata));
+        entry1.get();
+        let entry2 = PluginEntry::lazy("Blank.esp", lazy_value(&metadata));
+
+        assert!(entry1 == entry2);
+        assert!(entry1 == PluginEntry::new(metadata));
+    }
+
+    #[test]
+    fn validate_should_error_if_the_entry_cannot_be_decoded() {
+        let metadata = PluginMetadata::new("Blank.esm").unwrap();
+
+        let entry = PluginEntry::lazy("Blank.esp", lazy_value(&metadata));
+
+        assert_eq!(DecodeError::InvalidValue, entry.validate().unwrap_err());
+    }
+
+    #[test]
+    fn validate_should_decode_a_lazy_entry() {
+        let metadata = PluginMetadata::new("Blank.esp").unwrap();
+
+        let entry = PluginEntry::lazy("Blank.esp", lazy_value(&metadata));
+
+        entry.validate().unwrap();
+        assert!(entry.metadata.get().is_some());
+    }
+}
@@ -1,4 +1,4 @@
-use std::borrow::Cow;
+use std::{borrow::Cow, sync::Arc};
 
 use regress::{Error as RegexImplError, Regex};
 use saphyr::MarkedYaml;
@@ -8,8 +8,11 @@ use crate::{
 };
 
 use super::{
+    binary::{BinaryDecoder, BinaryEncoder, DecodeBinary, DecodeError, EncodeBinary},
     error::{MetadataParsingErrorReason, ParseMetadataError, RegexError},
     file::File,
+    interner::{InternStrings, StringInterner},
+    localise::SelectLanguage,
     location::Location,
     message::Message,
     plugin_cleaning_data::PluginCleaningData,
@@ -23,18 +26,22 @@ use super::{
 pub(crate) const GHOST_FILE_EXTENSION: &str = ".ghost";
 
 /// Represents a plugin's metadata.
+///
+/// The plugin's name and metadata lists are reference-counted, so cloning a
+/// value, and merging in metadata when one side has none of a given kind, only
+/// shares the existing data instead of copying it.
 #[derive(Clone, Debug, Default, Eq, PartialEq, Ord, PartialOrd, Hash)]
 pub struct PluginMetadata {
     name: PluginName,
-    group: Option<Box<str>>,
-    load_after: Box<[File]>,
-    requirements: Box<[File]>,
-    incompatibilities: Box<[File]>,
-    messages: Box<[Message]>,
-    tags: Box<[Tag]>,
-    dirty_info: Box<[PluginCleaningData]>,
-    clean_info: Box<[PluginCleaningData]>,
-    locations: Box<[Location]>,
+    group: Option<Arc<str>>,
+    load_after: Arc<[File]>,
+    requirements: Arc<[File]>,
+    incompatibilities: Arc<[File]>,
+    messages: Arc<[Message]>,
+    tags: Arc<[Tag]>,
+    dirty_info: Arc<[PluginCleaningData]>,
+    clean_info: Arc<[PluginCleaningData]>,
+    locations: Arc<[Location]>,
 }
 
 impl PluginMetadata {
@@ -43,14 +50,14 @@ impl PluginMetadata {
         Ok(Self {
             name: PluginName::new(name)?,
             group: None,
-            load_after: Box::default(),
-            requirements: Box::default(),
-            incompatibilities: Box::default(),
-            messages: Box::default(),
-            tags: Box::default(),
-            dirty_info: Box::default(),
-            clean_info: Box::default(),
-            locations: Box::default(),
+            load_after: Arc::default(),
+            requirements: Arc::default(),
+            incompatibilities: Arc::default(),
+            messages: Arc::default(),
+            tags: Arc::default(),
+            dirty_info: Arc::default(),
+            clean_info: Arc::default(),
+            locations: Arc::default(),
         })
     }
 
@@ -58,14 +65,14 @@ impl PluginMetadata {
         Self {
             name: metadata.name.clone(),
             group: None,
-            load_after: Box::default(),
-            requirements: Box::default(),
-            incompatibilities: Box::default(),
-            messages: Box::default(),
-            tags: Box::default(),
-            dirty_info: Box::default(),
-            clean_info: Box::default(),
-            locations: Box::default(),
+            load_after: Arc::default(),
+            requirements: Arc::default(),
+            incompatibilities: Arc::default(),
+            messages: Arc::default(),
+            tags: Arc::default(),
+            dirty_info: Arc::default(),
+            clean_info: Arc::default(),
+            locations: Arc::default(),
         }
     }
 
@@ -123,7 +130,7 @@ impl PluginMetadata {
 
     /// Set the plugin's group.
     pub fn set_group(&mut self, group: String) {
-        self.group = Some(group.into_boxed_str());
+        self.group = Some(group.into());
     }
 
     /// Unsets the plugin's group, so that it is implicitly a member of the
@@ -134,42 +141,42 @@ impl PluginMetadata {
 
     /// Get the plugins that the plugin must load after.
     pub fn set_load_after_files(&mut self, files: Vec<File>) {
-        self.load_after = files.into_boxed_slice();
+        self.load_after = files.into();
     }
 
     /// Get the files that the plugin requires to be installed.
     pub fn set_requirements(&mut self, files: Vec<File>) {
-        self.requirements = files.into_boxed_slice();
+        self.requirements = files.into();
     }
 
     /// Get the files that the plugin is incompatible with.
     pub fn set_incompatibilities(&mut self, files: Vec<File>) {
-        self.incompatibilities = files.into_boxed_slice();
+        self.incompatibilities = files.into();
     }
 
     /// Get the plugin's messages.
     pub fn set_messages(&mut self, messages: Vec<Message>) {
-        self.messages = messages.into_boxed_slice();
+        self.messages = messages.into();
     }
 
     /// Get the plugin's Bash Tag suggestions.
     pub fn set_tags(&mut self, tags: Vec<Tag>) {
-        self.tags = tags.into_boxed_slice();
+        self.tags = tags.into();
     }
 
     /// Get the plugin's dirty plugin information.
     pub fn set_dirty_info(&mut self, dirty_info: Vec<PluginCleaningData>) {
-        self.dirty_info = dirty_info.into_boxed_slice();
+        self.dirty_info = dirty_info.into();
     }
 
     /// Get the plugin's clean plugin information.
     pub fn set_clean_info(&mut self, clean_info: Vec<PluginCleaningData>) {
-        self.clean_info = clean_info.into_boxed_slice();
+        self.clean_info = clean_info.into();
     }
 
     /// Get the locations at which this plugin can be found.
     pub fn set_locations(&mut self, locations: Vec<Location>) {
-        self.locations = locations.into_boxed_slice();
+        self.locations = locations.into();
     }
 
     /// Merge metadata from the given `PluginMetadata` object into this object.
@@ -191,12 +198,16 @@ impl PluginMetadata {
         merge_slices(&mut self.incompatibilities, &plugin.incompatibilities);
         merge_slices(&mut self.tags, &plugin.tags);
 
-        self.messages = self
-            .messages
-            .iter()
-            .chain(plugin.messages.iter())
-            .cloned()
-            .collect();
+        if self.messages.is_empty() {
+            self.messages = Arc::clone(&plugin.messages);
+        } else if !plugin.messages.is_empty() {
+            self.messages = self
+                .messages
+                .iter()
+                .chain(plugin.messages.iter())
+                .cloned()
+                .collect();
+        }
 
         merge_slices(&mut self.dirty_info, &plugin.dirty_info);
         merge_slices(&mut self.clean_info, &plugin.clean_info);
@@ -246,38 +257,47 @@ impl PluginMetadata {
         mut self,
         database: &Database,
     ) -> Result<Self, ConditionEvaluationError> {
-        self.load_after = filter_files_by_constraint(self.load_after, database)?;
-        self.requirements = filter_files_by_constraint(self.requirements, database)?;
+        filter_files_by_constraint(&mut self.load_after, database)?;
+        filter_files_by_constraint(&mut self.requirements, database)?;
 
         Ok(self)
     }
 }
 
 fn filter_files_by_constraint(
-    files: Box<[File]>,
+    files: &mut Arc<[File]>,
     database: &Database,
-) -> Result<Box<[File]>, ConditionEvaluationError> {
-    files
-        .into_iter()
+) -> Result<(), ConditionEvaluationError> {
+    if files.iter().all(|f| f.parsed_constraint().is_none()) {
+        return Ok(());
+    }
+
+    *files = files
+        .iter()
         .filter_map(|f| {
-            if let Some(c) = f.constraint() {
-                database.evaluate(c).map(|r| r.then_some(f)).transpose()
+            if let Some(c) = f.parsed_constraint() {
+                database
+                    .evaluate_parsed(c)
+                    .map(|r| r.then(|| f.clone()))
+                    .transpose()
             } else {
-                Some(Ok(f))
+                Some(Ok(f.clone()))
             }
         })
-        .collect()
+        .collect::<Result<_, _>>()?;
+
+    Ok(())
 }
 
 #[derive(Clone, Debug, Default)]
 struct PluginName {
-    string: Box<str>,
-    regex: Option<Regex>,
+    string: Arc<str>,
+    regex: Option<Arc<Regex>>,
 }
 
 impl PluginName {
     fn new(name: &str) -> Result<Self, Box<RegexImplError>> {
-        let name: Box<str> = trim_dot_ghost(name).into();
+        let name: Arc<str> = trim_dot_ghost(name).into();
 
         if is_regex_name(&name) {
             let non_capturing_name = replace_capturing_groups(&name);
@@ -286,7 +306,7 @@ impl PluginName {
 
             Ok(Self {
                 string: name,
-                regex: Some(regex),
+                regex: Some(Arc::new(regex)),
             })
         } else {
             Ok(Self {
@@ -367,15 +387,24 @@ fn is_regex_name(name: &str) -> bool {
     name.contains([':', '\\', '*', '?', '|'])
 }
 
-fn merge_slices<T: Clone + PartialEq>(target: &mut Box<[T]>, source: &[T]) {
+fn merge_slices<T: Clone + PartialEq>(target: &mut Arc<[T]>, source: &Arc<[T]>) {
+    if target.is_empty() {
+        *target = Arc::clone(source);
+        return;
+    }
+
+    if source.iter().all(|e| target.contains(e)) {
+        return;
+    }
+
     let mut vec = target.to_vec();
-    for element in source {
+    for element in source.iter() {
         if !target.contains(element) {
             vec.push(element.clone());
         }
     }
 
-    *target = vec.into_boxed_slice();
+    *target = vec.into();
 }
 
 fn replace_capturing_groups(regex_string: &str) -> Cow<'_, str> {
@@ -430,14 +459,14 @@ impl TryFromYaml for PluginMetadata {
 
         let group = get_string_value(mapping, "group", YamlObjectType::PluginMetadata)?;
 
-        let load_after = get_boxed_slice(mapping, "after")?;
-        let requirements = get_boxed_slice(mapping, "req")?;
-        let incompatibilities = get_boxed_slice(mapping, "inc")?;
-        let messages = get_boxed_slice(mapping, "msg")?;
-        let tags = get_boxed_slice(mapping, "tag")?;
-        let dirty_info = get_boxed_slice(mapping, "dirty")?;
-        let clean_info = get_boxed_slice(mapping, "clean")?;
-        let locations = get_boxed_slice(mapping, "url")?;
+        let load_after = get_shared_slice(mapping, "after")?;
+        let requirements = get_shared_slice(mapping, "req")?;
+        let incompatibilities = get_shared_slice(mapping, "inc")?;
+        let messages = get_shared_slice(mapping, "msg")?;
+        let tags = get_shared_slice(mapping, "tag")?;
+        let dirty_info = get_shared_slice(mapping, "dirty")?;
+        let clean_info = get_shared_slice(mapping, "clean")?;
+        let locations = get_shared_slice(mapping, "url")?;
 
         Ok(PluginMetadata {
             name,
@@ -454,10 +483,10 @@ impl TryFromYaml for PluginMetadata {
     }
 }
 
-fn get_boxed_slice<T: TryFromYaml>(
+fn get_shared_slice<T: TryFromYaml>(
     mapping: &saphyr::AnnotatedMapping<MarkedYaml>,
     key: &'static str,
-) -> Result<Box<[T]>, ParseMetadataError> {
+) -> Result<Arc<[T]>, ParseMetadataError> {
     get_slice_value(mapping, key, YamlObjectType::PluginMetadata)?
         .iter()
         .map(|e| T::try_from_yaml(e))
@@ -520,6 +549,74 @@ impl EmitYaml for PluginMetadata {
     }
 }
 
+impl EncodeBinary for PluginMetadata {
+    fn encode_binary(&self, encoder: &mut BinaryEncoder) {
+        encoder.write_str(self.name.as_str());
+        encoder.write_option_str(self.group.as_deref());
+        encoder.write_slice(&self.load_after);
+        encoder.write_slice(&self.requirements);
+        encoder.write_slice(&self.incompatibilities);
+        encoder.write_slice(&self.messages);
+        encoder.write_slice(&self.tags);
+        encoder.write_slice(&self.dirty_info);
+        encoder.write_slice(&self.clean_info);
+        encoder.write_slice(&self.locations);
+    }
+}
+
+impl DecodeBinary for PluginMetadata {
+    fn decode_binary(decoder: &mut BinaryDecoder<'_>) -> Result<Self, DecodeError> {
+        let name = PluginName::new(decoder.read_str()?).map_err(|_e| DecodeError::InvalidValue)?;
+
+        Ok(Self {
+            name,
+            group: decoder.read_option_shared_str()?,
+            load_after: decoder.read_vec::<File>()?.into(),
+            requirements: decoder.read_vec::<File>()?.into(),
+            incompatibilities: decoder.read_vec::<File>()?.into(),
+            messages: decoder.read_vec::<Message>()?.into(),
+            tags: decoder.read_vec::<Tag>()?.into(),
+            dirty_info: decoder.read_vec::<PluginCleaningData>()?.into(),
+            clean_info: decoder.read_vec::<PluginCleaningData>()?.into(),
+            locations: decoder.read_vec::<Location>()?.into(),
+        })
+    }
+}
+
+impl InternStrings for PluginMetadata {
+    fn intern_strings(&mut self, interner: &mut StringInterner) {
+        self.group.intern_strings(interner);
+        self.load_after.intern_strings(interner);
+        self.requirements.intern_strings(interner);
+        self.incompatibilities.intern_strings(interner);
+        self.messages.intern_strings(interner);
+        self.tags.intern_strings(interner);
+        self.dirty_info.intern_strings(interner);
+        self.clean_info.intern_strings(interner);
+        self.locations.intern_strings(interner);
+    }
+}
+
+impl SelectLanguage for PluginMetadata {
+    fn select_language(&mut self, language: &str) {
+        self.load_after.select_language(language);
+        self.requirements.select_language(language);
+        self.incompatibilities.select_language(language);
+        self.messages.select_language(language);
+        self.dirty_info.select_language(language);
+        self.clean_info.select_language(language);
+    }
+
+    fn is_multilingual(&self) -> bool {
+        self.load_after.is_multilingual()
+            || self.requirements.is_multilingual()
+            || self.incompatibilities.is_multilingual()
+            || self.messages.is_multilingual()
+            || self.dirty_info.is_multilingual()
+            || self.clean_info.is_multilingual()
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use crate::{
@@ -568,6 +665,27 @@ mod tests {
             assert_eq!(BLANK_ESM, plugin1.name());
         }
 
+        #[test]
+        fn should_share_other_metadata_that_is_missing_from_this_object() {
+            let mut plugin1 = PluginMetadata::new(BLANK_ESM).unwrap();
+            plugin1.set_tags(vec![Tag::new("Relev".into(), TagSuggestion::Addition)]);
+            let mut plugin2 = PluginMetadata::new(BLANK_ESM).unwrap();
+            plugin2.set_tags(vec![Tag::new("Delev".into(), TagSuggestion::Addition)]);
+            plugin2.set_messages(vec![Message::new(MessageType::Say, "content".into())]);
+
+            plugin1.merge_metadata(&plugin2);
+
+            assert!(std::ptr::eq(
+                plugin2.messages().as_ptr(),
+                plugin1.messages().as_ptr()
+            ));
+            assert!(!std::ptr::eq(
+                plugin2.tags().as_ptr(),
+                plugin1.tags().as_ptr()
+            ));
+            assert_eq!(2, plugin1.tags().len());
+        }
+
         #[test]
         fn should_not_use_other_group_if_current_group_is_set() {
             let mut plugin1 = PluginMetadata::new(BLANK_ESM).unwrap();
@@ -0,0 +1,654 @@
+use std::{
+    collections::HashMap,
+    sync::{Arc, RwLock},
+};
+
+use super::plugin_metadata::PluginMetadata;
+
+/// Holds the plugin metadata entries that have regex names, along with an
+/// index that's used to avoid running most of their regexes when looking up
+/// the entries that match a given plugin name.
+///
+/// Each entry's regex is analysed to find a literal prefix and suffix that any
+/// matching plugin name must have, e.g. `Foo` and `.esp` for `Foo.*\.esp`.
+/// Entries are bucketed by the first character of their prefix, so a lookup
+/// only considers the entries in the bucket for the plugin name's first
+/// character plus those that have no usable prefix, and then only runs the
+/// regexes of entries whose prefix and suffix the plugin name has.
+///
+/// The indices of the entries that match each plugin name that's looked up are
+/// cached, so repeated lookups for the same name don't run any regexes. The
+/// cache is discarded whenever entries are added or removed.
+#[derive(Clone, Debug, Default, Eq, PartialEq)]
+pub(crate) struct RegexPlugins {
+    entries: Vec<PluginMetadata>,
+    prefilters: Vec<Prefilter>,
+    buckets: HashMap<u8, Vec<usize>>,
+    unbucketed: Vec<usize>,
+    match_cache: MatchCache,
+}
+
+impl RegexPlugins {
+    pub(crate) fn push(&mut self, plugin: PluginMetadata) {
+        let prefilter = Prefilter::new(plugin.name());
+        let index = self.entries.len();
+
+        match prefilter.bucket_key() {
+            Some(key) => self.buckets.entry(key).or_default().push(index),
+            None => self.unbucketed.push(index),
+        }
+
+        self.entries.push(plugin);
+        self.prefilters.push(prefilter);
+        self.match_cache = MatchCache::default();
+    }
+
+    pub(crate) fn retain<F: FnMut(&PluginMetadata) -> bool>(&mut self, predicate: F) {
+        let old_length = self.entries.len();
+
+        self.entries.retain(predicate);
+
+        if self.entries.len() != old_length {
+            let entries = std::mem::take(&mut self.entries);
+            *self = entries.into_iter().collect();
+        }
+    }
+
+    pub(crate) fn clear(&mut self) {
+        self.entries.clear();
+        self.prefilters.clear();
+        self.buckets.clear();
+        self.unbucketed.clear();
+        self.match_cache = MatchCache::default();
+    }
+
+    pub(crate) fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+
+    /// Replace these entries with a copy of the given entries, including
+    /// their cached matches, which cloning discards.
+    pub(crate) fn clone_from_with_matches(&mut self, source: &Self) {
+        self.clone_from(source);
+        self.match_cache = source.match_cache.copy();
+    }
+
+    pub(crate) fn iter(&self) -> std::slice::Iter<'_, PluginMetadata> {
+        self.entries.iter()
+    }
+
+    /// Get the entries with regexes that match the given plugin name, in the
+    /// order that they were added.
+    pub(crate) fn matching(&self, plugin_name: &str) -> impl Iterator<Item = &PluginMetadata> {
+        let indices = self.matching_indices(plugin_name);
+
+        (0..indices.len())
+            .filter_map(move |i| indices.get(i).and_then(|index| self.entries.get(*index)))
+    }
+
+    fn matching_indices(&self, plugin_name: &str) -> Arc<[usize]> {
+        if let Some(indices) = self.match_cache.get(plugin_name) {
+            return indices;
+        }
+
+        let indices: Arc<[usize]> = self
+            .candidate_indices(plugin_name)
+            .into_iter()
+            .filter(|i| {
+                self.prefilters
+                    .get(*i)
+                    .zip(self.entries.get(*i))
+                    .is_some_and(|(prefilter, entry)| {
+                        prefilter.may_match(plugin_name) && entry.name_matches(plugin_name)
+                    })
+            })
+            .collect();
+
+        self.match_cache
+            .insert(plugin_name.to_owned(), Arc::clone(&indices));
+
+        indices
+    }
+
+    fn candidate_indices(&self, plugin_name: &str) -> Vec<usize> {
+        let Some(key) = plugin_name.chars().next().and_then(ascii_key) else {
+            return (0..self.entries.len()).collect();
+        };
+
+        let mut indices: Vec<usize> = self
+            .buckets
+            .get(&key)
+            .into_iter()
+            .flatten()
+            .chain(&self.unbucketed)
+            .copied()
+            .collect();
+
+        // Entries need to be merged in the order they were added.
+        indices.sort_unstable();
+
+        indices
+    }
+}
+
+impl FromIterator<PluginMetadata> for RegexPlugins {
+    fn from_iter<T: IntoIterator<Item = PluginMetadata>>(iter: T) -> Self {
+        let mut regex_plugins = RegexPlugins::default();
+        for plugin in iter {
+            regex_plugins.push(plugin);
+        }
+        regex_plugins
+    }
+}
+
+impl<'a> IntoIterator for &'a RegexPlugins {
+    type Item = &'a PluginMetadata;
+    type IntoIter = std::slice::Iter<'a, PluginMetadata>;
+
+    fn into_iter(self) -> Self::IntoIter {
+        self.iter()
+    }
+}
+
+/// Maps plugin names to the indices of the entries with regexes that match
+/// them.
+///
+/// Names are compared exactly rather than case-insensitively, because regexes
+/// are matched using Unicode case folding and that may not treat the same
+/// names as equal as [`Filename`](super::Filename) comparison does. The cache
+/// isn't copied when it's cloned, and it's ignored when comparing entries.
+#[derive(Debug, Default)]
+struct MatchCache(RwLock<HashMap<String, Arc<[usize]>>>);
+
+impl MatchCache {
+    fn get(&self, plugin_name: &str) -> Option<Arc<[usize]>> {
+        // If the lock is poisoned, fall back to not caching.
+        self.0.read().ok()?.get(plugin_name).map(Arc::clone)
+    }
+
+    fn insert(&self, plugin_name: String, indices: Arc<[usize]>) {
+        if let Ok(mut map) = self.0.write() {
+            map.insert(plugin_name, indices);
+        }
+    }
+
+    fn copy(&self) -> Self {
+        // If the lock is poisoned, fall back to not caching.
+        Self(RwLock::new(
+            self.0.read().map(|m| m.clone()).unwrap_or_default(),
+        ))
+    }
+
+    #[cfg(test)]
+    fn len(&self) -> usize {
+        self.0.read().map(|m| m.len()).unwrap_or_default()
+    }
+}
+
+impl Clone for MatchCache {
+    fn clone(&self) -> Self {
+        Self::default()
+    }
+}
+
+impl PartialEq for MatchCache {
+    fn eq(&self, _: &Self) -> bool {
+        true
+    }
+}
+
+impl Eq for MatchCache {}
+
+/// Literal text that a plugin name must start and end with to be able to
+/// match a regex. Both are empty if the regex has no usable literal text.
+#[derive(Clone, Debug, Default, Eq, PartialEq)]
+struct Prefilter {
+    prefix: Box<[char]>,
+    // Each element holds the characters that are allowed at that position.
+    suffix: Box<[Box<[char]>]>,
+}
+
+impl Prefilter {
+    fn new(regex: &str) -> Self {
+        let tokens = tokenize(regex);
+
+        if tokens.contains(&Token::Alternation) {
+            return Self::default();
+        }
+
+        Self {
+            prefix: literal_prefix(&tokens).into_boxed_slice(),
+            suffix: literal_suffix(&tokens).into_boxed_slice(),
+        }
+    }
+
+    fn bucket_key(&self) -> Option<u8> {
+        self.prefix.first().copied().and_then(ascii_key)
+    }
+
+    fn may_match(&self, plugin_name: &str) -> bool {
+        let mut name_chars = plugin_name.chars();
+        let prefix_matches = self
+            .prefix
+            .iter()
+            .all(|p| name_chars.next().is_some_and(|n| may_be_equal(*p, n)));
+
+        if !prefix_matches {
+            return false;
+        }
+
+        let mut name_chars = plugin_name.chars().rev();
+        self.suffix.iter().rev().all(|allowed| {
+            name_chars
+                .next()
+                .is_some_and(|n| allowed.iter().any(|p| may_be_equal(*p, n)))
+        })
+    }
+}
+
+fn ascii_key(c: char) -> Option<u8> {
+    u8::try_from(c.to_ascii_lowercase())
+        .ok()
+        .filter(u8::is_ascii)
+}
+
+/// Regexes are matched case-insensitively using Unicode case folding, which
+/// can treat some non-ASCII characters as equal to ASCII characters (e.g. the
+/// Kelvin sign and `k`), so only ASCII characters are compared here.
+fn may_be_equal(pattern_char: char, name_char: char) -> bool {
+    !(pattern_char.is_ascii() && name_char.is_ascii())
+        || pattern_char.eq_ignore_ascii_case(&name_char)
+}
+
+#[derive(Clone, Debug, Eq, PartialEq)]
+enum Token {
+    Literal(char),
+    // A character class that only contains literal characters, e.g. [mp].
+    Class(Vec<char>),
+    Quantifier,
+    // An alternation that is not inside a group.
+    Alternation,
+    Other,
+}
+
+fn tokenize(regex: &str) -> Vec<Token> {
+    let mut tokens = Vec::new();
+    let mut depth: usize = 0;
+    let mut chars = regex.chars().peekable();
+
+    while let Some(c) = chars.next() {
+        let token = match c {
+            '\\' => tokenize_escape(&mut chars),
+            '[' => tokenize_class(&mut chars),
+            '(' => {
+                depth = depth.saturating_add(1);
+                Token::Other
+            }
+            ')' => {
+                depth = depth.saturating_sub(1);
+                Token::Other
+            }
+            '|' if depth == 0 => Token::Alternation,
+            '*' | '+' | '?' => Token::Quantifier,
+            '{' => {
+                skip_until(&mut chars, '}');
+                Token::Quantifier
+            }
+            '.' | '^' | '$' | '|' => Token::Other,
+            c => Token::Literal(c),
+        };
+
+        tokens.push(token);
+    }
+
+    tokens
+}
+
+fn tokenize_escape(chars: &mut std::iter::Peekable<std::str::Chars<'_>>) -> Token {
+    let Some(c) = chars.next() else {
+        return Token::Other;
+    };
+
+    if c.is_ascii_punctuation() {
+        return Token::Literal(c);
+    }
+
+    // Skip any characters that are part of the escape sequence.
+    match c {
+        'u' => {
+            if chars.next_if_eq(&'{').is_some() {
+                skip_until(chars, '}');
+            } else {
+                chars.by_ref().take(4).for_each(drop);
+            }
+        }
+        'x' => chars.by_ref().take(2).for_each(drop),
+        'c' => chars.by_ref().take(1).for_each(drop),
+        'p' | 'P' => {
+            if chars.next_if_eq(&'{').is_some() {
+                skip_until(chars, '}');
+            }
+        }
+        'k' => {
+            if chars.next_if_eq(&'<').is_some() {
+                skip_until(chars, '>');
+            }
+        }
+        '1'..='9' => while chars.next_if(char::is_ascii_digit).is_some() {},
+        _ => {}
+    }
+
+    Token::Other
+}
+
+fn tokenize_class(chars: &mut std::iter::Peekable<std::str::Chars<'_>>) -> Token {
+    let mut members = Vec::new();
+    let mut is_literal = chars.next_if_eq(&'^').is_none();
+
+    while let Some(c) = chars.next() {
+        match c {
+            ']' => {
+                return if is_literal && !members.is_empty() {
+                    Token::Class(members)
+                } else {
+                    Token::Other
+                };
+            }
+            '\\' => match chars.next() {
+                Some(e) if e.is_ascii_punctuation() => members.push(e),
+                _ => is_literal = false,
+            },
+            // Ranges aren't expanded.
+            '-' => is_literal = false,
+            c => members.push(c),
+        }
+    }
+
+    Token::Other
+}
+
+fn skip_until(chars: &mut std::iter::Peekable<std::str::Chars<'_>>, end: char) {
+    for c in chars.by_ref() {
+        if c == end {
+            break;
+        }
+    }
+}
+
+fn literal_prefix(tokens: &[Token]) -> Vec<char> {
+    let mut prefix = Vec::new();
+    let mut iter = tokens.iter().peekable();
+
+    while let Some(Token::Literal(c)) = iter.next() {
+        // A quantifier means the preceding literal may not be present.
+        if iter.peek() == Some(&&Token::Quantifier) {
+            break;
+        }
+        prefix.push(*c);
+    }
+
+    prefix
+}
+
+fn literal_suffix(tokens: &[Token]) -> Vec<Box<[char]>> {
+    let mut suffix = Vec::new();
+
+    // Iterating in reverse, a quantifier will be seen before the token that it
+    // applies to, so stops the suffix before it.
+    for token in tokens.iter().rev() {
+        match token {
+            Token::Literal(c) => suffix.push(Box::from([*c])),
+            Token::Class(chars) => suffix.push(chars.clone().into_boxed_slice()),
+            _ => break,
+        }
+    }
+
+    suffix.reverse();
+
+    suffix
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn regex_plugins(names: &[&str]) -> RegexPlugins {
+        names
+            .iter()
+            .map(|n| PluginMetadata::new(n).unwrap())
+            .collect()
+    }
+
+    fn matching_names<'a>(regex_plugins: &'a RegexPlugins, plugin_name: &'a str) -> Vec<&'a str> {
+        regex_plugins
+            .matching(plugin_name)
+            .map(PluginMetadata::name)
+            .collect()
+    }
+
+    mod prefilter {
+        use super::*;
+
+        #[test]
+        fn new_should_find_literal_prefix_and_suffix() {
+            let prefilter = Prefilter::new(r"Foo.*\.es[mp]");
+
+            assert_eq!(&['F', 'o', 'o'], prefilter.prefix.as_ref());
+            assert_eq!(4, prefilter.suffix.len());
+            assert_eq!(&['m', 'p'], prefilter.suffix[3].as_ref());
+        }
+
+        #[test]
+        fn new_should_not_include_quantified_literals() {
+            let prefilter = Prefilter::new(r"Foos?Bar.*\.esp?");
+
+            assert_eq!(&['F', 'o', 'o'], prefilter.prefix.as_ref());
+            assert!(prefilter.suffix.is_empty());
+        }
+
+        #[test]
+        fn new_should_stop_at_groups_and_escape_sequences() {
+            let prefilter = Prefilter::new(r"Foo(Bar)\d\.esp");
+
+            assert_eq!(&['F', 'o', 'o'], prefilter.prefix.as_ref());
+            assert_eq!(4, prefilter.suffix.len());
+
+            let prefilter = Prefilter::new(r".*A");
+            assert!(prefilter.prefix.is_empty());
+            assert!(prefilter.suffix.is_empty());
+        }
+
+        #[test]
+        fn new_should_not_use_classes_that_are_negated_or_contain_ranges() {
+            let prefilter = Prefilter::new(r".*\.[^a]");
+            assert!(prefilter.suffix.is_empty());
+
+            let prefilter = Prefilter::new(r".*\.[a-z]");
+            assert!(prefilter.suffix.is_empty());
+        }
+
+        #[test]
+        fn new_should_have_no_prefix_or_suffix_if_there_is_a_top_level_alternation() {
+            let prefilter = Prefilter::new(r"Foo\.esp|Bar\.esp");
+
+            assert!(prefilter.prefix.is_empty());
+            assert!(prefilter.suffix.is_empty());
+
+            let prefilter = Prefilter::new(r"Foo(Bar|Baz)\.esp");
+
+            assert_eq!(&['F', 'o', 'o'], prefilter.prefix.as_ref());
+            assert_eq!(4, prefilter.suffix.len());
+        }
+
+        #[test]
+        fn may_match_should_compare_ascii_characters_case_insensitively() {
+            let prefilter = Prefilter::new(r"Foo.*\.esp");
+
+            assert!(prefilter.may_match("foo bar.ESP"));
+            assert!(!prefilter.may_match("bar.esp"));
+            assert!(!prefilter.may_match("foo.esm"));
+            assert!(!prefilter.may_match("fo"));
+        }
+
+        #[test]
+        fn may_match_should_not_rule_out_non_ascii_characters() {
+            let prefilter = Prefilter::new(r"kelvin.*\.esp");
+
+            assert!(prefilter.may_match("\u{212A}elvin.esp"));
+        }
+    }
+
+    mod regex_plugins {
+        use super::*;
+
+        #[test]
+        fn matching_should_return_entries_in_the_order_they_were_added() {
+            let regex_plugins = regex_plugins(&[r".+\.esp", r"Foo.*\.esp", r"F.*\.es[mp]"]);
+
+            assert_eq!(
+                vec![r".+\.esp", r"Foo.*\.esp", r"F.*\.es[mp]"],
+                matching_names(&regex_plugins, "Foo Bar.esp")
+            );
+            assert_eq!(
+                vec![r"F.*\.es[mp]"],
+                matching_names(&regex_plugins, "foo.esm")
+            );
+            assert!(matching_names(&regex_plugins, "Bar.esm").is_empty());
+        }
+
+        #[test]
+        fn matching_should_give_the_same_results_as_checking_every_entry() {
+            let regex_plugins = regex_plugins(&[
+                r"Foo.*\.esp",
+                r"(Foo|Bar).*\.esm",
+                r"Bar\.esp|Baz\.esp",
+                r"Blank(?: - Different)?\.es[lmp]",
+                r"[BF]lank.*",
+                r".*\.(esp|esm)",
+                r"Blank\.esp",
+                r"Ba?z\.esp",
+                r"Qux\.esp",
+            ]);
+
+            let plugin_names = [
+                "Foo.esp",
+                "foo bar.esp",
+                "Bar.esm",
+                "Bar.esp",
+                "baz.esp",
+                "bz.esp",
+                "Blank.esp",
+                "Blank - Different.esl",
+                "Flank.esp",
+                "Qux.esm",
+                "",
+                "\u{212A}elvin.esp",
+            ];
+
+            for plugin_name in plugin_names {
+                let expected: Vec<_> = regex_plugins
+                    .iter()
+                    .filter(|p| p.name_matches(plugin_name))
+                    .map(PluginMetadata::name)
+                    .collect();
+
+                assert_eq!(
+                    expected,
+                    matching_names(&regex_plugins, plugin_name),
+                    "{plugin_name}"
+                );
+            }
+        }
+
+        #[test]
+        fn retain_should_rebuild_the_index() {
+            let mut regex_plugins = regex_plugins(&[r"Foo.*\.esp", r"Bar.*\.esp", r"F.*\.esp"]);
+
+            regex_plugins.retain(|p| p.name() != r"Foo.*\.esp");
+
+            assert_eq!(2, regex_plugins.iter().count());
+            assert_eq!(vec![r"F.*\.esp"], matching_names(&regex_plugins, "Foo.esp"));
+            assert_eq!(
+                vec![r"Bar.*\.esp"],
+                matching_names(&regex_plugins, "Bar.esp")
+            );
+        }
+
+        #[test]
+        fn matching_should_cache_matches_for_each_plugin_name() {
+            let regex_plugins = regex_plugins(&[r"Foo.*\.esp", r"F.*\.esp"]);
+
+            assert_eq!(
+                vec![r"Foo.*\.esp", r"F.*\.esp"],
+                matching_names(&regex_plugins, "Foo.esp")
+            );
+            assert_eq!(
+                vec![r"Foo.*\.esp", r"F.*\.esp"],
+                matching_names(&regex_plugins, "Foo.esp")
+            );
+            assert!(matching_names(&regex_plugins, "Bar.esp").is_empty());
+
+            assert_eq!(2, regex_plugins.match_cache.len());
+        }
+
+        #[test]
+        fn push_should_invalidate_cached_matches() {
+            let mut regex_plugins = regex_plugins(&[r"Foo.*\.esp"]);
+
+            assert_eq!(
+                vec![r"Foo.*\.esp"],
+                matching_names(&regex_plugins, "Foo.esp")
+            );
+
+            regex_plugins.push(PluginMetadata::new(r"F.*\.esp").unwrap());
+
+            assert_eq!(0, regex_plugins.match_cache.len());
+            assert_eq!(
+                vec![r"Foo.*\.esp", r"F.*\.esp"],
+                matching_names(&regex_plugins, "Foo.esp")
+            );
+        }
+
+        #[test]
+        fn retain_should_invalidate_cached_matches_if_an_entry_is_removed() {
+            let mut regex_plugins = regex_plugins(&[r"Foo.*\.esp", r"F.*\.esp"]);
+
+            assert_eq!(2, matching_names(&regex_plugins, "Foo.esp").len());
+
+            regex_plugins.retain(|_| true);
+            assert_eq!(1, regex_plugins.match_cache.len());
+
+            regex_plugins.retain(|p| p.name() != r"F.*\.esp");
+            assert_eq!(0, regex_plugins.match_cache.len());
+            assert_eq!(
+                vec![r"Foo.*\.esp"],
+                matching_names(&regex_plugins, "Foo.esp")
+            );
+        }
+
+        #[test]
+        fn clone_from_with_matches_should_copy_cached_matches() {
+            let source = regex_plugins(&[r"Foo.*\.esp", r"F.*\.esp"]);
+            assert_eq!(2, matching_names(&source, "Foo.esp").len());
+
+            let mut regex_plugins = RegexPlugins::default();
+            regex_plugins.clone_from_with_matches(&source);
+
+            assert_eq!(1, regex_plugins.match_cache.len());
+            assert_eq!(
+                vec![r"Foo.*\.esp", r"F.*\.esp"],
+                matching_names(&regex_plugins, "Foo.esp")
+            );
+        }
+
+        #[test]
+        fn clear_should_remove_all_entries() {
+            let mut regex_plugins = regex_plugins(&[r"Foo.*\.esp"]);
+
+            regex_plugins.clear();
+
+            assert!(regex_plugins.is_empty());
+            assert!(matching_names(&regex_plugins, "Foo.esp").is_empty());
+        }
+    }
+}
@@ -0,0 +1,239 @@
+use std::{
+    collections::HashMap,
+    sync::{Arc, OnceLock},
+};
+
+use super::{file::Filename, group::Group, plugin_metadata::PluginMetadata};
+
+/// Indexes a metadata document's plugin entries by the files that they
+/// reference and the groups that they're in, so that finding the entries that
+/// reference a file or are in a group doesn't involve looking at every entry.
+///
+/// Conditions are ignored, so an entry is indexed under a file or group even
+/// if the metadata that references it has a condition. Entries that don't
+/// have a group are indexed under the default group, as that's the group
+/// that they put their plugins in unless they're merged with an entry that
+/// has a group.
+#[derive(Debug, Default)]
+pub(super) struct ReverseIndex {
+    referencing_entries: HashMap<Filename, Vec<Arc<str>>>,
+    group_members: HashMap<Arc<str>, Vec<Arc<str>>>,
+    entry_groups: HashMap<Filename, Arc<str>>,
+}
+
+impl ReverseIndex {
+    fn new<'a>(plugins: impl Iterator<Item = &'a PluginMetadata>) -> Self {
+        let mut index = Self::default();
+        let default_group: Arc<str> = Group::DEFAULT_NAME.into();
+
+        for plugin in plugins {
+            let name: Arc<str> = plugin.name().into();
+
+            let files = plugin
+                .load_after_files()
+                .iter()
+                .chain(plugin.requirements())
+                .chain(plugin.incompatibilities());
+            for file in files {
+                let entries = index
+                    .referencing_entries
+                    .entry(file.name().clone())
+                    .or_default();
+
+                // An entry may reference the same file more than once.
+                if !entries.last().is_some_and(|n| Arc::ptr_eq(n, &name)) {
+                    entries.push(Arc::clone(&name));
+                }
+            }
+
+            let group: Arc<str> = match plugin.group() {
+                Some(group) => {
+                    let group: Arc<str> = group.into();
+                    index
+                        .entry_groups
+                        .insert(Filename::new(plugin.name().to_owned()), Arc::clone(&group));
+                    group
+                }
+                None => Arc::clone(&default_group),
+            };
+
+            index
+                .group_members
+                .entry(group)
+                .or_default()
+                .push(Arc::clone(&name));
+        }
+
+        index
+    }
+
+    /// Get the names of the entries that reference the given file in their
+    /// load after, requirement or incompatibility metadata.
+    pub(super) fn referencing_entries(&self, filename: &str) -> &[Arc<str>] {
+        self.referencing_entries
+            .get(&Filename::new(filename.to_owned()))
+            .map_or(&[], Vec::as_slice)
+    }
+
+    /// Get the names of the entries that are in the given group, including
+    /// entries without a group if it's the default group.
+    pub(super) fn group_members(&self, group_name: &str) -> &[Arc<str>] {
+        self.group_members
+            .get(group_name)
+            .map_or(&[], Vec::as_slice)
+    }
+
+    /// Get the group of the entry with the given name, if it has one. Entries
+    /// without a group don't have one, even though they're indexed under the
+    /// default group.
+    pub(super) fn entry_group(&self, plugin_name: &str) -> Option<&str> {
+        self.entry_groups
+            .get(&Filename::new(plugin_name.to_owned()))
+            .map(AsRef::as_ref)
+    }
+}
+
+/// Holds a document's reverse index, which is built when it's first needed
+/// and must be reset whenever the document's plugin entries change.
+///
+/// Like the regex plugins' match cache, the index isn't copied when it's
+/// cloned, because copies are usually made to be modified, and it's ignored
+/// when comparing documents.
+#[derive(Debug, Default)]
+pub(super) struct LazyReverseIndex(OnceLock<ReverseIndex>);
+
+impl LazyReverseIndex {
+    pub(super) fn get_or_build<'a, I, F>(&self, plugins: F) -> &ReverseIndex
+    where
+        I: Iterator<Item = &'a PluginMetadata>,
+        F: FnOnce() -> I,
+    {
+        self.0.get_or_init(|| ReverseIndex::new(plugins()))
+    }
+
+    pub(super) fn reset(&mut self) {
+        self.0 = OnceLock::new();
+    }
+}
+
+impl Clone for LazyReverseIndex {
+    fn clone(&self) -> Self {
+        Self::default()
+    }
+}
+
+impl PartialEq for LazyReverseIndex {
+    fn eq(&self, _: &Self) -> bool {
+        true
+    }
+}
+
+impl Eq for LazyReverseIndex {}
+
+#[cfg(test)]
+mod tests {
+    use crate::metadata::File;
+
+    use super::*;
+
+    fn plugin(name: &str) -> PluginMetadata {
+        PluginMetadata::new(name).unwrap()
+    }
+
+    #[test]
+    fn referencing_entries_should_include_entries_that_reference_the_file_in_any_list() {
+        let mut a = plugin("A.esp");
+        a.set_load_after_files(vec![File::new("C.esp".into())]);
+        let mut b = plugin("B.esp");
+        b.set_requirements(vec![File::new("c.esp".into())]);
+        let mut d = plugin("D.esp");
+        d.set_incompatibilities(vec![File::new("C.esp".into())]);
+        let e = plugin("E.esp");
+
+        let index = ReverseIndex::new([&a, &b, &d, &e].into_iter());
+
+        let entries: Vec<_> = index
+            .referencing_entries("C.ESP")
+            .iter()
+            .map(AsRef::as_ref)
+            .collect();
+        assert_eq!(["A.esp", "B.esp", "D.esp"], entries.as_slice());
+        assert!(index.referencing_entries("E.esp").is_empty());
+    }
+
+    #[test]
+    fn referencing_entries_should_list_an_entry_once_if_it_references_a_file_more_than_once() {
+        let mut a = plugin("A.esp");
+        a.set_load_after_files(vec![File::new("C.esp".into())]);
+        a.set_requirements(vec![File::new("C.esp".into())]);
+
+        let index = ReverseIndex::new([&a].into_iter());
+
+        assert_eq!(1, index.referencing_entries("C.esp").len());
+    }
+
+    #[test]
+    fn group_members_should_include_entries_that_are_in_the_group() {
+        let mut a = plugin("A.esp");
+        a.set_group("group1".into());
+        let mut b = plugin("B.*\\.esp");
+        b.set_group("group1".into());
+        let mut c = plugin("C.esp");
+        c.set_group("group2".into());
+
+        let index = ReverseIndex::new([&a, &b, &c].into_iter());
+
+        let members: Vec<_> = index
+            .group_members("group1")
+            .iter()
+            .map(AsRef::as_ref)
+            .collect();
+        assert_eq!(["A.esp", "B.*\\.esp"], members.as_slice());
+        assert_eq!(Some("group2"), index.entry_group("c.esp"));
+        assert!(index.entry_group("D.esp").is_none());
+    }
+
+    #[test]
+    fn group_members_should_include_entries_without_a_group_in_the_default_group() {
+        let mut a = plugin("A.esp");
+        a.set_group(Group::DEFAULT_NAME.into());
+        let b = plugin("B.esp");
+        let mut c = plugin("C.esp");
+        c.set_group("group1".into());
+
+        let index = ReverseIndex::new([&a, &b, &c].into_iter());
+
+        let members: Vec<_> = index
+            .group_members(Group::DEFAULT_NAME)
+            .iter()
+            .map(AsRef::as_ref)
+            .collect();
+        assert_eq!(["A.esp", "B.esp"], members.as_slice());
+        assert_eq!(Some(Group::DEFAULT_NAME), index.entry_group("A.esp"));
+        assert!(index.entry_group("B.esp").is_none());
+    }
+
+    #[test]
+    fn reset_should_discard_the_built_index() {
+        let mut a = plugin("A.esp");
+        a.set_group("group1".into());
+
+        let mut lazy_index = LazyReverseIndex::default();
+        assert_eq!(
+            1,
+            lazy_index
+                .get_or_build(|| [&a].into_iter())
+                .group_members("group1")
+                .len()
+        );
+
+        lazy_index.reset();
+
+        assert!(
+            lazy_index
+                .get_or_build(std::iter::empty)
+                .group_members("group1")
+                .is_empty()
+        );
+    }
+}
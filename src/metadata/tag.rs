@@ -1,7 +1,12 @@
+use std::sync::Arc;
+
 use saphyr::{MarkedYaml, Scalar, YamlData};
 
 use super::{
+    binary::{BinaryDecoder, BinaryEncoder, DecodeBinary, DecodeError, EncodeBinary},
+    condition::Condition,
     error::{ExpectedType, ParseMetadataError},
+    interner::{InternStrings, StringInterner},
     yaml::{
         EmitYaml, TryFromYaml, YamlEmitter, YamlObjectType, get_required_string_value,
         parse_condition,
@@ -20,9 +25,9 @@ pub enum TagSuggestion {
 /// Represents a Bash Tag suggestion for a plugin.
 #[derive(Clone, Debug, Default, Eq, PartialEq, Ord, PartialOrd, Hash)]
 pub struct Tag {
-    name: Box<str>,
+    name: Arc<str>,
     suggestion: TagSuggestion,
-    condition: Option<Box<str>>,
+    condition: Option<Condition>,
 }
 
 impl Tag {
@@ -30,7 +35,7 @@ impl Tag {
     #[must_use]
     pub fn new(name: String, suggestion: TagSuggestion) -> Self {
         Self {
-            name: name.into_boxed_str(),
+            name: name.into(),
             suggestion,
             condition: None,
         }
@@ -39,7 +44,7 @@ impl Tag {
     /// Set the condition string.
     #[must_use]
     pub fn with_condition(mut self, condition: String) -> Self {
-        self.condition = Some(condition.into_boxed_str());
+        self.condition = Some(Condition::new(condition));
         self
     }
 
@@ -55,7 +60,11 @@ impl Tag {
 
     /// Get the condition string.
     pub fn condition(&self) -> Option<&str> {
-        self.condition.as_deref()
+        self.condition.as_ref().map(Condition::as_str)
+    }
+
+    pub(crate) fn parsed_condition(&self) -> Option<&Condition> {
+        self.condition.as_ref()
     }
 }
 
@@ -92,7 +101,7 @@ impl TryFromYaml for Tag {
     }
 }
 
-fn name_and_suggestion(value: &str) -> (Box<str>, TagSuggestion) {
+fn name_and_suggestion(value: &str) -> (Arc<str>, TagSuggestion) {
     if let Some(name) = value.strip_prefix("-") {
         (name.into(), TagSuggestion::Removal)
     } else {
@@ -117,7 +126,7 @@ impl EmitYaml for Tag {
             }
 
             emitter.write_map_key("condition");
-            emitter.write_condition(condition);
+            emitter.write_condition(condition.as_str());
 
             emitter.end_map();
         } else if self.is_addition() {
@@ -128,6 +137,38 @@ impl EmitYaml for Tag {
     }
 }
 
+impl EncodeBinary for Tag {
+    fn encode_binary(&self, encoder: &mut BinaryEncoder) {
+        encoder.write_str(&self.name);
+        encoder.write_bool(self.is_addition());
+        encoder.write_condition(self.condition.as_ref());
+    }
+}
+
+impl DecodeBinary for Tag {
+    fn decode_binary(decoder: &mut BinaryDecoder<'_>) -> Result<Self, DecodeError> {
+        let name = decoder.read_shared_str()?;
+        let suggestion = if decoder.read_bool()? {
+            TagSuggestion::Addition
+        } else {
+            TagSuggestion::Removal
+        };
+
+        Ok(Self {
+            name,
+            suggestion,
+            condition: decoder.read_condition()?,
+        })
+    }
+}
+
+impl InternStrings for Tag {
+    fn intern_strings(&mut self, interner: &mut StringInterner) {
+        self.name.intern_strings(interner);
+        self.condition.intern_strings(interner);
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
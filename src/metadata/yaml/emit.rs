@@ -1,4 +1,7 @@
-use std::collections::{HashMap, HashSet};
+use std::{
+    collections::{HashMap, HashSet},
+    sync::Arc,
+};
 
 use crate::metadata::{Message, MessageContent};
 
@@ -485,6 +488,12 @@ impl<T: EmitYaml> EmitYaml for Box<[T]> {
     }
 }
 
+impl<T: EmitYaml> EmitYaml for Arc<[T]> {
+    fn emit_yaml(&self, emitter: &mut YamlEmitter) {
+        self.as_ref().emit_yaml(emitter);
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -2,71 +2,77 @@ use saphyr::{MarkedYaml, YamlData};
 
 use crate::metadata::error::YamlMergeKeyError;
 
+/// Resolve YAML merge keys in place.
+///
+/// Only mappings that contain merge keys are changed, and the rest of the
+/// document is just walked to find them.
 pub(in crate::metadata) fn process_merge_keys(
-    mut yaml: MarkedYaml,
-) -> Result<MarkedYaml, YamlMergeKeyError> {
-    match yaml.data {
-        YamlData::Sequence(a) => {
-            yaml.data = merge_array_elements(a).map(YamlData::Sequence)?;
-            Ok(yaml)
-        }
-        YamlData::Mapping(h) => {
-            yaml.data = merge_mapping_keys(h).map(YamlData::Mapping)?;
-            Ok(yaml)
-        }
-        _ => Ok(yaml),
+    yaml: &mut MarkedYaml,
+) -> Result<(), YamlMergeKeyError> {
+    match &mut yaml.data {
+        YamlData::Sequence(a) => a.iter_mut().try_for_each(process_merge_keys),
+        YamlData::Mapping(h) => merge_mapping_keys(h),
+        _ => Ok(()),
     }
 }
 
-fn merge_array_elements(
-    array: saphyr::AnnotatedSequence<MarkedYaml>,
-) -> Result<saphyr::AnnotatedSequence<MarkedYaml>, YamlMergeKeyError> {
-    array.into_iter().map(process_merge_keys).collect()
-}
-
-fn merge_mapping_keys<'a, 'b>(
-    mapping: saphyr::AnnotatedMapping<'a, MarkedYaml<'b>>,
-) -> Result<saphyr::AnnotatedMapping<'a, MarkedYaml<'b>>, YamlMergeKeyError> {
-    let mut mapping: saphyr::AnnotatedMapping<MarkedYaml> = mapping
-        .into_iter()
-        .map(|(key, value)| {
-            process_merge_keys(key)
-                .and_then(|key| process_merge_keys(value).map(|value| (key, value)))
-        })
-        .collect::<Result<_, _>>()?;
+fn merge_mapping_keys(
+    mapping: &mut saphyr::AnnotatedMapping<MarkedYaml>,
+) -> Result<(), YamlMergeKeyError> {
+    if mapping.keys().any(is_collection) {
+        // Keys can't be changed in place, so rebuild the mapping. Keys are
+        // practically always scalars, so this is very unlikely to happen.
+        *mapping = std::mem::take(mapping)
+            .into_iter()
+            .map(|(mut key, mut value)| {
+                process_merge_keys(&mut key)?;
+                process_merge_keys(&mut value)?;
+                Ok((key, value))
+            })
+            .collect::<Result<_, _>>()?;
+    } else {
+        mapping.values_mut().try_for_each(process_merge_keys)?;
+    }
 
     if let Some(value) = mapping.remove(&MarkedYaml::value_from_str("<<")) {
         merge_into_mapping(mapping, value)
     } else {
-        Ok(mapping)
+        Ok(())
     }
 }
 
-fn merge_into_mapping<'a, 'b>(
-    mapping: saphyr::AnnotatedMapping<'a, MarkedYaml<'b>>,
+fn is_collection(yaml: &MarkedYaml) -> bool {
+    matches!(yaml.data, YamlData::Sequence(_) | YamlData::Mapping(_))
+}
+
+fn merge_into_mapping<'b>(
+    mapping: &mut saphyr::AnnotatedMapping<MarkedYaml<'b>>,
     value: MarkedYaml<'b>,
-) -> Result<saphyr::AnnotatedMapping<'a, MarkedYaml<'b>>, YamlMergeKeyError> {
+) -> Result<(), YamlMergeKeyError> {
     match value.data {
-        YamlData::Sequence(a) => a.into_iter().try_fold(mapping, |acc, e| {
+        YamlData::Sequence(a) => a.into_iter().try_for_each(|e| {
             if let YamlData::Mapping(h) = e.data {
-                Ok(merge_mappings(acc, h))
+                merge_mappings(mapping, h);
+                Ok(())
             } else {
                 Err(YamlMergeKeyError::new(&e))
             }
         }),
-        YamlData::Mapping(h) => Ok(merge_mappings(mapping, h)),
+        YamlData::Mapping(h) => {
+            merge_mappings(mapping, h);
+            Ok(())
+        }
         _ => Err(YamlMergeKeyError::new(&value)),
     }
 }
 
-fn merge_mappings<'a, 'b>(
-    mut mapping1: saphyr::AnnotatedMapping<'a, MarkedYaml<'b>>,
+fn merge_mappings<'b>(
+    mapping1: &mut saphyr::AnnotatedMapping<MarkedYaml<'b>>,
     mapping2: saphyr::AnnotatedMapping<MarkedYaml<'b>>,
-) -> saphyr::AnnotatedMapping<'a, MarkedYaml<'b>> {
+) {
     for (key, value) in mapping2 {
         mapping1.entry(key).or_insert(value);
     }
-    mapping1
 }
 
 #[cfg(test)]
@@ -74,20 +80,45 @@ mod tests {
     use super::*;
 
     mod process_merge_keys {
-        use crate::metadata::parse;
+        use crate::metadata::{parse, yaml::to_unmarked_yaml};
 
         use super::*;
 
+        #[test]
+        fn should_merge_keys_into_nested_mappings_without_overwriting_existing_keys() {
+            let mut yaml = parse(
+                "
+- &anchor1 {key1: value1, key2: value2}
+- nested:
+    <<: *anchor1
+    key2: other-value
+  other: [{<<: [*anchor1], key3: value3}]",
+            );
+
+            process_merge_keys(&mut yaml).unwrap();
+
+            let expected = parse(
+                "
+- {key1: value1, key2: value2}
+- nested:
+    key2: other-value
+    key1: value1
+  other: [{key3: value3, key1: value1, key2: value2}]",
+            );
+
+            assert_eq!(to_unmarked_yaml(&expected), to_unmarked_yaml(&yaml));
+        }
+
         #[test]
         fn should_error_if_merge_key_value_has_a_single_value_that_is_not_a_hash() {
-            let yaml = parse(
+            let mut yaml = parse(
                 "
 - &anchor1 test
 - <<: *anchor1
   value: test-value-2",
             );
 
-            let error_message = process_merge_keys(yaml).unwrap_err().to_string();
+            let error_message = process_merge_keys(&mut yaml).unwrap_err().to_string();
 
             assert_eq!(
                 "invalid YAML merge key value at line 3 column 7: test",
@@ -97,7 +128,7 @@ mod tests {
 
         #[test]
         fn should_error_if_merge_key_value_is_an_array_of_non_hash_values() {
-            let yaml = parse(
+            let mut yaml = parse(
                 "
 - &anchor1 {key: test-key}
 - &anchor2 test
@@ -105,7 +136,7 @@ mod tests {
   value: test-value-2",
             );
 
-            let error_message = process_merge_keys(yaml).unwrap_err().to_string();
+            let error_message = process_merge_keys(&mut yaml).unwrap_err().to_string();
 
             assert_eq!(
                 "invalid YAML merge key value at line 4 column 18: test",
@@ -113,4 +144,120 @@ mod tests {
             );
         }
     }
+
+    mod benchmark {
+        use std::{
+            fmt::Write as _,
+            io::Write as _,
+            time::{Duration, Instant},
+        };
+
+        use crate::metadata::{parse, yaml::to_unmarked_yaml};
+
+        use super::*;
+
+        const PLUGIN_COUNT: usize = 5000;
+        const ITERATIONS: usize = 20;
+
+        /// The implementation that was replaced, which rebuilt every sequence and
+        /// mapping in the document.
+        fn rebuild_merge_keys(mut yaml: MarkedYaml) -> Result<MarkedYaml, YamlMergeKeyError> {
+            match yaml.data {
+                YamlData::Sequence(a) => {
+                    yaml.data = YamlData::Sequence(
+                        a.into_iter()
+                            .map(rebuild_merge_keys)
+                            .collect::<Result<_, _>>()?,
+                    );
+                    Ok(yaml)
+                }
+                YamlData::Mapping(h) => {
+                    let mut mapping: saphyr::AnnotatedMapping<MarkedYaml> = h
+                        .into_iter()
+                        .map(|(key, value)| {
+                            Ok((rebuild_merge_keys(key)?, rebuild_merge_keys(value)?))
+                        })
+                        .collect::<Result<_, YamlMergeKeyError>>()?;
+
+                    if let Some(value) = mapping.remove(&MarkedYaml::value_from_str("<<")) {
+                        merge_into_mapping(&mut mapping, value)?;
+                    }
+
+                    yaml.data = YamlData::Mapping(mapping);
+                    Ok(yaml)
+                }
+                _ => Ok(yaml),
+            }
+        }
+
+        fn masterlist_with_merge_keys() -> String {
+            let mut yaml = "prelude:
+  - &common
+    group: group1
+    after: ['Blank.esm']
+    tag: [Relev]
+plugins:
+"
+            .to_owned();
+
+            for i in 0..PLUGIN_COUNT {
+                write!(
+                    yaml,
+                    "  - name: 'Plugin{i}.esp'
+    <<: *common
+    msg:
+      - type: say
+        content: 'Message {i}'
+        condition: 'file(\"Plugin{i}.esp\")'
+"
+                )
+                .unwrap();
+            }
+
+            yaml
+        }
+
+        fn time(
+            documents: Vec<MarkedYaml>,
+            mut process: impl FnMut(MarkedYaml) -> MarkedYaml,
+        ) -> (Duration, MarkedYaml) {
+            let start = Instant::now();
+            let mut last = None;
+            for document in documents {
+                last = Some(process(document));
+            }
+
+            (start.elapsed(), last.unwrap())
+        }
+
+        #[test]
+        #[ignore = "a benchmark, run it with --release --ignored"]
+        fn process_merge_keys_should_be_faster_than_rebuilding_the_document() {
+            let masterlist = masterlist_with_merge_keys();
+            let document = parse(&masterlist);
+
+            let (in_place, in_place_result) =
+                time(vec![document.clone(); ITERATIONS], |mut yaml| {
+                    process_merge_keys(&mut yaml).unwrap();
+                    yaml
+                });
+            let (rebuilt, rebuilt_result) = time(vec![document; ITERATIONS], |yaml| {
+                rebuild_merge_keys(yaml).unwrap()
+            });
+
+            writeln!(
+                std::io::stderr(),
+                "Resolving merge keys for {PLUGIN_COUNT} plugin entries, average of {ITERATIONS} runs: in place {:?}, rebuilt {:?}",
+                in_place / u32::try_from(ITERATIONS).unwrap(),
+                rebuilt / u32::try_from(ITERATIONS).unwrap()
+            )
+            .unwrap();
+
+            assert_eq!(
+                to_unmarked_yaml(&rebuilt_result),
+                to_unmarked_yaml(&in_place_result)
+            );
+            assert!(in_place <= rebuilt);
+        }
+    }
 }
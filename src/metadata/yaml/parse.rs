@@ -1,9 +1,9 @@
-use std::str::FromStr;
-
-use loot_condition_interpreter::Expression;
 use saphyr::{AnnotatedMapping, MarkedYaml, Marker, Scalar, Yaml, YamlData};
 
-use super::super::error::{ExpectedType, MetadataParsingErrorReason, ParseMetadataError};
+use super::super::{
+    condition::Condition,
+    error::{ExpectedType, MetadataParsingErrorReason, ParseMetadataError},
+};
 
 #[derive(Clone, Copy, Debug, Eq, PartialEq, Ord, PartialOrd, Hash)]
 pub(in crate::metadata) enum YamlObjectType {
@@ -17,6 +17,7 @@ pub(in crate::metadata) enum YamlObjectType {
     Tag,
     MetadataDocument,
     BashTagsElement,
+    JournalEntry,
 }
 
 impl std::fmt::Display for YamlObjectType {
@@ -32,6 +33,7 @@ impl std::fmt::Display for YamlObjectType {
             YamlObjectType::Tag => write!(f, "tag"),
             YamlObjectType::MetadataDocument => write!(f, "metadata document"),
             YamlObjectType::BashTagsElement => write!(f, "bash tags"),
+            YamlObjectType::JournalEntry => write!(f, "userlist journal entry"),
         }
     }
 }
@@ -183,15 +185,16 @@ pub(in crate::metadata) fn parse_condition(
     mapping: &saphyr::AnnotatedMapping<MarkedYaml>,
     key: &'static str,
     yaml_type: YamlObjectType,
-) -> Result<Option<Box<str>>, ParseMetadataError> {
+) -> Result<Option<Condition>, ParseMetadataError> {
     match get_string_value(mapping, key, yaml_type)? {
-        Some((marker, s)) => {
-            let s = s.to_owned();
-            if let Err(e) = Expression::from_str(&s) {
-                return Err(ParseMetadataError::invalid_condition(marker, s, e));
-            }
-            Ok(Some(s.into_boxed_str()))
-        }
+        Some((marker, s)) => match Condition::parse(s.to_owned()) {
+            Ok(c) => Ok(Some(c)),
+            Err(e) => Err(ParseMetadataError::invalid_condition(
+                marker,
+                s.to_owned(),
+                e,
+            )),
+        },
         None => Ok(None),
     }
 }
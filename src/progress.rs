@@ -0,0 +1,204 @@
+use std::sync::{
+    Arc,
+    atomic::{AtomicUsize, Ordering},
+};
+
+type Callback = dyn Fn(ProgressPhase, usize, usize) + Send + Sync;
+
+/// The phases of loading and sorting plugins that progress is reported for.
+#[derive(Clone, Copy, Debug, Eq, PartialEq, Ord, PartialOrd, Hash)]
+#[non_exhaustive]
+pub enum ProgressPhase {
+    /// Checking that the plugin paths given to load are valid. Progress is
+    /// counted in plugins.
+    ValidatingPaths,
+    /// Scanning the game's data paths for archive files. Progress is counted in
+    /// data paths.
+    ReadingArchives,
+    /// Parsing plugins and any archives they load. Progress is counted in
+    /// plugins.
+    ParsingPlugins,
+    /// Gathering the plugin data and metadata needed to sort. Progress is
+    /// counted in plugins.
+    PreparingSortingData,
+    /// Adding edges from masters, requirements and load after metadata.
+    /// Progress is counted in plugins.
+    AddingSpecificEdges,
+    /// Adding edges from group metadata. Progress is counted in groups.
+    AddingGroupEdges,
+    /// Adding edges between plugins that override the same records or load
+    /// the same assets. Progress is counted in plugins.
+    AddingOverlapEdges,
+    /// Adding edges between plugins that are otherwise unordered. Progress is
+    /// counted in pairs of plugins that are adjacent in the current load order.
+    AddingTieBreakEdges,
+}
+
+impl std::fmt::Display for ProgressPhase {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        match self {
+            ProgressPhase::ValidatingPaths => write!(f, "validating paths"),
+            ProgressPhase::ReadingArchives => write!(f, "reading archives"),
+            ProgressPhase::ParsingPlugins => write!(f, "parsing plugins"),
+            ProgressPhase::PreparingSortingData => write!(f, "preparing sorting data"),
+            ProgressPhase::AddingSpecificEdges => write!(f, "adding specific edges"),
+            ProgressPhase::AddingGroupEdges => write!(f, "adding group edges"),
+            ProgressPhase::AddingOverlapEdges => write!(f, "adding overlap edges"),
+            ProgressPhase::AddingTieBreakEdges => write!(f, "adding tie-break edges"),
+        }
+    }
+}
+
+/// Holds an optional progress callback and is used to create trackers for
+/// each phase of an operation.
+#[derive(Clone, Default)]
+pub(crate) struct ProgressReporter(Option<Arc<Callback>>);
+
+impl std::fmt::Debug for ProgressReporter {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_tuple("ProgressReporter")
+            .field(&self.0.as_ref().map(|_| "<callback>"))
+            .finish()
+    }
+}
+
+impl ProgressReporter {
+    pub(crate) fn new(callback: Box<Callback>) -> Self {
+        Self(Some(Arc::from(callback)))
+    }
+
+    /// Start tracking a phase that will take `total` steps, reporting that no
+    /// steps have been done yet.
+    pub(crate) fn start(&self, phase: ProgressPhase, total: usize) -> PhaseProgress {
+        if let Some(callback) = &self.0 {
+            callback(phase, 0, total);
+        }
+
+        PhaseProgress {
+            callback: self.0.as_ref().map(Arc::clone),
+            phase,
+            total,
+            done: AtomicUsize::new(0),
+        }
+    }
+}
+
+/// Tracks progress through one phase of an operation.
+///
+/// Steps may be recorded from multiple threads. To avoid the callback slowing
+/// down the loops that it's reporting on, it's only called when the step count
+/// crosses another percent of the total, and when the last step is recorded.
+pub(crate) struct PhaseProgress {
+    callback: Option<Arc<Callback>>,
+    phase: ProgressPhase,
+    total: usize,
+    done: AtomicUsize,
+}
+
+impl std::fmt::Debug for PhaseProgress {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("PhaseProgress")
+            .field("callback", &self.callback.as_ref().map(|_| "<callback>"))
+            .field("phase", &self.phase)
+            .field("total", &self.total)
+            .field("done", &self.done)
+            .finish()
+    }
+}
+
+impl PhaseProgress {
+    pub(crate) fn step(&self) {
+        let Some(callback) = &self.callback else {
+            return;
+        };
+
+        let done = self.done.fetch_add(1, Ordering::Relaxed).saturating_add(1);
+
+        if done == self.total
+            || percent(done, self.total) != percent(done.saturating_sub(1), self.total)
+        {
+            callback(self.phase, done, self.total);
+        }
+    }
+}
+
+fn percent(done: usize, total: usize) -> usize {
+    done.saturating_mul(100).checked_div(total).unwrap_or(100)
+}
+
+#[cfg(test)]
+mod tests {
+    use std::sync::Mutex;
+
+    use super::*;
+
+    type Calls = Arc<Mutex<Vec<(ProgressPhase, usize, usize)>>>;
+
+    fn recording_reporter() -> (ProgressReporter, Calls) {
+        let calls = Arc::new(Mutex::new(Vec::new()));
+        let calls_clone = Arc::clone(&calls);
+        let reporter = ProgressReporter::new(Box::new(move |phase, done, total| {
+            calls_clone.lock().unwrap().push((phase, done, total));
+        }));
+
+        (reporter, calls)
+    }
+
+    #[test]
+    fn start_should_report_zero_steps_done() {
+        let (reporter, calls) = recording_reporter();
+
+        reporter.start(ProgressPhase::ParsingPlugins, 5);
+
+        assert_eq!(
+            vec![(ProgressPhase::ParsingPlugins, 0, 5)],
+            *calls.lock().unwrap()
+        );
+    }
+
+    #[test]
+    fn step_should_report_every_step_if_there_are_fewer_than_one_hundred() {
+        let (reporter, calls) = recording_reporter();
+
+        let progress = reporter.start(ProgressPhase::AddingOverlapEdges, 3);
+        progress.step();
+        progress.step();
+        progress.step();
+
+        assert_eq!(
+            vec![
+                (ProgressPhase::AddingOverlapEdges, 0, 3),
+                (ProgressPhase::AddingOverlapEdges, 1, 3),
+                (ProgressPhase::AddingOverlapEdges, 2, 3),
+                (ProgressPhase::AddingOverlapEdges, 3, 3),
+            ],
+            *calls.lock().unwrap()
+        );
+    }
+
+    #[test]
+    fn step_should_report_at_most_once_per_percent() {
+        let (reporter, calls) = recording_reporter();
+
+        let total: usize = 1000;
+        let progress = reporter.start(ProgressPhase::AddingTieBreakEdges, total);
+        for _ in 0..total {
+            progress.step();
+        }
+
+        let calls = calls.lock().unwrap();
+        assert_eq!(101, calls.len());
+        assert_eq!((ProgressPhase::AddingTieBreakEdges, 10, 1000), calls[1]);
+        assert_eq!((ProgressPhase::AddingTieBreakEdges, 1000, 1000), calls[100]);
+    }
+
+    #[test]
+    fn step_should_do_nothing_if_there_is_no_callback() {
+        let reporter = ProgressReporter::default();
+
+        let progress = reporter.start(ProgressPhase::ParsingPlugins, 1);
+        progress.step();
+
+        assert_eq!(0, progress.done.load(Ordering::Relaxed));
+    }
+}
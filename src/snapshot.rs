@@ -0,0 +1,89 @@
+use std::{
+    collections::{HashMap, HashSet},
+    sync::Arc,
+};
+
+use crate::{
+    GameType, Plugin,
+    database::Database,
+    metadata::{Filename, plugin_metadata::trim_dot_ghost},
+};
+
+/// An immutable view of a game's loaded plugins, load order and metadata, as
+/// they were when the snapshot was taken.
+///
+/// Snapshots are cheap to clone and can be shared between and queried from any
+/// number of threads without locking, while the [`Game`](crate::Game) that
+/// they were taken from continues to be modified. Later changes to the game
+/// are not reflected in existing snapshots.
+///
+/// Loaded plugin data and metadata are shared with the game and any other
+/// snapshots, so taking a snapshot doesn't copy them. The snapshot's database
+/// has its own condition cache, which starts empty.
+#[derive(Clone, Debug)]
+pub struct GameSnapshot(Arc<SnapshotData>);
+
+#[derive(Debug)]
+struct SnapshotData {
+    game_type: GameType,
+    plugins: Arc<HashMap<Filename, Arc<Plugin>>>,
+    load_order: Vec<String>,
+    active_plugins: HashSet<Filename>,
+    database: Database,
+}
+
+impl GameSnapshot {
+    pub(crate) fn new(
+        game_type: GameType,
+        plugins: Arc<HashMap<Filename, Arc<Plugin>>>,
+        load_order: Vec<String>,
+        active_plugins: HashSet<Filename>,
+        database: Database,
+    ) -> Self {
+        Self(Arc::new(SnapshotData {
+            game_type,
+            plugins,
+            load_order,
+            active_plugins,
+            database,
+        }))
+    }
+
+    /// Get the type of the game that this snapshot was taken from.
+    pub fn game_type(&self) -> GameType {
+        self.0.game_type
+    }
+
+    /// Get the metadata that was loaded when this snapshot was taken.
+    ///
+    /// Conditions are evaluated against the load order and loaded plugins
+    /// captured by this snapshot.
+    pub fn database(&self) -> &Database {
+        &self.0.database
+    }
+
+    /// Get data for a plugin that was loaded when this snapshot was taken.
+    pub fn plugin(&self, plugin_name: &str) -> Option<Arc<Plugin>> {
+        self.0
+            .plugins
+            .get(&Filename::new(trim_dot_ghost(plugin_name).to_owned()))
+            .cloned()
+    }
+
+    /// Get data for all plugins that were loaded when this snapshot was taken.
+    pub fn loaded_plugins(&self) -> Vec<Arc<Plugin>> {
+        self.0.plugins.values().cloned().collect()
+    }
+
+    /// Check if the given plugin was active when this snapshot was taken.
+    pub fn is_plugin_active(&self, plugin_name: &str) -> bool {
+        self.0
+            .active_plugins
+            .contains(&Filename::new(plugin_name.to_owned()))
+    }
+
+    /// Get the load order as it was when this snapshot was taken.
+    pub fn load_order(&self) -> Vec<&str> {
+        self.0.load_order.iter().map(String::as_str).collect()
+    }
+}
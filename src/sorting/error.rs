@@ -232,6 +232,7 @@ pub(crate) enum SortingError {
     CycleInvolving(String),
     PluginDataError(PluginDataError),
     PathfindingError(PathfindingError),
+    Cancelled,
 }
 
 impl Display for SortingError {
@@ -243,6 +244,7 @@ impl Display for SortingError {
             Self::CycleInvolving(n) => write!(f, "found a cycle involving \"{n}\""),
             Self::PluginDataError(_) => write!(f, "failed to read plugin data"),
             Self::PathfindingError(_) => write!(f, "failed to find a path in the plugins graph"),
+            Self::Cancelled => write!(f, "sorting was cancelled"),
         }
     }
 }
@@ -253,7 +255,7 @@ impl std::error::Error for SortingError {
             Self::ValidationError(e) => Some(e),
             Self::UndefinedGroup(e) => Some(e),
             Self::CycleFound(e) => Some(e),
-            Self::CycleInvolving(_) => None,
+            Self::CycleInvolving(_) | Self::Cancelled => None,
             Self::PluginDataError(e) => Some(e),
             Self::PathfindingError(e) => Some(e),
         }
@@ -8,10 +8,11 @@ use petgraph::{
 use rustc_hash::{FxHashMap as HashMap, FxHashSet as HashSet};
 
 use crate::{
-    EdgeType, LogLevel, Plugin,
+    CancellationToken, EdgeType, LogLevel, Plugin,
     logging::{self, is_log_enabled},
     metadata::{File, Group, PluginMetadata},
     plugin::error::PluginDataError,
+    progress::{ProgressPhase, ProgressReporter},
     sorting::{
         error::{CyclicInteractionError, PathfindingError, SortingError, UndefinedGroupError},
         groups::{get_default_group_node, sorted_group_nodes},
@@ -153,6 +154,7 @@ type InnerPluginsGraph<'a, T> = Graph<Rc<PluginSortingData<'a, T>>, EdgeType>;
 struct PluginsGraph<'a, T: SortingPlugin> {
     inner: InnerPluginsGraph<'a, T>,
     paths_cache: HashMap<NodeIndex, HashSet<NodeIndex>>,
+    progress: ProgressReporter,
 }
 
 impl<'a, T: SortingPlugin> PluginsGraph<'a, T> {
@@ -160,6 +162,13 @@ impl<'a, T: SortingPlugin> PluginsGraph<'a, T> {
         PluginsGraph::default()
     }
 
+    fn with_progress(progress: ProgressReporter) -> Self {
+        Self {
+            progress,
+            ..Default::default()
+        }
+    }
+
     fn add_node(&mut self, plugin: PluginSortingData<'a, T>) -> NodeIndex {
         self.inner.add_node(Rc::new(plugin))
     }
@@ -188,8 +197,14 @@ impl<'a, T: SortingPlugin> PluginsGraph<'a, T> {
     fn add_specific_edges(&mut self) -> Result<(), SortingError> {
         logging::trace!("Adding edges based on plugin data and non-group metadata...");
 
+        let progress = self
+            .progress
+            .start(ProgressPhase::AddingSpecificEdges, self.inner.node_count());
+
         let mut node_index_iter = self.node_indices();
         while let Some(node_index) = node_index_iter.next() {
+            progress.step();
+
             let plugin = Rc::clone(&self[node_index]);
 
             // This loop should have no effect now that master-flagged and
@@ -312,13 +327,22 @@ impl<'a, T: SortingPlugin> PluginsGraph<'a, T> {
         // Keep a record of which vertices have already been fully explored to avoid
         // adding edges from their plugins more than once.
         let mut finished_nodes = HashSet::default();
+
+        let group_nodes = sorted_group_nodes(groups_graph);
+
+        // One step per DFS, including the final DFS from the default group.
+        let progress = self.progress.start(
+            ProgressPhase::AddingGroupEdges,
+            group_nodes.len().saturating_add(1),
+        );
+
         // Now loop over the vertices in the groups graph.
         // The vertex sort order prioritises resolving potential cycles in
         // favour of earlier-loading groups. It does not guarantee that the
         // longest paths will be walked first, because a root vertex may be in
         // more than one path and the vertex sort order here does not influence
         // which path the DFS takes.
-        for group_node in sorted_group_nodes(groups_graph) {
+        for group_node in group_nodes {
             // Run a DFS from each vertex in the group graph, adding edges except from
             // plugins in the default group. This could be run only on the root
             // vertices, except that the DFS only visits each vertex once, so a branch
@@ -339,6 +363,8 @@ impl<'a, T: SortingPlugin> PluginsGraph<'a, T> {
                 group_node,
                 &mut visitor,
             );
+
+            progress.step();
         }
 
         // Now do one last DFS starting from the default group and not ignoring its
@@ -358,14 +384,22 @@ impl<'a, T: SortingPlugin> PluginsGraph<'a, T> {
             &mut visitor,
         );
 
+        progress.step();
+
         Ok(())
     }
 
     fn add_overlap_edges(&mut self) -> Result<(), SortingError> {
         logging::trace!("Adding edges for overlapping plugins...");
 
+        let progress = self
+            .progress
+            .start(ProgressPhase::AddingOverlapEdges, self.inner.node_count());
+
         let mut node_index_iter = self.node_indices();
         while let Some(node_index) = node_index_iter.next() {
+            progress.step();
+
             let plugin = Rc::clone(&self[node_index]);
             let plugin_asset_count = plugin.asset_count();
 
@@ -510,7 +544,14 @@ impl<'a, T: SortingPlugin> PluginsGraph<'a, T> {
         let mut nodes: Vec<_> = self.node_indices().collect();
         nodes.sort_by_key(|a| self[*a].load_order_index);
 
+        let progress = self.progress.start(
+            ProgressPhase::AddingTieBreakEdges,
+            nodes.len().saturating_sub(1),
+        );
+
         for window in nodes.windows(2) {
+            progress.step();
+
             let [current, next] = *window else {
                 // LIMITATION: This should be impossible, the windows are of fixed
                 // size. The array_windows function would solve this, but it's
@@ -767,6 +808,7 @@ impl<T: SortingPlugin> std::default::Default for PluginsGraph<'_, T> {
         Self {
             inner: Graph::default(),
             paths_cache: HashMap::default(),
+            progress: ProgressReporter::default(),
         }
     }
 }
@@ -783,11 +825,15 @@ pub(crate) fn sort_plugins<T: SortingPlugin>(
     mut plugins_sorting_data: Vec<PluginSortingData<T>>,
     groups_graph: &GroupsGraph,
     early_loading_plugins: &[String],
+    cancellation: &CancellationToken,
+    progress: &ProgressReporter,
 ) -> Result<Vec<String>, SortingError> {
     if plugins_sorting_data.is_empty() {
         return Ok(Vec::new());
     }
 
+    cancellation.err_if_cancelled(SortingError::Cancelled)?;
+
     validate_plugin_groups(&plugins_sorting_data, groups_graph)?;
 
     // Sort the plugins according to the lexicographical order of their names.
@@ -823,14 +869,29 @@ pub(crate) fn sort_plugins<T: SortingPlugin>(
         early_loading_plugins,
     )?;
 
-    let mut masters_load_order =
-        sort_plugins_partition(masters, groups_graph, early_loading_plugins)?;
+    let mut masters_load_order = sort_plugins_partition(
+        masters,
+        groups_graph,
+        early_loading_plugins,
+        cancellation,
+        progress,
+    )?;
 
-    let blueprint_masters_load_order =
-        sort_plugins_partition(blueprint_masters, groups_graph, early_loading_plugins)?;
+    let blueprint_masters_load_order = sort_plugins_partition(
+        blueprint_masters,
+        groups_graph,
+        early_loading_plugins,
+        cancellation,
+        progress,
+    )?;
 
-    let non_masters_load_order =
-        sort_plugins_partition(non_masters, groups_graph, early_loading_plugins)?;
+    let non_masters_load_order = sort_plugins_partition(
+        non_masters,
+        groups_graph,
+        early_loading_plugins,
+        cancellation,
+        progress,
+    )?;
 
     masters_load_order.extend(non_masters_load_order);
     masters_load_order.extend(blueprint_masters_load_order);
@@ -842,8 +903,18 @@ fn sort_plugins_partition<T: SortingPlugin>(
     plugins_sorting_data: Vec<PluginSortingData<T>>,
     groups_graph: &GroupsGraph,
     early_loading_plugins: &[String],
+    cancellation: &CancellationToken,
+    progress: &ProgressReporter,
 ) -> Result<Vec<String>, SortingError> {
-    let mut graph = PluginsGraph::new();
+    if plugins_sorting_data.is_empty() {
+        return Ok(Vec::new());
+    }
+
+    // Cancellation is checked between each phase of sorting, as the phases
+    // that add edges can each take a significant amount of time.
+    cancellation.err_if_cancelled(SortingError::Cancelled)?;
+
+    let mut graph = PluginsGraph::with_progress(progress.clone());
 
     for plugin in plugins_sorting_data {
         graph.add_node(plugin);
@@ -857,10 +928,16 @@ fn sort_plugins_partition<T: SortingPlugin>(
     // relatively slow, so checking now provides quicker feedback if there is an
     // issue.
     graph.check_for_cycles()?;
+    cancellation.err_if_cancelled(SortingError::Cancelled)?;
 
     graph.add_group_edges(groups_graph)?;
+    cancellation.err_if_cancelled(SortingError::Cancelled)?;
+
     graph.add_overlap_edges()?;
+    cancellation.err_if_cancelled(SortingError::Cancelled)?;
+
     graph.add_tie_break_edges()?;
+    cancellation.err_if_cancelled(SortingError::Cancelled)?;
 
     // Check for cycles again, just in case there's a bug that lets some occur.
     // The check doesn't take a significant amount of time.
@@ -3255,6 +3332,8 @@ mod tests {
                 ],
                 &fixture.groups_graph,
                 &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
             )
             .unwrap();
 
@@ -3267,12 +3346,38 @@ mod tests {
                 ],
                 &fixture.groups_graph,
                 &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
             )
             .unwrap();
 
             assert_eq!(expected, sorted.as_slice());
         }
 
+        #[test]
+        fn should_error_if_the_cancellation_token_has_been_cancelled() {
+            let fixture = Fixture::with_plugins(&[PLUGIN_A, PLUGIN_B]);
+
+            let data = vec![
+                fixture.sorting_data(PLUGIN_A),
+                fixture.sorting_data(PLUGIN_B),
+            ];
+
+            let cancellation = CancellationToken::new();
+            cancellation.cancel();
+
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &cancellation,
+                &ProgressReporter::default(),
+            ) {
+                Err(SortingError::Cancelled) => {}
+                _ => panic!("Expected sorting to be cancelled"),
+            }
+        }
+
         #[test]
         fn should_use_group_metadata_when_deciding_relative_plugin_positions() {
             let fixture = Fixture::with_plugins(&[PLUGIN_B, PLUGIN_A]);
@@ -3284,7 +3389,14 @@ mod tests {
 
             let expected = &[PLUGIN_A, PLUGIN_B];
 
-            let sorted = sort_plugins(data, &fixture.groups_graph, &[]).unwrap();
+            let sorted = sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            )
+            .unwrap();
 
             assert_eq!(expected, sorted.as_slice());
         }
@@ -3300,7 +3412,14 @@ mod tests {
 
             let expected = &[PLUGIN_B, PLUGIN_A];
 
-            let sorted = sort_plugins(data, &fixture.groups_graph, &[]).unwrap();
+            let sorted = sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            )
+            .unwrap();
 
             assert_eq!(expected, sorted.as_slice());
         }
@@ -3316,7 +3435,14 @@ mod tests {
 
             let expected = &[PLUGIN_B, PLUGIN_A];
 
-            let sorted = sort_plugins(data, &fixture.groups_graph, &[]).unwrap();
+            let sorted = sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            )
+            .unwrap();
 
             assert_eq!(expected, sorted.as_slice());
         }
@@ -3332,7 +3458,14 @@ mod tests {
 
             let expected = &[PLUGIN_A, PLUGIN_B];
 
-            let sorted = sort_plugins(data, &fixture.groups_graph, &[PLUGIN_A.into()]).unwrap();
+            let sorted = sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[PLUGIN_A.into()],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            )
+            .unwrap();
 
             assert_eq!(expected, sorted.as_slice());
         }
@@ -3343,7 +3476,16 @@ mod tests {
 
             let data = vec![fixture.group_sorting_data(PLUGIN_A, "missing")];
 
-            assert!(sort_plugins(data, &fixture.groups_graph, &[]).is_err());
+            assert!(
+                sort_plugins(
+                    data,
+                    &fixture.groups_graph,
+                    &[],
+                    &CancellationToken::new(),
+                    &ProgressReporter::default()
+                )
+                .is_err()
+            );
         }
 
         #[test]
@@ -3358,7 +3500,13 @@ mod tests {
                 fixture.sorting_data(PLUGIN_B),
             ];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::CycleFound(e)) => {
                     assert_eq!(
                         &[
@@ -3385,7 +3533,13 @@ mod tests {
                 fixture.sorting_data(PLUGIN_B),
             ];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3410,7 +3564,13 @@ mod tests {
 
             let data = vec![a, fixture.sorting_data(PLUGIN_B)];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3436,7 +3596,13 @@ mod tests {
 
             let data = vec![a, fixture.sorting_data(PLUGIN_B)];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3462,7 +3628,13 @@ mod tests {
 
             let data = vec![a, fixture.sorting_data(PLUGIN_B)];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3488,7 +3660,13 @@ mod tests {
 
             let data = vec![a, fixture.sorting_data(PLUGIN_B)];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3514,7 +3692,13 @@ mod tests {
                 fixture.sorting_data(PLUGIN_B),
             ];
 
-            match sort_plugins(data, &fixture.groups_graph, &[PLUGIN_B.into()]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[PLUGIN_B.into()],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3547,7 +3731,14 @@ mod tests {
 
             let expected = &[PLUGIN_B, PLUGIN_A];
 
-            let sorted = sort_plugins(data, &fixture.groups_graph, &[]).unwrap();
+            let sorted = sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            )
+            .unwrap();
 
             assert_eq!(expected, sorted.as_slice());
         }
@@ -3569,7 +3760,14 @@ mod tests {
 
             let expected = &[PLUGIN_B, PLUGIN_A];
 
-            let sorted = sort_plugins(data, &fixture.groups_graph, &[]).unwrap();
+            let sorted = sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            )
+            .unwrap();
 
             assert_eq!(expected, sorted.as_slice());
         }
@@ -3589,7 +3787,13 @@ mod tests {
 
             let data = vec![a, fixture.sorting_data(PLUGIN_B)];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3619,7 +3823,13 @@ mod tests {
 
             let data = vec![a, fixture.sorting_data(PLUGIN_B)];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3650,7 +3860,13 @@ mod tests {
 
             let data = vec![a, fixture.sorting_data(PLUGIN_B)];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3679,7 +3895,13 @@ mod tests {
 
             let data = vec![a, fixture.sorting_data(PLUGIN_B)];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3710,7 +3932,13 @@ mod tests {
 
             let data = vec![a, fixture.sorting_data(PLUGIN_B)];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3740,7 +3968,13 @@ mod tests {
 
             let data = vec![a, fixture.sorting_data(PLUGIN_B)];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3771,7 +4005,13 @@ mod tests {
 
             let data = vec![a, fixture.sorting_data(PLUGIN_B)];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3800,7 +4040,13 @@ mod tests {
 
             let data = vec![a, fixture.sorting_data(PLUGIN_B)];
 
-            match sort_plugins(data, &fixture.groups_graph, &[]) {
+            match sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            ) {
                 Err(SortingError::ValidationError(PluginGraphValidationError::CycleFound(e))) => {
                     assert_eq!(
                         &[
@@ -3833,7 +4079,14 @@ mod tests {
 
             let expected = &[PLUGIN_A, PLUGIN_B];
 
-            let sorted = sort_plugins(data, &fixture.groups_graph, &[PLUGIN_B.into()]).unwrap();
+            let sorted = sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[PLUGIN_B.into()],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            )
+            .unwrap();
 
             assert_eq!(expected, sorted.as_slice());
         }
@@ -3853,7 +4106,14 @@ mod tests {
 
             let expected = &[PLUGIN_A, PLUGIN_B];
 
-            let sorted = sort_plugins(data, &fixture.groups_graph, &[PLUGIN_B.into()]).unwrap();
+            let sorted = sort_plugins(
+                data,
+                &fixture.groups_graph,
+                &[PLUGIN_B.into()],
+                &CancellationToken::new(),
+                &ProgressReporter::default(),
+            )
+            .unwrap();
 
             assert_eq!(expected, sorted.as_slice());
         }